@@ -74,11 +74,11 @@ void EraseValues( map<KeyT, ValueT>& container, ValueT value )
 {
     auto begin = container.begin();
     auto end = container.end();
-    for( map<KeyT, ValueT>::iterator iter = container.begin();
+    for( typename map<KeyT, ValueT>::iterator iter = container.begin();
          iter != container.end(); )
     {
         // erase will invalidate iter so this is needed
-        map<KeyT, ValueT>::iterator nextIter = iter;
+        typename map<KeyT, ValueT>::iterator nextIter = iter;
         ++nextIter;
         if( ( *iter ).second == value )
             container.erase( iter );
@@ -104,11 +104,11 @@ void EraseOneValue( map<KeyT, ValueT>& container, ValueT value )
 {
     auto begin = container.begin();
     auto end = container.end();
-    for( map<KeyT, ValueT>::iterator iter = container.begin();
+    for( typename map<KeyT, ValueT>::iterator iter = container.begin();
          iter != container.end(); )
     {
         // erase will invalidate iter so this is needed
-        map<KeyT, ValueT>::iterator nextIter = iter;
+        typename map<KeyT, ValueT>::iterator nextIter = iter;
         ++nextIter;
         if( ( *iter ).second == value )
         {
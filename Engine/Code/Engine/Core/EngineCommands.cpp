@@ -15,6 +15,8 @@
 #include "Engine/Net/NetConnection.hpp"
 #include "Engine/Net/NetMessage.hpp"
 #include "Engine/Net/EngineNetMessages.hpp"
+#include "Engine/Net/NetPool.hpp"
+#include "Engine/Net/HeadlessNetDriver.hpp"
 #include <fstream>
 #include "Engine/Core/RuntimeVars.hpp"
 #include "Engine/Core/WindowsCommon.hpp"
@@ -325,7 +327,7 @@ void EngineCommands::RegisterAllCommands()
             return;
 
         NetAddress addr = NetAddress( address );
-        NetSession::GetDefault()->AddConnection( (uint8) connectionIdx, addr );
+        NetSession::GetDefault()->AddConnection( (ConnectionIdx) connectionIdx, addr );
     } );
 
     commandSys->AddCommand( "add_connection_self", []( string& str )
@@ -335,7 +337,7 @@ void EngineCommands::RegisterAllCommands()
         if( !parser.GetNext( connectionIdx ) )
             return;
 
-        NetSession::GetDefault()->AddConnectionSelf( (uint8) connectionIdx );
+        NetSession::GetDefault()->AddConnectionSelf( (ConnectionIdx) connectionIdx );
     } );
 
     commandSys->AddCommand( "send_ping", []( string& str )
@@ -348,7 +350,7 @@ void EngineCommands::RegisterAllCommands()
         parser.GetNext( txt );
 
         NetMessage* msg = Compose_Ping( txt );
-        NetSession::GetDefault()->SendToConnection( (uint8) connectionIdx, msg );
+        NetSession::GetDefault()->SendToConnection( (ConnectionIdx) connectionIdx, msg );
     } );
 
     commandSys->AddCommand( "send_add", []( string& str )
@@ -364,7 +366,26 @@ void EngineCommands::RegisterAllCommands()
 
 
         NetMessage* msg = Compose_Add( a, b );
-        NetSession::GetDefault()->SendToConnection( (uint8) connectionIdx, msg );
+        NetSession::GetDefault()->SendToConnection( (ConnectionIdx) connectionIdx, msg );
+    } );
+
+    commandSys->AddCommand( "send_large", []( string& str )
+    {
+        // send_large <idx> <bytes>    reliable, fragmented past MESSAGE_MTU
+        CommandParameterParser parser( str );
+        int connectionIdx;
+        int byteCount;
+        if( !parser.GetNext( connectionIdx )
+            || !parser.GetNext( byteCount )
+            || byteCount < 0
+            || (size_t) byteCount + sizeof( uint ) > FRAGMENT_MAX_MESSAGE_SIZE )
+        {
+            LOG_INVALID_PARAMETERS( "send_large" );
+            return;
+        }
+
+        NetMessage* msg = Compose_LargeTest( (size_t) byteCount );
+        NetSession::GetDefault()->SendToConnection( (ConnectionIdx) connectionIdx, msg );
     } );
 
     commandSys->AddCommand( "net_sim_lag", []( string& str )
@@ -397,6 +418,120 @@ void EngineCommands::RegisterAllCommands()
 
     } );
 
+    commandSys->AddCommand( "net_link", []( string& str )
+    {
+        // net_link                                     show every link
+        // net_link <idx|all> <send|recv|both> <param> <value>
+        //     latency, jitter and reorder_delay in ms, bandwidth in bytes/s
+        CommandParameterParser parser( str );
+        NetSession* session = NetSession::GetDefault();
+        string target;
+        if( !parser.GetNext( target ) )
+        {
+            LOG_INFO_TAG( "Net", "%s", session->GetLinkConditionerString().c_str() );
+            return;
+        }
+
+        int connectionIdx = INVALID_CONNECTION_INDEX;
+        string direction;
+        string name;
+        string value;
+        if( ( target != "all" && SetFromString( target, connectionIdx ) != PARSE_SUCCESS )
+            || !parser.GetNext( direction )
+            || !parser.GetNext( name )
+            || !parser.GetNext( value )
+            || !session->SetLinkParameter(
+                (ConnectionIdx) connectionIdx, direction, name, value ) )
+        {
+            LOG_INVALID_PARAMETERS( "net_link" );
+            return;
+        }
+    } );
+
+    commandSys->AddCommand( "net_capture", []( string& str )
+    {
+        // net_capture <path>    records every received packet
+        // net_capture stop
+        CommandParameterParser parser( str );
+        NetSession* session = NetSession::GetDefault();
+        string option;
+        if( !parser.GetNext( option ) )
+        {
+            LOG_INFO_TAG( "Net", "%s", session->GetCaptureStatusString().c_str() );
+            return;
+        }
+
+        if( option == "stop" )
+            session->StopCapture();
+        else if( session->StartCapture( option ) )
+            LOG_INFO_TAG( "Net", "Capturing to %s", option.c_str() );
+    } );
+
+    commandSys->AddCommand( "net_replay", []( string& str )
+    {
+        // net_replay <path> [speed]    1 for captured pace, 0 for all at once
+        // net_replay stop
+        CommandParameterParser parser( str );
+        NetSession* session = NetSession::GetDefault();
+        string option;
+        if( !parser.GetNext( option ) )
+        {
+            LOG_INFO_TAG( "Net", "%s", session->GetCaptureStatusString().c_str() );
+            return;
+        }
+
+        if( option == "stop" )
+        {
+            session->StopReplay();
+            return;
+        }
+
+        float speed = 1.f;
+        parser.GetNext( speed );
+        if( session->StartReplay( option, speed ) )
+            LOG_INFO_TAG( "Net", "%s", session->GetCaptureStatusString().c_str() );
+    } );
+
+    commandSys->AddCommand( "net_stats", []( string& str )
+    {
+        // net_stats                            per message and per connection report
+        // net_stats reset
+        // net_stats dump <path>                .csv or .json
+        // net_stats dump_every <seconds> <path> appends, 0 seconds stops
+        CommandParameterParser parser( str );
+        NetSession* session = NetSession::GetDefault();
+        string action;
+        if( !parser.GetNext( action ) )
+        {
+            LOG_INFO_TAG( "Net", "%s", session->GetStatsReport().c_str() );
+            return;
+        }
+
+        if( action == "reset" )
+        {
+            session->ResetStats();
+            return;
+        }
+
+        string path;
+        if( action == "dump" && parser.GetNext( path ) )
+        {
+            if( session->WriteStatsToFile( path ) )
+                LOG_INFO_TAG( "Net", "Net stats written to %s", path.c_str() );
+            return;
+        }
+
+        float interval;
+        if( action == "dump_every" && parser.GetNext( interval ) )
+        {
+            parser.GetNext( path );
+            session->SetStatsDump( path, interval );
+            return;
+        }
+
+        LOG_INVALID_PARAMETERS( "net_stats" );
+    } );
+
     commandSys->AddCommand( "net_set_session_send_rate", []( string& str )
     {
         CommandParameterParser parser( str );
@@ -422,8 +557,78 @@ void EngineCommands::RegisterAllCommands()
             return;
         }
 
-        NetSession::GetDefault()->SetConnectionSendRate( (uint8) connectionIdx, Hz );
+        NetSession::GetDefault()->SetConnectionSendRate( (ConnectionIdx) connectionIdx, Hz );
+
+    } );
+
+    commandSys->AddCommand( "net_set_session_bandwidth_cap", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        float bytesPerSecond;
+        if( !parser.GetNext( bytesPerSecond ) )
+        {
+            LOG_INVALID_PARAMETERS( "net_set_session_bandwidth_cap" );
+            return;
+        }
+
+        NetSession::GetDefault()->SetSessionBandwidthCap( bytesPerSecond );
+
+    } );
+
+    commandSys->AddCommand( "net_set_connection_bandwidth_cap", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        int connectionIdx;
+        float bytesPerSecond;
+        if( !parser.GetNext( connectionIdx ) || !parser.GetNext( bytesPerSecond ) )
+        {
+            LOG_INVALID_PARAMETERS( "net_set_connection_bandwidth_cap" );
+            return;
+        }
+
+        NetSession::GetDefault()->SetConnectionBandwidthCap(
+            (ConnectionIdx) connectionIdx, bytesPerSecond );
+
+    } );
+
+    commandSys->AddCommand( "net_congestion", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetSession* session = NetSession::GetDefault();
+        if( option == "on" )
+            session->SetCongestionControlEnabled( true );
+        else if( option == "off" )
+            session->SetCongestionControlEnabled( false );
+        else if( !option.empty() )
+        {
+            LOG_INVALID_PARAMETERS( "net_congestion" );
+            return;
+        }
+        LOG_INFO_TAG( "Net", "Congestion control %s",
+                      session->m_isCongestionControlEnabled ? "on" : "off" );
+    } );
 
+    commandSys->AddCommand( "net_thread", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetSession* session = NetSession::GetDefault();
+        if( option == "on" )
+            session->StartNetThread();
+        else if( option == "off" )
+            session->StopNetThread();
+        else if( !option.empty() )
+        {
+            LOG_INVALID_PARAMETERS( "net_thread" );
+            return;
+        }
+        LOG_INFO_TAG( "Net", "Net thread %s",
+                      session->IsNetThreadRunning() ? "on" : "off" );
     } );
 
     commandSys->AddCommand( "net_set_heart_rate", []( string& str )
@@ -438,6 +643,150 @@ void EngineCommands::RegisterAllCommands()
         NetSession::GetDefault()->SetHeartBeat( Hz );
     } );
 
+    commandSys->AddCommand( "net_timer_bench", []( string& str )
+    {
+        // net_timer_bench [connections] [seconds a pass] [frame rate]
+        // hosts the default session for the run, blocks until both passes are done
+        CommandParameterParser parser( str );
+        int connectionCount = 1024;
+        float seconds = 5.f;
+        float frameRate = 1000.f / NET_THREAD_SLEEP_MS;
+        parser.GetNext( connectionCount );
+        parser.GetNext( seconds );
+        parser.GetNext( frameRate );
+        if( connectionCount <= 0 || seconds <= 0.f || frameRate <= 0.f )
+        {
+            LOG_INVALID_PARAMETERS( "net_timer_bench" );
+            return;
+        }
+
+        NetSession* session = NetSession::GetDefault();
+        if( session->m_state != eSessionState::DISCONNECTED || session->IsNetThreadRunning() )
+        {
+            LOG_WARNING_TAG( "Net", "net_timer_bench needs a disconnected session without the net thread" );
+            return;
+        }
+        HeadlessNetDriver driver( session );
+        driver.StartUp();
+        session->Host( "timer_bench", GAME_PORT, 8U );
+        string result = driver.RunIdleConnectionBenchmark(
+            (size_t) connectionCount, seconds, frameRate );
+        driver.ShutDown();
+        LOG_INFO_TAG( "Net", "%s", result.c_str() );
+    } );
+
+    commandSys->AddCommand( "net_pool_stats", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetPool::LogAllStats();
+        if( option == "reset" )
+        {
+            for( NetPool* pool : NetPool::GetAllPools() )
+                pool->ResetCounters();
+        }
+    } );
+
+    commandSys->AddCommand( "net_channel_stats", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetSession* session = NetSession::GetDefault();
+        LOG_INFO_TAG( "Net", "%s", session->GetChannelStatsString().c_str() );
+        if( option == "reset" )
+            session->ResetChannelStats();
+    } );
+
+    commandSys->AddCommand( "net_compress", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetSession* session = NetSession::GetDefault();
+        if( option == "on" )
+            session->SetCompressionEnabled( true );
+        else if( option == "off" )
+            session->SetCompressionEnabled( false );
+        else if( !option.empty() )
+        {
+            LOG_INVALID_PARAMETERS( "net_compress" );
+            return;
+        }
+        LOG_INFO_TAG( "Net", "%s", session->GetCompressionStatsString().c_str() );
+    } );
+
+    commandSys->AddCommand( "net_compress_stats", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        parser.GetNext( option );
+
+        NetSession* session = NetSession::GetDefault();
+        LOG_INFO_TAG( "Net", "%s", session->GetCompressionStatsString().c_str() );
+        if( option == "reset" )
+            session->ResetCompressionStats();
+    } );
+
+    // net_compress_train start, then net_compress_train stop [file] once
+    // there is some traffic
+    commandSys->AddCommand( "net_compress_train", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        string path;
+        if( !parser.GetNext( option ) )
+        {
+            LOG_INVALID_PARAMETERS( "net_compress_train" );
+            return;
+        }
+        parser.GetNext( path );
+
+        NetSession* session = NetSession::GetDefault();
+        if( option == "start" )
+        {
+            session->StartCompressionTraining();
+        }
+        else if( option == "stop" )
+        {
+            session->StopCompressionTraining();
+            if( !path.empty() && !session->SaveCompressionDictionary( path ) )
+                LOG_WARNING_TAG( "Net", "Could not save dictionary %s", path.c_str() );
+        }
+        else
+        {
+            LOG_INVALID_PARAMETERS( "net_compress_train" );
+        }
+    } );
+
+    // both ends need the same dictionary
+    commandSys->AddCommand( "net_compress_dict", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        string option;
+        string path;
+        if( !parser.GetNext( option ) )
+        {
+            LOG_INVALID_PARAMETERS( "net_compress_dict" );
+            return;
+        }
+        parser.GetNext( path );
+
+        NetSession* session = NetSession::GetDefault();
+        if( option == "load" && !path.empty() )
+            session->LoadCompressionDictionary( path );
+        else if( option == "save" && !path.empty() )
+            session->SaveCompressionDictionary( path );
+        else if( option == "clear" )
+            session->ClearCompressionDictionary();
+        else
+            LOG_INVALID_PARAMETERS( "net_compress_dict" );
+    } );
+
     commandSys->AddCommand( "net_easy_add", []( string& str )
     {
         CommandParameterParser parser( str );
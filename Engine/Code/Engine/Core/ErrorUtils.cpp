@@ -1,9 +1,21 @@
 #ifdef _WIN32
 #define PLATFORM_WINDOWS
 #include "Engine/Core/WindowsCommon.hpp"
+#else
+// no debugger, dialogues or cursor off windows, errors only print
+#include <signal.h>
+#define TRUE 1
+#define IsDebuggerPresent() 0
+#define ShowCursor( show )
+#define __debugbreak() raise( SIGTRAP )
+// vsnprintf always truncates and terminates
+#define _TRUNCATE 0
+#define vsnprintf_s( buffer, size, count, format, args ) vsnprintf( buffer, size, format, args )
 #endif
 
 #include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
 #include <iostream>
 
 #include "Engine/Core/ErrorUtils.hpp"
@@ -280,7 +292,7 @@ void AssertBreakpoint( bool condition )
     }
 }
 
-__declspec( noreturn ) void FatalError(
+[[noreturn]] void FatalError(
     const char* filePath, const char* functionName, int lineNum,
     const string& reasonForError, const char* conditionText )
 {
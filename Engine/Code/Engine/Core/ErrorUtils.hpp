@@ -22,7 +22,7 @@ void HookDebuggerToLogger( Logger* logger );
 void DebuggerPrintf( const char* messageFormat, ... );
 
 bool IsDebuggerAvailable();
-__declspec( noreturn ) void FatalError(
+[[noreturn]] void FatalError(
     const char* filePath, const char* functionName, int lineNum,
     const string& reasonForError, const char* conditionText=nullptr );
 
@@ -21,6 +21,8 @@ typedef unsigned int uint;
 typedef unsigned char uchar;
 typedef unsigned char Byte;
 
+typedef uint64_t uint64;
+typedef uint32_t uint32;
 typedef uint16_t uint16;
 typedef uint8_t uint8;
 
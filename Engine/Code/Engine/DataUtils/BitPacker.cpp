@@ -0,0 +1,270 @@
+#include "Engine/DataUtils/BitPacker.hpp"
+#include "Engine/DataUtils/BytePacker.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/Rgba.hpp"
+
+BitPacker::BitPacker( BytePacker& bytes )
+    : m_bytes( bytes )
+{
+}
+
+//--------------------------------------------------------------------------------------
+// Writing
+
+bool BitPacker::WriteBits( uint32 value, uint bitCount )
+{
+    if( m_failed )
+        return false;
+
+    if( bitCount < 32 )
+        value &= ( 1U << bitCount ) - 1U;
+
+    m_scratch |= (uint64) value << m_scratchBitCount;
+    m_scratchBitCount += bitCount;
+    m_writtenBitCount += bitCount;
+
+    while( m_scratchBitCount >= 8 )
+    {
+        Byte byte = (Byte) ( m_scratch & 0xFF );
+        if( !m_bytes.WriteBytes( 1, &byte ) )
+        {
+            m_failed = true;
+            return false;
+        }
+        m_scratch >>= 8;
+        m_scratchBitCount -= 8;
+    }
+    return true;
+}
+
+bool BitPacker::WriteBool( bool value )
+{
+    return WriteBits( value ? 1U : 0U, 1 );
+}
+
+bool BitPacker::WriteUint( uint value, uint maxValue )
+{
+    return WriteBits( Min( value, maxValue ), GetBitsRequired( maxValue ) );
+}
+
+bool BitPacker::WriteFloat( float value, float min, float max, float precision )
+{
+    return WriteQuantized( value, min, max, GetFloatBitCount( min, max, precision ) );
+}
+
+bool BitPacker::WriteVec3( const Vec3& value, float min, float max, float precision )
+{
+    uint bitCount = GetFloatBitCount( min, max, precision );
+    return WriteQuantized( value.x, min, max, bitCount )
+        && WriteQuantized( value.y, min, max, bitCount )
+        && WriteQuantized( value.z, min, max, bitCount );
+}
+
+bool BitPacker::WriteUnitVec3( const Vec3& unitVec, uint bitsPerComponent )
+{
+    // project onto the octahedron |x|+|y|+|z| = 1 then fold the lower
+    // half over so two components cover the whole sphere
+    float l1 = fabsf( unitVec.x ) + fabsf( unitVec.y ) + fabsf( unitVec.z );
+    if( l1 < EPSILON )
+        l1 = 1.f;
+    float x = unitVec.x / l1;
+    float y = unitVec.y / l1;
+    if( unitVec.z < 0.f )
+    {
+        float foldedX = ( 1.f - fabsf( y ) ) * ( x >= 0.f ? 1.f : -1.f );
+        float foldedY = ( 1.f - fabsf( x ) ) * ( y >= 0.f ? 1.f : -1.f );
+        x = foldedX;
+        y = foldedY;
+    }
+    return WriteQuantized( x, -1.f, 1.f, bitsPerComponent )
+        && WriteQuantized( y, -1.f, 1.f, bitsPerComponent );
+}
+
+bool BitPacker::WriteEuler( const Vec3& euler, uint bitsPerAngle )
+{
+    return WriteQuantized( ModFloat( euler.x, 360.f ), 0.f, 360.f, bitsPerAngle )
+        && WriteQuantized( ModFloat( euler.y, 360.f ), 0.f, 360.f, bitsPerAngle )
+        && WriteQuantized( ModFloat( euler.z, 360.f ), 0.f, 360.f, bitsPerAngle );
+}
+
+bool BitPacker::WriteRgba( const Rgba& color, uint bitsPerChannel )
+{
+    return WriteRgb( color, bitsPerChannel )
+        && WriteBits( color.a >> ( 8 - bitsPerChannel ), bitsPerChannel );
+}
+
+bool BitPacker::WriteRgb( const Rgba& color, uint bitsPerChannel )
+{
+    uint shift = 8 - bitsPerChannel;
+    return WriteBits( color.r >> shift, bitsPerChannel )
+        && WriteBits( color.g >> shift, bitsPerChannel )
+        && WriteBits( color.b >> shift, bitsPerChannel );
+}
+
+bool BitPacker::FlushWrite()
+{
+    if( m_scratchBitCount == 0 )
+        return !m_failed;
+    // pad to the byte boundary, padding bits do not count as written
+    size_t writtenBitCount = m_writtenBitCount;
+    bool success = WriteBits( 0, 8 - m_scratchBitCount );
+    m_writtenBitCount = writtenBitCount;
+    return success;
+}
+
+//--------------------------------------------------------------------------------------
+// Reading
+
+bool BitPacker::ReadBits( uint32* out_value, uint bitCount )
+{
+    *out_value = 0;
+    if( m_failed )
+        return false;
+
+    while( m_scratchBitCount < bitCount )
+    {
+        Byte byte;
+        if( m_bytes.ReadBytes( &byte, 1 ) != 1 )
+        {
+            m_failed = true;
+            return false;
+        }
+        m_scratch |= (uint64) byte << m_scratchBitCount;
+        m_scratchBitCount += 8;
+    }
+
+    uint64 mask = ( (uint64) 1 << bitCount ) - 1;
+    *out_value = (uint32) ( m_scratch & mask );
+    m_scratch >>= bitCount;
+    m_scratchBitCount -= bitCount;
+    return true;
+}
+
+bool BitPacker::ReadBool( bool* out_value )
+{
+    uint32 bit;
+    bool success = ReadBits( &bit, 1 );
+    *out_value = bit != 0;
+    return success;
+}
+
+bool BitPacker::ReadUint( uint* out_value, uint maxValue )
+{
+    uint32 value;
+    bool success = ReadBits( &value, GetBitsRequired( maxValue ) );
+    *out_value = Min( (uint) value, maxValue );
+    return success;
+}
+
+bool BitPacker::ReadFloat( float* out_value, float min, float max, float precision )
+{
+    return ReadQuantized( out_value, min, max, GetFloatBitCount( min, max, precision ) );
+}
+
+bool BitPacker::ReadVec3( Vec3* out_value, float min, float max, float precision )
+{
+    uint bitCount = GetFloatBitCount( min, max, precision );
+    return ReadQuantized( &out_value->x, min, max, bitCount )
+        && ReadQuantized( &out_value->y, min, max, bitCount )
+        && ReadQuantized( &out_value->z, min, max, bitCount );
+}
+
+bool BitPacker::ReadUnitVec3( Vec3* out_unitVec, uint bitsPerComponent )
+{
+    float x, y;
+    if( !ReadQuantized( &x, -1.f, 1.f, bitsPerComponent )
+        || !ReadQuantized( &y, -1.f, 1.f, bitsPerComponent ) )
+        return false;
+
+    float z = 1.f - fabsf( x ) - fabsf( y );
+    if( z < 0.f )
+    {
+        float unfoldedX = ( 1.f - fabsf( y ) ) * ( x >= 0.f ? 1.f : -1.f );
+        float unfoldedY = ( 1.f - fabsf( x ) ) * ( y >= 0.f ? 1.f : -1.f );
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+    *out_unitVec = Vec3( x, y, z ).GetNormalized();
+    return true;
+}
+
+bool BitPacker::ReadEuler( Vec3* out_euler, uint bitsPerAngle )
+{
+    return ReadQuantized( &out_euler->x, 0.f, 360.f, bitsPerAngle )
+        && ReadQuantized( &out_euler->y, 0.f, 360.f, bitsPerAngle )
+        && ReadQuantized( &out_euler->z, 0.f, 360.f, bitsPerAngle );
+}
+
+bool BitPacker::ReadRgba( Rgba* out_color, uint bitsPerChannel )
+{
+    uint32 a;
+    if( !ReadRgb( out_color, bitsPerChannel ) || !ReadBits( &a, bitsPerChannel ) )
+        return false;
+    out_color->a = (unsigned char) ( a << ( 8 - bitsPerChannel ) );
+    return true;
+}
+
+bool BitPacker::ReadRgb( Rgba* out_color, uint bitsPerChannel )
+{
+    uint32 r, g, b;
+    if( !ReadBits( &r, bitsPerChannel )
+        || !ReadBits( &g, bitsPerChannel )
+        || !ReadBits( &b, bitsPerChannel ) )
+        return false;
+
+    uint shift = 8 - bitsPerChannel;
+    out_color->r = (unsigned char) ( r << shift );
+    out_color->g = (unsigned char) ( g << shift );
+    out_color->b = (unsigned char) ( b << shift );
+    out_color->a = 255;
+    return true;
+}
+
+void BitPacker::FinishRead()
+{
+    // never more than a partial byte is buffered past what was asked for
+    m_scratch = 0;
+    m_scratchBitCount = 0;
+}
+
+//--------------------------------------------------------------------------------------
+// Sizes
+
+uint BitPacker::GetBitsRequired( uint maxValue )
+{
+    uint bitCount = 0;
+    while( maxValue != 0 )
+    {
+        ++bitCount;
+        maxValue >>= 1;
+    }
+    return bitCount;
+}
+
+uint BitPacker::GetFloatBitCount( float min, float max, float precision )
+{
+    uint steps = (uint) ceilf( ( max - min ) / precision );
+    return GetBitsRequired( steps );
+}
+
+//--------------------------------------------------------------------------------------
+// Quantize
+
+bool BitPacker::WriteQuantized( float value, float min, float max, uint bitCount )
+{
+    uint32 maxQuantized = bitCount >= 32 ? 0xFFFFFFFF : ( 1U << bitCount ) - 1U;
+    float normalized = Clampf01( ( value - min ) / ( max - min ) );
+    uint32 quantized = (uint32) ( normalized * (float) maxQuantized + 0.5f );
+    return WriteBits( quantized, bitCount );
+}
+
+bool BitPacker::ReadQuantized( float* out_value, float min, float max, uint bitCount )
+{
+    uint32 quantized;
+    if( !ReadBits( &quantized, bitCount ) )
+        return false;
+    uint32 maxQuantized = bitCount >= 32 ? 0xFFFFFFFF : ( 1U << bitCount ) - 1U;
+    *out_value = min + ( max - min ) * ( (float) quantized / (float) maxQuantized );
+    return true;
+}
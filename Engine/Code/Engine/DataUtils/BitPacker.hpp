@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Engine/Core/EngineCommonH.hpp"
+
+class BytePacker;
+class Vec3;
+class Rgba;
+
+// Reads and writes values at arbitrary bit widths through a BytePacker
+// Bits are packed LSB first so the byte stream does not depend on platform
+// endianness. Bits are handed to the BytePacker a byte at a time at its
+// write / read head, so byte writes can come before and after a bit section
+// as long as FlushWrite / FinishRead is called when the bit section ends
+//
+// A failed read or write (out of bytes) sticks, check HasFailed at the end
+class BitPacker
+{
+public:
+    explicit BitPacker( BytePacker& bytes );
+
+    // Writing
+    bool WriteBits( uint32 value, uint bitCount ); // up to 32 bits
+    bool WriteBool( bool value );
+    // value in [0, maxValue], uses GetBitsRequired( maxValue ) bits
+    bool WriteUint( uint value, uint maxValue );
+    // quantized to precision and clamped to [min, max]
+    bool WriteFloat( float value, float min, float max, float precision );
+    bool WriteVec3( const Vec3& value, float min, float max, float precision );
+    // octahedral encoding, vector should be normalized
+    bool WriteUnitVec3( const Vec3& unitVec, uint bitsPerComponent );
+    // each angle wrapped to [0, 360)
+    bool WriteEuler( const Vec3& euler, uint bitsPerAngle );
+    // top bitsPerChannel of each channel
+    bool WriteRgba( const Rgba& color, uint bitsPerChannel = 8 );
+    // alpha is not sent and reads back as 255
+    bool WriteRgb( const Rgba& color, uint bitsPerChannel = 8 );
+
+    // pads the last byte with zero bits and writes it out
+    bool FlushWrite();
+
+    // Reading
+    bool ReadBits( uint32* out_value, uint bitCount );
+    bool ReadBool( bool* out_value );
+    bool ReadUint( uint* out_value, uint maxValue );
+    bool ReadFloat( float* out_value, float min, float max, float precision );
+    bool ReadVec3( Vec3* out_value, float min, float max, float precision );
+    bool ReadUnitVec3( Vec3* out_unitVec, uint bitsPerComponent );
+    bool ReadEuler( Vec3* out_euler, uint bitsPerAngle );
+    bool ReadRgba( Rgba* out_color, uint bitsPerChannel = 8 );
+    bool ReadRgb( Rgba* out_color, uint bitsPerChannel = 8 );
+
+    // drops the padding bits left in the current byte
+    void FinishRead();
+
+    bool HasFailed() const { return m_failed; }
+    size_t GetWrittenBitCount() const { return m_writtenBitCount; }
+
+    // Sizes, for budgeting before writing
+    static uint GetBitsRequired( uint maxValue );
+    static uint GetFloatBitCount( float min, float max, float precision );
+
+private:
+    bool WriteQuantized( float value, float min, float max, uint bitCount );
+    bool ReadQuantized( float* out_value, float min, float max, uint bitCount );
+
+private:
+    BytePacker& m_bytes;
+
+    uint64 m_scratch = 0;
+    uint m_scratchBitCount = 0;
+    size_t m_writtenBitCount = 0;
+    bool m_failed = false;
+};
@@ -1,6 +1,8 @@
 #include "Engine/DataUtils/BytePacker.hpp"
 #include "Engine/Core/EngineCommonC.hpp"
 
+#include <string.h>
+
 BytePacker::BytePacker()
 {
     m_bytePackerOptions = BYTEPACKER_OWNS_MEMORY | BYTEPACKER_CAN_GROW;
@@ -49,6 +51,25 @@ bool BytePacker::Reserve( size_t byteCount )
     return true;
 }
 
+bool BytePacker::Grow( size_t byteCount )
+{
+    if( !OwnsMemory() )
+        return false;
+    return Reserve( byteCount );
+}
+
+bool BytePacker::SetBufferView( void* buffer, size_t byteCount )
+{
+    if( OwnsMemory() )
+        return false;
+
+    m_buffer = (Byte*) buffer;
+    m_bufferSize = byteCount;
+    m_writeHead = byteCount;
+    m_readHead = 0;
+    return true;
+}
+
 void BytePacker::SetEndianness( Endianness byteOrder )
 {
     m_endianness = byteOrder;
@@ -60,18 +81,11 @@ bool BytePacker::WriteBytes( size_t byteCount, const void* data )
     hasRoom = hasRoom && ReadAndWriteHeadsValid();
     if( !hasRoom )
     {
-        if( !OwnsMemory() )
+        bool growSuccess = Grow( GetWrittenByteCount() + byteCount );
+        if( !growSuccess )
         {
             return false;
         }
-        else
-        {
-            bool reserveSuccess = Reserve( GetWrittenByteCount() + byteCount );
-            if( !reserveSuccess )
-            {
-                return false;
-            }
-        }
     }
 
     memcpy( m_buffer + m_writeHead, data, byteCount );
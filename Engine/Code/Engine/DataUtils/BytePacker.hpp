@@ -36,6 +36,15 @@ public:
     // will fail if cannot grow
     bool Reserve( size_t byteCount );
 
+    // called by writes that do not fit, byteCount is the size needed
+    // Reserves if this packer can grow, derived packers can find room elsewhere
+    virtual bool Grow( size_t byteCount );
+
+    // points a non owning packer at byteCount bytes of existing data,
+    // read head at the start and the buffer already full so writes fail
+    // returns false if this packer owns its memory
+    bool SetBufferView( void* buffer, size_t byteCount );
+
     void SetEndianness( Endianness byteOrder );
 
     // all write calls go through this
@@ -2,8 +2,16 @@
 #include <fstream>
 #include <stdio.h>
 
-
+#if defined( _WIN32 )
 #include "Engine/Core/WindowsCommon.hpp"
+#else
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define fopen_s( out_fp, filename, mode ) ( *( out_fp ) = fopen( filename, mode ) )
+#endif
+
 #include "Engine/FileIO/IOUtils.hpp"
 #include "Engine/Core/ErrorUtils.hpp"
 #include "Engine/String/StringUtils.hpp"
@@ -13,6 +21,8 @@ namespace IOUtils
 
 const string SEPARATORS = "\\/";
 
+#if defined( _WIN32 )
+
 string GetCurrentDir()
 {
     char working_directory[MAX_PATH + 1];
@@ -20,6 +30,18 @@ string GetCurrentDir()
     return string( working_directory );
 }
 
+#else
+
+string GetCurrentDir()
+{
+    char working_directory[PATH_MAX + 1];
+    if( getcwd( working_directory, sizeof( working_directory ) ) == nullptr )
+        return "";
+    return string( working_directory );
+}
+
+#endif
+
 string RelativeToFullPath( const string& relativePath )
 {
     int len = (int) relativePath.size();
@@ -34,6 +56,8 @@ string RelativeToFullPath( const string& relativePath )
 
 }
 
+#if defined( _WIN32 )
+
 bool DirExists( const string& path )
 {
     DWORD attrib = GetFileAttributesA( path.c_str() );
@@ -123,6 +147,81 @@ bool MakeFileR( const string& path )
     return true;
 }
 
+#else
+
+bool DirExists( const string& path )
+{
+    struct stat info;
+    return stat( path.c_str(), &info ) == 0 && S_ISDIR( info.st_mode );
+}
+
+bool FileExists( const string& path )
+{
+    // anything but not found exists, we may just not have access to it
+    struct stat info;
+    return stat( path.c_str(), &info ) == 0 || errno != ENOENT;
+}
+
+bool MakeDirR( const string& path )
+{
+    struct stat info;
+    if( stat( path.c_str(), &info ) != 0 )
+    {
+        std::size_t slashIdx = path.find_last_of( SEPARATORS );
+        if( slashIdx != string::npos && slashIdx != 0 )
+        {
+            bool parentResult = MakeDirR( path.substr( 0, slashIdx ) );
+            if( parentResult == false )
+                return false;
+        }
+
+        if( mkdir( path.c_str(), 0755 ) != 0 && errno != EEXIST )
+        {
+            LOG_WARNING( "Could not create dir: " + path );
+            return false;
+        }
+    }
+    else if( !S_ISDIR( info.st_mode ) )
+    {
+        LOG_WARNING( "Could not create dir, file with same name exists: " + path );
+        return false;
+    }
+
+    return true;
+}
+
+bool MakeFileR( const string& path )
+{
+    struct stat info;
+    if( stat( path.c_str(), &info ) == 0 )
+    {
+        if( S_ISDIR( info.st_mode ) )
+        {
+            LOG_WARNING( "Could not create file, dir with same name exists: " + path );
+            return false;
+        }
+        return true;
+    }
+
+    std::size_t slashIdx = path.find_last_of( SEPARATORS );
+    if( slashIdx != string::npos && slashIdx != 0 )
+    {
+        bool parentResult = MakeDirR( path.substr( 0, slashIdx ) );
+        if( parentResult == false )
+            return false;
+    }
+    std::ofstream myfile;
+    myfile.open( path );
+    if( myfile.fail() )
+        return false;
+    myfile.close();
+    if( myfile.fail() )
+        return false;
+    return true;
+}
+
+#endif
+
 bool WriteToFile( const string& path, const string& text )
 {
     Strings strings;
@@ -155,6 +254,43 @@ bool WriteToFile( const string& path, const Strings& text )
     return true;
 }
 
+bool WriteBufferToFile( const string& path, const void* buffer, size_t byteCount )
+{
+    if( MakeFileR( path ) == false )
+        return false;
+
+    std::ofstream myfile;
+    myfile.open( path, std::ios::out | std::ios::binary );
+    if( myfile.fail() )
+        return false;
+    myfile.write( (const char*) buffer, byteCount );
+    myfile.close();
+    if( myfile.fail() )
+        return false;
+    return true;
+}
+
+bool AppendToFile( const string& path, const string& text )
+{
+    return AppendBufferToFile( path, text.data(), text.size() );
+}
+
+bool AppendBufferToFile( const string& path, const void* buffer, size_t byteCount )
+{
+    if( MakeFileR( path ) == false )
+        return false;
+
+    std::ofstream myfile;
+    myfile.open( path, std::ios::out | std::ios::binary | std::ios::app );
+    if( myfile.fail() )
+        return false;
+    myfile.write( (const char*) buffer, byteCount );
+    myfile.close();
+    if( myfile.fail() )
+        return false;
+    return true;
+}
+
 void* ReadFileToNewStringBuffer( char const* filename )
 {
     FILE *fp = nullptr;
@@ -181,7 +317,7 @@ void* ReadFileToNewStringBuffer( char const* filename )
 void* ReadFileToNewRawBuffer( char const* filename, size_t& out_byteCount )
 {
     FILE *fp = nullptr;
-    fopen_s( &fp, filename, "r" );
+    fopen_s( &fp, filename, "rb" );
     out_byteCount = 0U;
     if( fp == nullptr )
         return nullptr;
@@ -16,6 +16,10 @@ bool MakeFileR( const string& path );
 
 bool WriteToFile( const string& path, const string& text );
 bool WriteToFile( const string& path, const Strings& text );
+bool WriteBufferToFile( const string& path, const void* buffer, size_t byteCount );
+// creates the file if needed, text is written as is
+bool AppendToFile( const string& path, const string& text );
+bool AppendBufferToFile( const string& path, const void* buffer, size_t byteCount );
 void* ReadFileToNewStringBuffer( char const* filename );
 void* ReadFileToNewRawBuffer( char const* filename, size_t& out_byteCount );
 string ReadFileToString( char const* filename );
@@ -506,6 +506,18 @@ bool Mat4::IsAnyNaN() const
     return false;
 }
 
+// declared with the other ToStrings in StringUtils, lives here so
+// StringUtils does not need Mat4, which only MSVC compiles
+const string ToString( const Mat4& var )
+{
+    return Stringf( "%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f",
+                    var.Ix, var.Jx, var.Kx, var.Tx,
+                    var.Iy, var.Jy, var.Ky, var.Ty,
+                    var.Iz, var.Jz, var.Kz, var.Tz,
+                    var.Iw, var.Jw, var.Kw, var.Tw
+    );
+}
+
 string Mat4::ToString() const
 {
     return ::ToString( *this );
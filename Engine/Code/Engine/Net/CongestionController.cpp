@@ -0,0 +1,118 @@
+#include "Engine/Net/CongestionController.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//--------------------------------------------------------------------------------------
+// CongestionController
+
+void CongestionController::Update( float currentTime,
+                                   float maxSendRate,
+                                   float smoothedRoundTripTime )
+{
+    if( !m_isEnabled )
+    {
+        m_sendRate = maxSendRate;
+        m_packetBudget = PACKET_MTU;
+        return;
+    }
+
+    if( currentTime - m_lastUpdateTime < CONGESTION_UPDATE_INTERVAL )
+        return;
+    m_lastUpdateTime = currentTime;
+
+    // follow route changes, the lowest is found again within a window
+    if( currentTime - m_minRoundTripTimeResetTime > CONGESTION_MIN_RTT_WINDOW )
+    {
+        m_minRoundTripTime = smoothedRoundTripTime;
+        m_minRoundTripTimeResetTime = currentTime;
+    }
+
+    size_t outcomeCount = m_intervalDeliveredCount + m_intervalLostCount;
+    if( outcomeCount != 0 )
+        m_lastIntervalLossRate = (float) m_intervalLostCount / (float) outcomeCount;
+    m_intervalDeliveredCount = 0;
+    m_intervalLostCount = 0;
+
+    bool isLossy = outcomeCount >= CONGESTION_MIN_SAMPLES
+        && m_lastIntervalLossRate > CONGESTION_LOSS_THRESHOLD;
+    bool isQueueing = m_minRoundTripTime > 0.f
+        && smoothedRoundTripTime
+        > m_minRoundTripTime * CONGESTION_RTT_RISE + CONGESTION_RTT_SLACK;
+
+    if( isLossy || isQueueing )
+    {
+        // once per round trip, it takes that long to see the backoff work
+        float backoffWait = Max( smoothedRoundTripTime, CONGESTION_UPDATE_INTERVAL );
+        if( currentTime - m_lastBackoffTime > backoffWait )
+        {
+            m_sendRate = Max( m_sendRate * CONGESTION_BACKOFF, CONGESTION_MIN_SEND_RATE );
+            m_packetBudget = Max( (size_t) ( m_packetBudget * CONGESTION_BACKOFF ),
+                                  (size_t) CONGESTION_MIN_PACKET_BUDGET );
+            m_lastBackoffTime = currentTime;
+            ++m_backoffCount;
+        }
+    }
+    // only a link that carried traffic has shown it is clean
+    else if( outcomeCount != 0 )
+    {
+        m_sendRate += CONGESTION_PROBE_RATE_STEP;
+        m_packetBudget = Min( m_packetBudget + CONGESTION_PROBE_BUDGET_STEP,
+                              (size_t) PACKET_MTU );
+    }
+
+    m_sendRate = Min( m_sendRate, maxSendRate );
+}
+
+void CongestionController::Reset( float maxSendRate )
+{
+    m_sendRate = maxSendRate;
+    m_packetBudget = PACKET_MTU;
+    m_minRoundTripTime = 0.f;
+    m_intervalDeliveredCount = 0;
+    m_intervalLostCount = 0;
+    m_lastIntervalLossRate = 0.f;
+}
+
+void CongestionController::OnPacketDelivered( float roundTripTime )
+{
+    ++m_intervalDeliveredCount;
+    if( m_minRoundTripTime <= 0.f || roundTripTime < m_minRoundTripTime )
+        m_minRoundTripTime = roundTripTime;
+}
+
+void CongestionController::OnPacketLost()
+{
+    ++m_intervalLostCount;
+}
+
+//--------------------------------------------------------------------------------------
+// BandwidthBucket
+
+void BandwidthBucket::Refill( float currentTime )
+{
+    float deltaSeconds = currentTime - m_lastRefillTime;
+    m_lastRefillTime = currentTime;
+    if( !IsCapped() )
+        return;
+
+    // a short burst can build up, not more
+    float maxTokens = Max( m_bytesPerSecond * BANDWIDTH_BURST_SECONDS, (float) PACKET_MTU );
+    m_tokens = Min( m_tokens + m_bytesPerSecond * deltaSeconds, maxTokens );
+}
+
+bool BandwidthBucket::CanSend() const
+{
+    return !IsCapped() || m_tokens > 0.f;
+}
+
+void BandwidthBucket::Spend( size_t byteCount )
+{
+    if( IsCapped() )
+        m_tokens -= (float) byteCount;
+}
+
+void BandwidthBucket::SetCap( float bytesPerSecond )
+{
+    m_bytesPerSecond = Max( bytesPerSecond, 0.f );
+    m_tokens = 0.f;
+}
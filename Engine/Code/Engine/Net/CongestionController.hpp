@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+
+// Adapts how often and how much one connection sends to what the link takes
+// Backs off multiplicatively when packets go missing or the round trip time
+// climbs well above the lowest seen (queues are filling up), probes back up
+// additively while the link is clean
+class CongestionController
+{
+public:
+    // does work once per CONGESTION_UPDATE_INTERVAL
+    // maxSendRate is the configured rate, the controller never goes above it
+    void Update( float currentTime, float maxSendRate, float smoothedRoundTripTime );
+    void Reset( float maxSendRate );
+
+    void OnPacketDelivered( float roundTripTime );
+    void OnPacketLost();
+
+    float GetSendRate() const { return m_sendRate; }
+    size_t GetPacketBudget() const { return m_packetBudget; }
+    float GetLastLossRate() const { return m_lastIntervalLossRate; }
+
+public:
+
+    bool m_isEnabled = true;
+
+    float m_sendRate = MAX_SEND_RATE; // Hz
+    size_t m_packetBudget = PACKET_MTU; // bytes per packet
+
+    float m_lastUpdateTime = 0.f;
+    float m_lastBackoffTime = 0.f;
+
+    // lowest round trip time is what an empty queue looks like
+    float m_minRoundTripTime = 0.f;
+    float m_minRoundTripTimeResetTime = 0.f;
+
+    size_t m_intervalDeliveredCount = 0;
+    size_t m_intervalLostCount = 0;
+    float m_lastIntervalLossRate = 0.f;
+
+    // Analytics
+    size_t m_backoffCount = 0;
+};
+
+// Caps bytes per second, sends can overdraw and then have to wait
+class BandwidthBucket
+{
+public:
+    void Refill( float currentTime );
+    bool CanSend() const;
+    void Spend( size_t byteCount );
+    bool IsCapped() const { return m_bytesPerSecond > 0.f; }
+
+    void SetCap( float bytesPerSecond );
+
+public:
+
+    float m_bytesPerSecond = 0.f; // 0 for no cap
+    float m_tokens = 0.f; // bytes
+    float m_lastRefillTime = 0.f;
+};
@@ -1,6 +1,7 @@
 #include "Engine/Net/EngineNetMessages.hpp"
 
 #include "Engine/Net/NetCommonC.hpp"
+#include "Engine/Net/NetSchema.hpp"
 
 
 NetMessageSelfRegister::NetMessageSelfRegister(
@@ -10,18 +11,62 @@ NetMessageSelfRegister::NetMessageSelfRegister(
     uint8 messageId /*= NET_MESSAGE_ID_AUTO*/,
     uint8 channelIdx /*= 0 */ )
 {
-    NetMessageDatabase::RegisterDefinition( name, cb, flags, messageId, channelIdx );
+    m_handle = NetMessageDatabase::RegisterDefinition( name, cb, flags, messageId, channelIdx );
+}
+
+namespace
+{
+
+struct AddPayload
+{
+    float m_a = 0.f;
+    float m_b = 0.f;
+    NET_SCHEMA( m_a, m_b )
+};
+
+struct AddResponsePayload
+{
+    float m_a = 0.f;
+    float m_b = 0.f;
+    float m_sum = 0.f;
+    NET_SCHEMA( m_a, m_b, m_sum )
+};
+
+struct FragmentHeader
+{
+    uint16 m_transferID = 0;
+    uint16 m_fragmentIdx = 0;
+    uint16 m_fragmentCount = 0;
+    NET_SCHEMA( m_transferID, m_fragmentIdx, m_fragmentCount )
+};
+
 }
 
 namespace EngineNetMessages
 {
 
+// defined by the registrations below
+NET_MESSAGE_DECLARE( ping );
+NET_MESSAGE_DECLARE( pong );
+NET_MESSAGE_DECLARE( add );
+NET_MESSAGE_DECLARE( add_response );
+NET_MESSAGE_DECLARE( large_test );
+NET_MESSAGE_DECLARE( heartbeat );
+NET_MESSAGE_DECLARE( join_request );
+NET_MESSAGE_DECLARE( join_deny );
+NET_MESSAGE_DECLARE( join_accept );
+NET_MESSAGE_DECLARE( new_connection );
+NET_MESSAGE_DECLARE( join_finished );
+NET_MESSAGE_DECLARE( update_connection_state );
+NET_MESSAGE_DECLARE( hangup );
+NET_MESSAGE_DECLARE( fragment );
+
 //--------------------------------------------------------------------------------------
 // Ping
 
 NetMessage* Compose_Ping( const string& str )
 {
-    NetMessage* msg = new NetMessage( "ping" );
+    NetMessage* msg = new NetMessage( ping_handle );
     msg->WriteString( str.c_str() );
     return msg;
 }
@@ -52,7 +97,7 @@ NET_MESSAGE_STATIC_REGSITER(
 
 NetMessage* Compose_Pong()
 {
-    return new NetMessage( "pong" );
+    return new NetMessage( pong_handle );
 }
 
 NET_MESSAGE_STATIC_REGSITER(
@@ -70,21 +115,24 @@ NET_MESSAGE_STATIC_REGSITER(
 
 NetMessage* Compose_Add( float a, float b )
 {
-    NetMessage* msg = new NetMessage( "add" );
-    msg->Write( a );
-    msg->Write( b );
+    NetMessage* msg = new NetMessage( add_handle );
+    AddPayload payload;
+    payload.m_a = a;
+    payload.m_b = b;
+    payload.Pack( *msg );
     return msg;
 }
 
 NET_MESSAGE_STATIC_REGSITER_AUTO( add, eNetMessageFlag::DEFAULT )
 {
-    float a, b;
-
-    if( !netMessage->Read( &a ) || !netMessage->Read( &b ) )
+    AddPayload payload;
+    if( !payload.Unpack( *netMessage ) )
     {
         LOG_WARNING_TAG( "Net", "Bad add message" );
         return false;
     }
+    float a = payload.m_a;
+    float b = payload.m_b;
     LOG_INFO_TAG( "Net", "Incomming [%s] [add] %f + %f",
                   netMessage->m_senderAddress.ToStringAll().c_str(),
                   a, b );
@@ -99,35 +147,69 @@ NET_MESSAGE_STATIC_REGSITER_AUTO( add, eNetMessageFlag::DEFAULT )
 // Add Response
 NetMessage* Compose_AddResponse( float a, float b, float sum )
 {
-    NetMessage* msg = new NetMessage( "add_response" );
-    msg->Write( a );
-    msg->Write( b );
-    msg->Write( sum );
+    NetMessage* msg = new NetMessage( add_response_handle );
+    AddResponsePayload payload;
+    payload.m_a = a;
+    payload.m_b = b;
+    payload.m_sum = sum;
+    payload.Pack( *msg );
     return msg;
 }
 
 NET_MESSAGE_STATIC_REGSITER_AUTO( add_response, eNetMessageFlag::DEFAULT )
 {
-    float a, b, sum;
-
-    if( !netMessage->Read( &a )
-        || !netMessage->Read( &b )
-        || !netMessage->Read( &sum ) )
+    AddResponsePayload payload;
+    if( !payload.Unpack( *netMessage ) )
     {
         LOG_WARNING_TAG( "Net", "Bad add_response message" );
         return false;
     }
     LOG_INFO_TAG( "Net", "Incomming [%s] [add_response] %f + %f = %f",
                   netMessage->m_senderAddress.ToStringAll().c_str(),
-                  a, b, sum );
+                  payload.m_a, payload.m_b, payload.m_sum );
     return true;
 }
 
+//--------------------------------------------------------------------------------------
+// Large Test
+NetMessage* Compose_LargeTest( size_t byteCount )
+{
+    NetMessage* msg = new NetMessage( large_test_handle );
+    msg->Write( (uint) byteCount );
+    for( size_t idx = 0; idx < byteCount; ++idx )
+    {
+        if( !msg->Write( (uint8) ( idx * 31 + 7 ) ) )
+            break;
+    }
+    return msg;
+}
+
+NET_MESSAGE_STATIC_REGSITER_AUTO( large_test, eNetMessageFlag::RELIABLE )
+{
+    uint byteCount;
+    if( !netMessage->Read( &byteCount ) )
+        return false;
+
+    size_t mismatchCount = 0;
+    size_t readCount = 0;
+    uint8 value;
+    while( netMessage->Read( &value ) )
+    {
+        if( value != (uint8) ( readCount * 31 + 7 ) )
+            ++mismatchCount;
+        ++readCount;
+    }
+    LOG_INFO_TAG( "Net", "Incomming [%s] [large_test] %u of %u bytes, %u wrong",
+                  netMessage->m_senderAddress.ToStringAll().c_str(),
+                  (uint) readCount, byteCount, (uint) mismatchCount );
+    return readCount == byteCount && mismatchCount == 0;
+}
+
 //--------------------------------------------------------------------------------------
 // Heartbeat
 NetMessage* Compose_Heartbeat( uint timeMS )
 {
-    NetMessage* msg = new NetMessage( "heartbeat" );
+    NetMessage* msg = new NetMessage( heartbeat_handle );
     msg->Write( timeMS );
     return msg;
 }
@@ -150,7 +232,7 @@ NET_MESSAGE_STATIC_REGSITER(
 // JoinRequest
 NetMessage* Compose_JoinRequest()
 {
-    NetMessage* msg = new NetMessage( "join_request" );
+    NetMessage* msg = new NetMessage( join_request_handle );
     return msg;
 }
 
@@ -165,7 +247,7 @@ NET_MESSAGE_STATIC_REGSITER(
 // JoinDeny
 NetMessage* Compose_JoinDeny()
 {
-    NetMessage* msg = new NetMessage( "join_deny" );
+    NetMessage* msg = new NetMessage( join_deny_handle );
     return msg;
 }
 
@@ -178,9 +260,9 @@ NET_MESSAGE_STATIC_REGSITER(
 
 //--------------------------------------------------------------------------------------
 // JoinAccept
-NetMessage* Compose_JoinAccept( uint8 assignedConnectionIdx )
+NetMessage* Compose_JoinAccept( ConnectionIdx assignedConnectionIdx )
 {
-    NetMessage* msg = new NetMessage( "join_accept" );
+    NetMessage* msg = new NetMessage( join_accept_handle );
     msg->Write( assignedConnectionIdx );
     return msg;
 }
@@ -189,7 +271,7 @@ NET_MESSAGE_STATIC_REGSITER(
     join_accept, eNetMessageFlag::RELIABLE_IN_ORDER,
     eNetCoreMessageIdx::NETMSG_JOIN_ACCEPT, 0 )
 {
-    uint8 assignedIdx;
+    ConnectionIdx assignedIdx;
     if( !netMessage->Read( &assignedIdx ) )
         return false;
 
@@ -200,7 +282,7 @@ NET_MESSAGE_STATIC_REGSITER(
 // NewConnection
 NetMessage* Compose_NewConnection()
 {
-    NetMessage* msg = new NetMessage( "new_connection" );
+    NetMessage* msg = new NetMessage( new_connection_handle );
     return msg;
 }
 
@@ -215,7 +297,7 @@ NET_MESSAGE_STATIC_REGSITER(
 // JoinFinished
 NetMessage* Compose_JoinFinished()
 {
-    NetMessage* msg = new NetMessage( "join_finished" );
+    NetMessage* msg = new NetMessage( join_finished_handle );
     return msg;
 }
 
@@ -230,7 +312,7 @@ NET_MESSAGE_STATIC_REGSITER(
 // UpdateConnectionState
 NetMessage* Compose_UpdateConnectionState( eConnectionState state )
 {
-    NetMessage* msg = new NetMessage( "update_connection_state" );
+    NetMessage* msg = new NetMessage( update_connection_state_handle );
     msg->Write( (uint8) state );
     return msg;
 }
@@ -252,7 +334,7 @@ NET_MESSAGE_STATIC_REGSITER(
 
 NetMessage* Compose_Hangup()
 {
-    NetMessage* msg = new NetMessage( "hangup" );
+    NetMessage* msg = new NetMessage( hangup_handle );
     return msg;
 }
 
@@ -263,6 +345,34 @@ NET_MESSAGE_STATIC_REGSITER(
     return NetSession::GetDefault()->ProcessHangup( netMessage );
 }
 
+//--------------------------------------------------------------------------------------
+// Fragment
+// [uint16 transferID][uint16 fragmentIdx][uint16 fragmentCount][bytes to the end]
+
+NetMessage* Compose_Fragment( uint16 transferID, uint16 fragmentIdx, uint16 fragmentCount,
+                              const Byte* data, size_t byteCount )
+{
+    NetMessage* msg = new NetMessage( fragment_handle );
+    FragmentHeader header;
+    header.m_transferID = transferID;
+    header.m_fragmentIdx = fragmentIdx;
+    header.m_fragmentCount = fragmentCount;
+    header.Pack( *msg );
+    msg->WriteBytes( byteCount, data );
+    return msg;
+}
+
+NET_MESSAGE_STATIC_REGSITER(
+    fragment, eNetMessageFlag::RELIABLE,
+    eNetCoreMessageIdx::NETMSG_FRAGMENT, 0 )
+{
+    FragmentHeader header;
+    if( !header.Unpack( *netMessage ) )
+        return false;
+    return NetSession::GetDefault()->ProcessFragment(
+        netMessage, header.m_transferID, header.m_fragmentIdx, header.m_fragmentCount );
+}
+
 
 
 
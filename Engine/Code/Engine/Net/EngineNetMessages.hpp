@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Net/NetCommonH.hpp"
+#include "Engine/Net/NetMessageDatabase.hpp"
 
 class NetSession;
 class NetMessage;
@@ -12,15 +13,20 @@ NetMessage* Compose_Ping( const string& str );
 NetMessage* Compose_Pong();
 NetMessage* Compose_Add( float a, float b );
 NetMessage* Compose_AddResponse( float a, float b, float sum );
+// reliable, byteCount of pattern the receiver checks, goes out in fragments
+// past MESSAGE_MTU
+NetMessage* Compose_LargeTest( size_t byteCount );
 NetMessage* Compose_Heartbeat( uint timeMS );
 
 NetMessage* Compose_JoinRequest();
 NetMessage* Compose_JoinDeny();
-NetMessage* Compose_JoinAccept( uint8 assignedConnectionIdx );
+NetMessage* Compose_JoinAccept( ConnectionIdx assignedConnectionIdx );
 NetMessage* Compose_NewConnection();
 NetMessage* Compose_JoinFinished();
 NetMessage* Compose_UpdateConnectionState(eConnectionState state);
 NetMessage* Compose_Hangup();
+NetMessage* Compose_Fragment( uint16 transferID, uint16 fragmentIdx, uint16 fragmentCount,
+                              const Byte* data, size_t byteCount );
 
 
 };
@@ -28,11 +34,18 @@ NetMessage* Compose_Hangup();
 
 //--------------------------------------------------------------------------------------
 // Self register using static magic
+// Registering defines the NetMessageHandle name_handle in the enclosing
+// namespace, compose with new NetMessage( name_handle ).
+// NET_MESSAGE_DECLARE makes it usable above the registration or in other files
+
+#define NET_MESSAGE_DECLARE( name )\
+extern const NetMessageHandle name ## _handle
 
 #define NET_MESSAGE_STATIC_REGSITER( name, flags, messageId, channelIdx )\
 bool Execute_ ## name ( NetMessage* netMessage );\
-static NetMessageSelfRegister name ## _self_register\
-    = NetMessageSelfRegister( #name, Execute_ ## name, flags, messageId, channelIdx );\
+NET_MESSAGE_DECLARE( name );\
+const NetMessageHandle name ## _handle = NetMessageSelfRegister(\
+    #name, Execute_ ## name, flags, messageId, channelIdx ).m_handle;\
 bool Execute_ ## name ( NetMessage* netMessage )
 
 #define NET_MESSAGE_STATIC_REGSITER_AUTO( name, flags ) \
@@ -48,5 +61,8 @@ public:
         eNetMessageFlag flags =  eNetMessageFlag::DEFAULT,
         uint8 messageId = NET_MESSAGE_ID_AUTO,
         uint8 channelIdx = 0 );
+
+public:
+    NetMessageHandle m_handle;
 };
 
@@ -0,0 +1,111 @@
+#include "Engine/Net/FragmentAssembler.hpp"
+#include "Engine/Net/NetMessage.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+
+#include <string.h>
+
+FragmentAssembler::~FragmentAssembler()
+{
+    Clear();
+}
+
+bool FragmentAssembler::Add( uint16 transferID, uint16 fragmentIdx, uint16 fragmentCount,
+                             const Byte* data, size_t byteCount, NetMessage*& out_message )
+{
+    out_message = nullptr;
+
+    bool isLast = fragmentIdx + 1 == fragmentCount;
+    if( fragmentCount == 0 || fragmentCount > FRAGMENT_MAX_COUNT
+        || fragmentIdx >= fragmentCount
+        || byteCount == 0 || byteCount > FRAGMENT_PAYLOAD_SIZE
+        || ( !isLast && byteCount != FRAGMENT_PAYLOAD_SIZE )
+        || fragmentIdx * FRAGMENT_PAYLOAD_SIZE + byteCount > FRAGMENT_MAX_MESSAGE_SIZE )
+    {
+        LOG_WARNING_TAG( "Net", "Bad fragment %u/%u of transfer %u, %u bytes",
+                         fragmentIdx, fragmentCount, transferID, (uint) byteCount );
+        return false;
+    }
+
+    Assembly* assembly = nullptr;
+    Assembly* freeAssembly = nullptr;
+    for( Assembly& candidate : m_assemblies )
+    {
+        if( candidate.m_message == nullptr )
+        {
+            if( freeAssembly == nullptr )
+                freeAssembly = &candidate;
+        }
+        else if( candidate.m_transferID == transferID )
+        {
+            assembly = &candidate;
+            break;
+        }
+    }
+
+    if( assembly == nullptr )
+    {
+        // it is marked processed either way, failing it would not get it resent
+        if( freeAssembly == nullptr )
+        {
+            LOG_WARNING_TAG( "Net", "No room to reassemble transfer %u, sender has more than %u in flight",
+                             transferID, (uint) FRAGMENT_MAX_ASSEMBLIES );
+            return true;
+        }
+        assembly = freeAssembly;
+        *assembly = Assembly();
+        assembly->m_message = new NetMessage();
+        size_t maxByteCount =
+            Min( fragmentCount * FRAGMENT_PAYLOAD_SIZE, FRAGMENT_MAX_MESSAGE_SIZE );
+        if( !assembly->m_message->MoveToHeap( maxByteCount ) )
+        {
+            delete assembly->m_message;
+            assembly->m_message = nullptr;
+            return false;
+        }
+        assembly->m_transferID = transferID;
+        assembly->m_fragmentCount = fragmentCount;
+    }
+
+    if( assembly->m_fragmentCount != fragmentCount )
+    {
+        LOG_WARNING_TAG( "Net", "Fragment count of transfer %u changed from %u to %u",
+                         transferID, assembly->m_fragmentCount, fragmentCount );
+        return false;
+    }
+    if( assembly->m_isReceived[fragmentIdx] )
+        return true;
+
+    size_t offset = fragmentIdx * FRAGMENT_PAYLOAD_SIZE;
+    memcpy( assembly->m_message->GetBuffer() + offset, data, byteCount );
+    assembly->m_isReceived[fragmentIdx] = true;
+    ++assembly->m_receivedCount;
+    assembly->m_byteCount = Max( assembly->m_byteCount, offset + byteCount );
+
+    if( assembly->m_receivedCount == assembly->m_fragmentCount )
+    {
+        out_message = assembly->m_message;
+        out_message->SetWriteHead( assembly->m_byteCount );
+        assembly->m_message = nullptr;
+    }
+    return true;
+}
+
+void FragmentAssembler::Clear()
+{
+    for( Assembly& assembly : m_assemblies )
+    {
+        delete assembly.m_message;
+        assembly.m_message = nullptr;
+    }
+}
+
+size_t FragmentAssembler::GetAssemblyCount() const
+{
+    size_t count = 0;
+    for( const Assembly& assembly : m_assemblies )
+    {
+        if( assembly.m_message )
+            ++count;
+    }
+    return count;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "Engine/Net/NetCommonH.hpp"
+
+// Puts reliables split by NetConnection::FillPacketWithFragments back
+// together. Fragments are reliable so each one arrives once, in any order.
+// Holds at most FRAGMENT_MAX_ASSEMBLIES messages of FRAGMENT_MAX_MESSAGE_SIZE,
+// the sender keeps no more transfers than that in flight
+class FragmentAssembler
+{
+public:
+    FragmentAssembler() {};
+    ~FragmentAssembler();
+
+    // false for a bad fragment. A fragment of a new transfer when every
+    // assembly is in use is dropped, only a sender past
+    // FRAGMENT_MAX_ASSEMBLIES transfers in flight gets there
+    // out_message is set to the whole message, header included, when this
+    // was its last fragment. The caller deletes it
+    bool Add( uint16 transferID, uint16 fragmentIdx, uint16 fragmentCount,
+              const Byte* data, size_t byteCount, NetMessage*& out_message );
+    void Clear();
+    size_t GetAssemblyCount() const;
+
+public:
+
+    struct Assembly
+    {
+        NetMessage* m_message = nullptr; // nullptr when the slot is free
+        uint16 m_transferID = 0;
+        uint16 m_fragmentCount = 0;
+        uint16 m_receivedCount = 0;
+        size_t m_byteCount = 0;
+        bool m_isReceived[FRAGMENT_MAX_COUNT] = {};
+    };
+
+    Assembly m_assemblies[FRAGMENT_MAX_ASSEMBLIES];
+};
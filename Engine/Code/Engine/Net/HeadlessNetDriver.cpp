@@ -0,0 +1,291 @@
+#include "Engine/Net/HeadlessNetDriver.hpp"
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/Net/Net.hpp"
+
+#include "Engine/Time/Time.hpp"
+#include "Engine/Time/Clock.hpp"
+#include "Engine/Thread/Thread.hpp"
+
+namespace
+{
+// the idle connections count down from here, nothing listens on these ports
+// so what they send is dropped
+constexpr uint IDLE_CONNECTION_TOP_PORT = 65535;
+
+// the connection Timers Flush popped every frame before the TimerWheel
+struct PolledConnectionTimes
+{
+    double m_nextSendTime = 0.0;
+    double m_nextHeartbeatTime = 0.0;
+};
+}
+
+HeadlessNetDriver::HeadlessNetDriver( NetSession* session )
+    : m_session( session )
+{
+}
+
+HeadlessNetDriver::~HeadlessNetDriver()
+{
+    ShutDown();
+}
+
+void HeadlessNetDriver::StartUp()
+{
+    Net::Startup();
+    m_isStarted = true;
+
+    if( Clock::GetRealTimeClock() == nullptr )
+    {
+        m_ownedRealTimeClock = new Clock();
+        Clock::SetRealTimeClock( m_ownedRealTimeClock );
+    }
+
+    if( m_session->m_packetChannel == nullptr )
+        m_session->Finalize();
+
+    m_lastFrameTime = TimeUtils::GetCurrentTimeSecondsD();
+    ResetStats();
+}
+
+void HeadlessNetDriver::ShutDown()
+{
+    if( !m_isStarted )
+        return;
+    m_isStarted = false;
+
+    m_session->Disconnect();
+    m_session = nullptr;
+
+    if( m_ownedRealTimeClock )
+    {
+        Clock::SetRealTimeClock( nullptr );
+        delete m_ownedRealTimeClock;
+        m_ownedRealTimeClock = nullptr;
+    }
+
+    Net::Shutdown();
+}
+
+void HeadlessNetDriver::RunFrame()
+{
+    double frameStartTime = TimeUtils::GetCurrentTimeSecondsD();
+    UpdateRealTimeClock();
+
+    m_session->Update();
+    m_session->Flush();
+
+    m_netSecondsSpent += TimeUtils::GetCurrentTimeSecondsD() - frameStartTime;
+    ++m_frameCount;
+    m_connectionFrameCount += m_session->m_connections.size();
+}
+
+void HeadlessNetDriver::RunFor( float seconds, float frameRate )
+{
+    float frameInterval = 1.f / frameRate;
+    double endTime = TimeUtils::GetCurrentTimeSecondsD() + seconds;
+    while( TimeUtils::GetCurrentTimeSecondsD() < endTime )
+    {
+        double frameStartTime = TimeUtils::GetCurrentTimeSecondsD();
+        RunFrame();
+        float frameTime =
+            (float) ( TimeUtils::GetCurrentTimeSecondsD() - frameStartTime );
+        if( frameTime < frameInterval )
+            Thread::SleepS( frameInterval - frameTime );
+    }
+}
+
+void HeadlessNetDriver::ResetStats()
+{
+    m_statsStartTime = TimeUtils::GetCurrentTimeSecondsD();
+    m_netSecondsSpent = 0.0;
+    m_frameCount = 0;
+    m_connectionFrameCount = 0;
+
+    PacketChannel* channel = m_session->m_packetChannel;
+    m_sentPacketsAtReset = channel->m_sentPacketCount;
+    m_sentBytesAtReset = channel->m_sentByteCount;
+    m_receivedPacketsAtReset = channel->m_receivedPacketCount;
+    m_receivedBytesAtReset = channel->m_receivedByteCount;
+    m_session->m_compressor->ResetStats();
+}
+
+string HeadlessNetDriver::GetStatsString() const
+{
+    PacketChannel* channel = m_session->m_packetChannel;
+    double elapsed = TimeUtils::GetCurrentTimeSecondsD() - m_statsStartTime;
+    if( elapsed <= 0.0 )
+        elapsed = 1.0;
+
+    double sentPackets = (double) ( channel->m_sentPacketCount - m_sentPacketsAtReset );
+    double sentBytes = (double) ( channel->m_sentByteCount - m_sentBytesAtReset );
+    double receivedPackets =
+        (double) ( channel->m_receivedPacketCount - m_receivedPacketsAtReset );
+    double receivedBytes =
+        (double) ( channel->m_receivedByteCount - m_receivedBytesAtReset );
+
+    float averageRTT = 0.f;
+    for( NetConnection* connection : m_session->m_connections )
+        averageRTT += connection->m_roundTripTime;
+    if( !m_session->m_connections.empty() )
+        averageRTT /= (float) m_session->m_connections.size();
+
+    double msPerFrame = m_frameCount == 0 ?
+        0.0 : m_netSecondsSpent * 1000.0 / (double) m_frameCount;
+    double usPerConnection = m_connectionFrameCount == 0 ?
+        0.0 : m_netSecondsSpent * 1000000.0 / (double) m_connectionFrameCount;
+
+    return Stringf(
+        "frames: %u  time: %0.2fs  connections: %u\n"
+        "  sent: %0.1f pkt/s %0.1f KB/s  received: %0.1f pkt/s %0.1f KB/s\n"
+        "  avg rtt: %0.2fms  net cost: %0.3fms/frame %0.2fus/connection\n"
+        "  %s",
+        (uint) m_frameCount, elapsed, (uint) m_session->m_connections.size(),
+        sentPackets / elapsed, sentBytes / elapsed / 1024.0,
+        receivedPackets / elapsed, receivedBytes / elapsed / 1024.0,
+        averageRTT * 1000.f, msPerFrame, usPerConnection,
+        m_session->m_compressor->GetStatsString().c_str() );
+}
+
+
+string HeadlessNetDriver::RunIdleConnectionBenchmark( size_t connectionCount,
+                                                      float seconds,
+                                                      float frameRate )
+{
+    NetSession& session = *m_session;
+    size_t frameCount = (size_t) ( seconds * frameRate );
+    if( !session.IsHost() )
+        return "needs a hosting session";
+    if( connectionCount == 0 || frameCount == 0 )
+        return "nothing to run";
+
+    // clients on my own ip that never answer, kept alive by RunTimedFrames
+    vector<NetConnection*> idleConnections;
+    NetAddress idleAddress = session.GetMyAddress();
+    for( size_t count = 0; count < connectionCount; ++count )
+    {
+        ConnectionIdx idx = session.GetAvailableConnectionIdx();
+        if( idx == INVALID_CONNECTION_INDEX )
+            break;
+        idleAddress.m_port = IDLE_CONNECTION_TOP_PORT - (uint) count;
+        NetConnection* connection = session.AddConnection( idx, idleAddress );
+        connection->m_timeOfLastReceive = TimeUtils::GetCurrentTimeSecondsF();
+        idleConnections.push_back( connection );
+    }
+
+    PacketChannel* channel = session.m_packetChannel;
+    // nothing acks, the rates would fall away through the run
+    bool wasCongestionControlEnabled = session.m_isCongestionControlEnabled;
+    session.SetCongestionControlEnabled( false );
+
+    // polled, what NetSession::Flush, NetConnection::FlushIfTimeUp and
+    // CheckForTimeoutConnections did for every connection every frame
+    for( NetConnection* connection : idleConnections )
+        connection->StopTimers();
+    vector<PolledConnectionTimes> polledTimes( idleConnections.size() );
+    size_t sentPacketsAtStart = channel->m_sentPacketCount;
+    double passStartTime = TimeUtils::GetCurrentTimeSecondsD();
+    double polledSeconds = RunTimedFrames( idleConnections, frameCount, frameRate, [&]()
+    {
+        double currentTime = TimeUtils::GetCurrentTimeSecondsD();
+        session.m_bandwidth.Refill( (float) currentTime );
+        for( size_t idx = 0; idx < idleConnections.size(); ++idx )
+        {
+            NetConnection* connection = idleConnections[idx];
+            PolledConnectionTimes& times = polledTimes[idx];
+            if( connection->IsClosed() )
+                continue;
+
+            connection->UpdateCongestion();
+            if( currentTime >= times.m_nextSendTime )
+            {
+                times.m_nextSendTime = currentTime + connection->GetEffectiveSendInterval();
+                if( currentTime >= times.m_nextHeartbeatTime )
+                {
+                    times.m_nextHeartbeatTime = currentTime + 1.0 / connection->m_heartbeatRate;
+                    uint time = (uint) ( Clock::GetRealTimeClock()->GetTimeSinceStartup() * 1000 );
+                    connection->QueueSend( EngineNetMessages::Compose_Heartbeat( time ) );
+                }
+                connection->Flush();
+            }
+            connection->SendConditionedPackets( (float) currentTime );
+            connection->m_stats.UpdateRates( (float) currentTime );
+        }
+        channel->FlushSends();
+
+        for( NetConnection* connection : idleConnections )
+            connection->DidTimeout();
+    } );
+    size_t polledPackets = channel->m_sentPacketCount - sentPacketsAtStart;
+    double polledPassSeconds = TimeUtils::GetCurrentTimeSecondsD() - passStartTime;
+
+    // timer wheel, the session's own Flush and timeout check
+    for( NetConnection* connection : idleConnections )
+        connection->StartTimers();
+    sentPacketsAtStart = channel->m_sentPacketCount;
+    passStartTime = TimeUtils::GetCurrentTimeSecondsD();
+    double wheelSeconds = RunTimedFrames( idleConnections, frameCount, frameRate, [&]()
+    {
+        session.Flush();
+        session.CheckForTimeoutConnections();
+    } );
+    size_t wheelPackets = channel->m_sentPacketCount - sentPacketsAtStart;
+    double wheelPassSeconds = TimeUtils::GetCurrentTimeSecondsD() - passStartTime;
+
+    for( NetConnection* connection : idleConnections )
+    {
+        session.RemoveBoundConnection( connection );
+        delete connection;
+    }
+    session.SetCongestionControlEnabled( wasCongestionControlEnabled );
+
+    double usPerFrame = 1000000.0 / (double) frameCount;
+    return Stringf(
+        "%u idle connections, %u frames a pass at %0.0fHz\n"
+        "  polled: %0.2fus/frame  %0.1f pkt/s\n"
+        "  timer wheel: %0.2fus/frame  %0.1f pkt/s  %0.1fx",
+        (uint) idleConnections.size(), (uint) frameCount, frameRate,
+        polledSeconds * usPerFrame, (double) polledPackets / polledPassSeconds,
+        wheelSeconds * usPerFrame, (double) wheelPackets / wheelPassSeconds,
+        wheelSeconds <= 0.0 ? 0.0 : polledSeconds / wheelSeconds );
+}
+
+void HeadlessNetDriver::UpdateRealTimeClock()
+{
+    double currentTime = TimeUtils::GetCurrentTimeSecondsD();
+    if( m_ownedRealTimeClock )
+        m_ownedRealTimeClock->Update( currentTime - m_lastFrameTime );
+    m_lastFrameTime = currentTime;
+}
+
+double HeadlessNetDriver::RunTimedFrames( const vector<NetConnection*>& idleConnections,
+                                          size_t frameCount, float frameRate,
+                                          const std::function<void()>& timedWork )
+{
+    double frameInterval = 1.0 / (double) frameRate;
+    double secondsSpent = 0.0;
+    double firstFrameTime = TimeUtils::GetCurrentTimeSecondsD();
+    for( size_t frame = 0; frame < frameCount; ++frame )
+    {
+        // SleepS is whole ms, the rest is yielded away. Late frames catch up
+        double frameTime = firstFrameTime + (double) frame * frameInterval;
+        double frameStartTime = TimeUtils::GetCurrentTimeSecondsD();
+        while( frameStartTime < frameTime )
+        {
+            if( frameTime - frameStartTime >= 0.001 )
+                Thread::SleepS( (float) ( frameTime - frameStartTime ) );
+            else
+                Thread::ThreadYield();
+            frameStartTime = TimeUtils::GetCurrentTimeSecondsD();
+        }
+        UpdateRealTimeClock();
+        // heartbeats coming back from the other end
+        for( NetConnection* connection : idleConnections )
+            connection->m_timeOfLastReceive = (float) frameStartTime;
+
+        double workStartTime = TimeUtils::GetCurrentTimeSecondsD();
+        timedWork();
+        secondsSpent += TimeUtils::GetCurrentTimeSecondsD() - workStartTime;
+    }
+    return secondsSpent;
+}
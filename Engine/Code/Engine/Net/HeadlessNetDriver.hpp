@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Net/NetCommonH.hpp"
+
+#include <functional>
+
+class Clock;
+
+// Runs a NetSession without App, Renderer or Window so the net stack can be
+// load tested from a bare main() on a bench box.
+// Creates the real time clock if nobody has set one yet
+class HeadlessNetDriver
+{
+public:
+    HeadlessNetDriver( NetSession* session );
+    ~HeadlessNetDriver();
+
+    // Net::Startup, real time clock and session Finalize, unless the app
+    // finalized the session already
+    void StartUp();
+    void ShutDown();
+
+    // one NetSession::Update and NetSession::Flush
+    void RunFrame();
+
+    // runs frames for the duration, sleeping between frames to hold frameRate
+    void RunFor( float seconds, float frameRate = MAX_SEND_RATE );
+
+    void ResetStats();
+    // packets/sec, bytes/sec, rtt and cost of Update + Flush per connection
+    string GetStatsString() const;
+
+    // Binds connectionCount idle connections to the hosting session and runs
+    // them for seconds twice. First polled every frame the way Flush and
+    // CheckForTimeoutConnections did before the TimerWheel, then through
+    // Flush and its due timers. Reports the cost per frame of both, a pass
+    // slower than frameRate takes longer than seconds.
+    // The polled pass only flushes the idle connections, so the session
+    // should have no others. Defaults to the net thread's frame rate
+    string RunIdleConnectionBenchmark( size_t connectionCount, float seconds,
+                                       float frameRate = 1000.f / NET_THREAD_SLEEP_MS );
+
+    void UpdateRealTimeClock();
+    // frameCount frames at frameRate, returns the seconds spent in timedWork.
+    // idleConnections hear from the other end every frame, outside the timing
+    double RunTimedFrames( const vector<NetConnection*>& idleConnections,
+                           size_t frameCount, float frameRate,
+                           const std::function<void()>& timedWork );
+
+public:
+
+    NetSession* m_session = nullptr;
+    Clock* m_ownedRealTimeClock = nullptr;
+    bool m_isStarted = false;
+    double m_lastFrameTime = 0.0;
+
+    // stats since last reset
+    double m_statsStartTime = 0.0;
+    double m_netSecondsSpent = 0.0;
+    size_t m_frameCount = 0;
+    size_t m_connectionFrameCount = 0; // sum of connection count over frames
+    size_t m_sentPacketsAtReset = 0;
+    size_t m_sentBytesAtReset = 0;
+    size_t m_receivedPacketsAtReset = 0;
+    size_t m_receivedBytesAtReset = 0;
+};
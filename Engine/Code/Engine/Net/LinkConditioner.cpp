@@ -0,0 +1,266 @@
+#include "Engine/Net/LinkConditioner.hpp"
+#include "Engine/Net/NetPacket.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+//--------------------------------------------------------------------------------------
+// LinkConditionerConfig
+
+bool LinkConditionerConfig::IsPassThrough() const
+{
+    return m_latency <= 0.f
+        && m_jitter <= 0.f
+        && m_lossGood <= 0.f
+        && ( m_lossBad <= 0.f || m_goodToBad <= 0.f )
+        && m_reorderChance <= 0.f
+        && m_duplicateChance <= 0.f
+        && m_bandwidth <= 0.f;
+}
+
+bool LinkConditionerConfig::SetParameter( const string& name, const string& value )
+{
+    if( name == "dist" )
+    {
+        if( value == "uniform" )
+            m_jitterDistribution = eJitterDistribution::UNIFORM;
+        else if( value == "normal" )
+            m_jitterDistribution = eJitterDistribution::NORMAL;
+        else if( value == "pareto" )
+            m_jitterDistribution = eJitterDistribution::PARETO;
+        else
+            return false;
+        return true;
+    }
+
+    float number;
+    if( SetFromString( value, number ) != PARSE_SUCCESS )
+        return false;
+
+    // delays are given in ms like net_sim_lag and ToString, kept in seconds
+    if( name == "latency" )
+        m_latency = Max( number, 0.f ) / 1000.f;
+    else if( name == "jitter" )
+        m_jitter = Max( number, 0.f ) / 1000.f;
+    else if( name == "loss" )
+        m_lossGood = Clampf01( number );
+    else if( name == "loss_bad" )
+        m_lossBad = Clampf01( number );
+    else if( name == "good_to_bad" )
+        m_goodToBad = Clampf01( number );
+    else if( name == "bad_to_good" )
+        m_badToGood = Clampf01( number );
+    else if( name == "reorder" )
+        m_reorderChance = Clampf01( number );
+    else if( name == "reorder_delay" )
+        m_reorderDelay = Max( number, 0.f ) / 1000.f;
+    else if( name == "dup" )
+        m_duplicateChance = Clampf01( number );
+    else if( name == "bandwidth" )
+        m_bandwidth = Max( number, 0.f );
+    else if( name == "queue" )
+        m_queueLimit = (size_t) Max( number, 0.f );
+    else if( name == "seed" )
+        m_seed = (uint) Max( number, 0.f );
+    else
+        return false;
+    return true;
+}
+
+string LinkConditionerConfig::ToString() const
+{
+    const char* distNames[] = { "uniform", "normal", "pareto" };
+    return Stringf(
+        "lat %.0fms +%.0fms %s  loss %.1f%%/%.1f%% (g>b %.2f b>g %.2f)  "
+        "reorder %.1f%% +%.0fms  dup %.1f%%  bw %.0fB/s q %uB  seed %u",
+        m_latency * 1000.f, m_jitter * 1000.f,
+        distNames[(int) m_jitterDistribution],
+        m_lossGood * 100.f, m_lossBad * 100.f, m_goodToBad, m_badToGood,
+        m_reorderChance * 100.f, m_reorderDelay * 1000.f,
+        m_duplicateChance * 100.f,
+        m_bandwidth, (uint) m_queueLimit, m_seed );
+}
+
+//--------------------------------------------------------------------------------------
+// LinkConditioner
+
+LinkConditioner::~LinkConditioner()
+{
+    Clear();
+}
+
+void LinkConditioner::SetConfig( const LinkConditionerConfig& config )
+{
+    m_config = config;
+#ifdef NET_LINK_CONDITIONER
+    m_isActive = !config.IsPassThrough();
+#else
+    m_isActive = false;
+#endif // NET_LINK_CONDITIONER
+
+    if( config.m_seed == 0 )
+        m_random.MakeNonDeterministic();
+    else
+        m_random.SetSeed( config.m_seed );
+    m_isInBadState = false;
+    m_wireFreeTime = 0.f;
+    m_lastInOrderDelivery = 0.f;
+}
+
+void LinkConditioner::Submit( NetPacket* packet, float currentTime )
+{
+    ++m_submittedCount;
+    if( RollLoss() )
+    {
+        ++m_lostCount;
+        delete packet;
+        return;
+    }
+
+    // wait for the packets ahead to be serialized onto the wire
+    float leaveTime = currentTime;
+    if( m_config.m_bandwidth > 0.f )
+    {
+        float byteCount = (float) packet->GetWrittenByteCount();
+        float waitingBytes = Max( m_wireFreeTime - currentTime, 0.f ) * m_config.m_bandwidth;
+        if( m_config.m_queueLimit != 0
+            && waitingBytes + byteCount > (float) m_config.m_queueLimit )
+        {
+            ++m_queueDropCount;
+            delete packet;
+            return;
+        }
+        m_wireFreeTime = Max( m_wireFreeTime, currentTime ) + byteCount / m_config.m_bandwidth;
+        leaveTime = m_wireFreeTime;
+    }
+
+    if( m_random.CheckChance( m_config.m_duplicateChance ) )
+    {
+        // the copy takes its own path so it gets its own delay
+        ++m_duplicatedCount;
+        Hold( new NetPacket( *packet ), leaveTime + RollDelay() );
+    }
+
+    float deliveryTime = leaveTime + RollDelay();
+    if( m_random.CheckChance( m_config.m_reorderChance ) )
+    {
+        ++m_reorderedCount;
+        deliveryTime += m_config.m_reorderDelay;
+    }
+    else
+    {
+        deliveryTime = Max( deliveryTime, m_lastInOrderDelivery );
+        m_lastInOrderDelivery = deliveryTime;
+    }
+    Hold( packet, deliveryTime );
+}
+
+NetPacket* LinkConditioner::PopReady( float currentTime )
+{
+    if( m_heldPackets.empty() )
+        return nullptr;
+
+    const HeldPacket& next = m_heldPackets.top();
+    if( next.m_deliveryTime > currentTime )
+        return nullptr;
+
+    NetPacket* packet = next.m_packet;
+    m_heldPackets.pop();
+    ++m_deliveredCount;
+    return packet;
+}
+
+void LinkConditioner::Clear()
+{
+    while( !m_heldPackets.empty() )
+    {
+        delete m_heldPackets.top().m_packet;
+        m_heldPackets.pop();
+    }
+}
+
+void LinkConditioner::ResetStats()
+{
+    m_submittedCount = 0;
+    m_lostCount = 0;
+    m_queueDropCount = 0;
+    m_duplicatedCount = 0;
+    m_reorderedCount = 0;
+    m_deliveredCount = 0;
+}
+
+string LinkConditioner::GetStatsString() const
+{
+    return Stringf(
+        "in %u  lost %u  queue drops %u  dups %u  reordered %u  out %u  held %u",
+        (uint) m_submittedCount, (uint) m_lostCount, (uint) m_queueDropCount,
+        (uint) m_duplicatedCount, (uint) m_reorderedCount,
+        (uint) m_deliveredCount, (uint) m_heldPackets.size() );
+}
+
+bool LinkConditioner::RollLoss()
+{
+    if( m_isInBadState )
+    {
+        if( m_random.CheckChance( m_config.m_badToGood ) )
+            m_isInBadState = false;
+    }
+    else if( m_random.CheckChance( m_config.m_goodToBad ) )
+    {
+        m_isInBadState = true;
+    }
+
+    float loss = m_isInBadState ? m_config.m_lossBad : m_config.m_lossGood;
+    return m_random.CheckChance( loss );
+}
+
+float LinkConditioner::RollDelay()
+{
+    float jitter = m_config.m_jitter;
+    if( jitter <= 0.f )
+        return m_config.m_latency;
+
+    float extra = 0.f;
+    switch( m_config.m_jitterDistribution )
+    {
+    case eJitterDistribution::UNIFORM:
+        extra = m_random.FloatInRange( 0.f, jitter );
+        break;
+    case eJitterDistribution::NORMAL:
+    {
+        // Box-Muller, folded so the delay never goes under latency
+        float u1 = Max( m_random.FloatZeroToOne(), EPSILON );
+        float u2 = m_random.FloatZeroToOne();
+        extra = jitter * fabsf( sqrtf( -2.f * logf( u1 ) ) * CosDeg( 360.f * u2 ) );
+        break;
+    }
+    case eJitterDistribution::PARETO:
+    {
+        // Lomax with shape 2, its mean is its scale so the mean extra is jitter
+        const float shape = 2.f;
+        float u = Max( 1.f - m_random.FloatZeroToOne(), EPSILON );
+        extra = jitter * ( powf( u, -1.f / shape ) - 1.f );
+        break;
+    }
+    default:
+        break;
+    }
+    return m_config.m_latency + extra;
+}
+
+void LinkConditioner::Hold( NetPacket* packet, float deliveryTime )
+{
+    HeldPacket held;
+    held.m_packet = packet;
+    held.m_deliveryTime = deliveryTime;
+    held.m_order = m_nextOrder++;
+    m_heldPackets.push( held );
+}
+
+bool LinkConditioner::LaterDelivery::operator()(
+    const HeldPacket& lhs, const HeldPacket& rhs ) const
+{
+    if( lhs.m_deliveryTime != rhs.m_deliveryTime )
+        return lhs.m_deliveryTime > rhs.m_deliveryTime;
+    // order wraps after 4 billion packets, compare cyclically
+    return (int) ( lhs.m_order - rhs.m_order ) > 0;
+}
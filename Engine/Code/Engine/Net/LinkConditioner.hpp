@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+#include "Engine/Math/Random.hpp"
+
+#include <queue>
+
+enum class eJitterDistribution : uint8
+{
+    UNIFORM = 0, // anywhere in [latency, latency + jitter]
+    NORMAL,      // latency + |normal| with jitter as the standard deviation
+    PARETO,      // long tail, most packets close to latency, a few far behind
+};
+
+// What one direction of a link does to packets, everything is off by default
+struct LinkConditionerConfig
+{
+    // Delay, seconds
+    float m_latency = 0.f;
+    float m_jitter = 0.f;
+    eJitterDistribution m_jitterDistribution = eJitterDistribution::UNIFORM;
+
+    // Loss, Gilbert-Elliott, the link is in a good or a bad state and may
+    // switch before every packet. With only m_lossGood set it is plain
+    // random loss
+    float m_lossGood = 0.f;  // loss chance in the good state
+    float m_lossBad = 0.f;   // loss chance in the bad state
+    float m_goodToBad = 0.f; // chance per packet of entering the bad state
+    float m_badToGood = 1.f; // chance per packet of leaving it
+
+    // Reorder, a reordered packet is held back this much longer
+    float m_reorderChance = 0.f;
+    float m_reorderDelay = 0.f; // seconds
+
+    float m_duplicateChance = 0.f;
+
+    // Bandwidth, packets wait for the ones before them to be on the wire,
+    // new packets are dropped when the queue is full
+    float m_bandwidth = 0.f; // bytes per second, 0 for no cap
+    size_t m_queueLimit = 0; // bytes waiting, 0 for no limit
+
+    uint m_seed = 0; // 0 picks one at random
+
+    bool IsPassThrough() const;
+    // for console commands, name is one of
+    // latency jitter dist loss loss_bad good_to_bad bad_to_good
+    // reorder reorder_delay dup bandwidth queue seed
+    // latency, jitter and reorder_delay are in ms, chances 0 to 1
+    bool SetParameter( const string& name, const string& value );
+    string ToString() const;
+};
+
+// Delays, drops, duplicates and reorders the packets going one way through
+// a link and owns them while they are held. Every roll comes from its own
+// seeded Random so a run can be repeated
+// Compiled to a pass through without NET_LINK_CONDITIONER
+class LinkConditioner
+{
+public:
+    LinkConditioner() {};
+    ~LinkConditioner();
+
+    void SetConfig( const LinkConditionerConfig& config );
+    const LinkConditionerConfig& GetConfig() const { return m_config; }
+    // when not active, callers skip Submit and use the packet directly
+    bool IsActive() const { return m_isActive; }
+
+    // takes ownership, the packet is dropped or held until it is due
+    void Submit( NetPacket* packet, float currentTime );
+    // next packet that is due, the caller takes ownership, nullptr if none
+    NetPacket* PopReady( float currentTime );
+    size_t GetHeldCount() const { return m_heldPackets.size(); }
+    // deletes everything held
+    void Clear();
+
+    void ResetStats();
+    string GetStatsString() const;
+
+private:
+    bool RollLoss();
+    float RollDelay();
+    void Hold( NetPacket* packet, float deliveryTime );
+
+    struct HeldPacket
+    {
+        NetPacket* m_packet = nullptr;
+        float m_deliveryTime = 0.f;
+        uint m_order = 0; // packets due at the same time leave in submit order
+    };
+
+    // puts the earliest delivery at the top of the queue
+    struct LaterDelivery
+    {
+        bool operator()( const HeldPacket& lhs, const HeldPacket& rhs ) const;
+    };
+
+public:
+
+    LinkConditionerConfig m_config;
+    bool m_isActive = false;
+    Random m_random;
+
+    bool m_isInBadState = false;
+    float m_wireFreeTime = 0.f; // when everything queued so far is on the wire
+    float m_lastInOrderDelivery = 0.f; // jitter alone does not reorder
+    uint m_nextOrder = 0;
+    std::priority_queue<HeldPacket, vector<HeldPacket>, LaterDelivery> m_heldPackets;
+
+    // Stats
+    size_t m_submittedCount = 0;
+    size_t m_lostCount = 0;
+    size_t m_queueDropCount = 0;
+    size_t m_duplicatedCount = 0;
+    size_t m_reorderedCount = 0;
+    size_t m_deliveredCount = 0;
+};
@@ -1,4 +1,5 @@
-﻿#include "Engine/Core/WindowsCommon.hpp"
+﻿#include "Engine/Net/NetPlatformCommon.hpp"
+#include "Engine/Net/NetPlatform.hpp"
 #include "Engine/Core/ErrorUtils.hpp"
 #include "Engine/String/StringUtils.hpp"
 #include "Engine/Log/Logger.hpp"
@@ -8,22 +9,16 @@
 #include "Engine/Thread/Thread.hpp"
 
 #include <atomic>
+#include <string.h>
 
 bool Net::Startup()
 {
-    WORD version = MAKEWORD( 2, 2 );
-    WSADATA data;
-
-    int error = WSAStartup( version, &data );
-
-    GUARANTEE_OR_DIE( error == 0, "WSAStartup failed" );
-    return error == 0;
-
+    return NetPlatform::Startup();
 }
 
 bool Net::Shutdown()
 {
-    ::WSACleanup();
+    NetPlatform::Shutdown();
     return true;
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 // winsock libraries
+#if defined( _MSC_VER )
 #pragma comment(lib, "ws2_32.lib")
+#endif
 
 #include "Engine/Core/EngineCommonH.hpp"
 
@@ -1,5 +1,7 @@
 #include "Engine/Net/NetAddress.hpp"
-#include "Engine/Core/WindowsCommon.hpp"
+#include "Engine/Net/NetPlatformCommon.hpp"
+#include <string.h>
+#include "Engine/Net/NetPlatform.hpp"
 #include "Engine/Core/ErrorUtils.hpp"
 #include "Engine/String/StringUtils.hpp"
 #include "Engine/Log/Logger.hpp"
@@ -63,10 +65,14 @@ vector<NetAddress> NetAddress::GetAllForHost(
     memset( &hints, 0, sizeof hints );
     hints.ai_family = AF_INET;
     hints.ai_socktype = SOCK_STREAM;
+    string hostName = addr;
     if( addr.empty() )
+    {
         hints.ai_flags = AI_PASSIVE;     // fill in my IP for me
+        hostName = NetPlatform::GetLocalHostName();
+    }
 
-    status = ::getaddrinfo( addr.c_str(), service.c_str(), &hints, &servinfo );
+    status = ::getaddrinfo( hostName.c_str(), service.c_str(), &hints, &servinfo );
     if( status != 0 )
     {
         LOG_WARNING_TAG( "Net",
@@ -126,14 +132,24 @@ bool NetAddress::operator!=( const NetAddress& compare ) const
     return !( *this == compare );
 }
 
+size_t NetAddressHash::operator()( const NetAddress& addr ) const
+{
+    uint64 key = ( (uint64) addr.m_ip4Address << 16 ) ^ (uint64) addr.m_port;
+    // 64 bit mix so nearby ports on one ip spread over the buckets
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t) key;
+}
+
 bool NetAddress::ToSockAddr( sockaddr *out, size_t *outAddrLen ) const
 {
     *outAddrLen = sizeof( sockaddr_in );
     memset( out, 0, *outAddrLen );
     out->sa_family = AF_INET;
     sockaddr_in *ipv4 = (sockaddr_in *) out;
-    ipv4->sin_addr.S_un.S_addr = m_ip4Address;
-    ipv4->sin_port = ::htons( (USHORT) m_port );
+    ipv4->sin_addr.s_addr = m_ip4Address;
+    ipv4->sin_port = htons( (uint16) m_port );
     return true;
 }
 
@@ -146,8 +162,8 @@ bool NetAddress::FromSockAddr( const sockaddr* addr )
     }
 
     sockaddr_in const *ipv4 = (sockaddr_in const*) addr;
-    uint ip = ipv4->sin_addr.S_un.S_addr;
-    uint port = ::ntohs( ipv4->sin_port );
+    uint ip = ipv4->sin_addr.s_addr;
+    uint port = ntohs( ipv4->sin_port );
 
     m_ip4Address = ip;
     m_port = port;
@@ -2,6 +2,7 @@
 
 #include "Engine/Net/NetCommonH.hpp"
 #include <vector>
+#include <climits>
 
 struct sockaddr_storage;
 struct sockaddr;
@@ -49,3 +50,9 @@ public:
     uint m_port = INVALID_PORT;
 
 };
+
+// for unordered containers keyed by address
+struct NetAddressHash
+{
+    size_t operator()( const NetAddress& addr ) const;
+};
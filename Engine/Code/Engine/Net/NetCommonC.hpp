@@ -17,3 +17,11 @@
 #include "Engine/Net/NetMessageDatabase.hpp"
 #include "Engine/Net/UDPSocket.hpp"
 #include "Engine/Net/NetConnectionInfo.hpp"
+#include "Engine/Net/NetPool.hpp"
+#include "Engine/Net/PacketCompressor.hpp"
+#include "Engine/Net/CongestionController.hpp"
+#include "Engine/Net/LinkConditioner.hpp"
+#include "Engine/Net/NetStats.hpp"
+#include "Engine/Net/PacketCapture.hpp"
+#include "Engine/Net/PacketReplay.hpp"
+#include "Engine/Net/FragmentAssembler.hpp"
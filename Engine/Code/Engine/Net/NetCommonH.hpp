@@ -2,15 +2,17 @@
 
 #include "Engine/Core/EngineCommonH.hpp"
 
-#define SIM_NET_LOSS
-#define SIM_NET_LATENCY
+// lets LinkConditioner simulate bad links, see NetSession::SetLinkConditioner
+#define NET_LINK_CONDITIONER
 
 typedef uint8 MessageID;
 typedef uint16 ReliableID;
 typedef uint16 SequenceID;
+typedef uint16 ConnectionIdx;
 
 // General
 constexpr uint GAME_PORT = 10084;
+constexpr uint CLIENT_PORT_RANGE = 16; // ports from the host's a client tries to bind
 constexpr uint ETHERNET_MTU = 1500;  // maximum transmission unit - determined by hardware part of OSI model.;
 // 1500 is the MTU of EthernetV2, and is the minimum one - so we use it;
 constexpr uint PACKET_MTU = ( ETHERNET_MTU - 40 - 8 );
@@ -18,29 +20,72 @@ constexpr uint MESSAGE_MTU = 1024; // arbitrary;
 constexpr uint INVALID_PORT = (uint) ( ~0 );
 constexpr uint INVALID_IPV4_ADDR = (uint) ( ~0 );
 constexpr uint8 MAX_MESSAGES_PER_PACKET = (uint8) ( ~0 );
+constexpr size_t PACKET_BATCH_SIZE = 64; // datagrams per batched send/receive
+constexpr size_t NET_THREAD_QUEUE_SIZE = 4096; // messages each way, power of two
+constexpr int NET_THREAD_SLEEP_MS = 1; // between net thread updates
 
 // Packet
 constexpr uint16 INVALID_PACKET_ACK = (uint16) ( ~0 );
 constexpr bool VALIDATE_PACKET = true;
 constexpr bool LOG_PACKET_BYTES = false;
 constexpr size_t PACKET_TRACKER_COUNT = 100; // 5 seconds of history
+constexpr uint8 PACKET_FLAG_COMPRESSED = BIT_FLAG( 0 );
+
+// Compression
+constexpr size_t COMPRESSION_DICTIONARY_MAX_SIZE = 2048;
+constexpr size_t COMPRESSION_TRAINING_SAMPLE_COUNT = 256; // packets kept for training
+
+// Capture
+constexpr uint PACKET_CAPTURE_MAGIC = 0x5041434E; // "NCAP"
+constexpr uint16 PACKET_CAPTURE_VERSION = 3; // 2 widened the connection index, 3 added fragments
+constexpr size_t PACKET_CAPTURE_FLUSH_SIZE = 64 * 1024; // bytes buffered before a write
+
+// Timer wheel, see TimerWheel
+constexpr double TIMER_WHEEL_TICK = 0.001; // Seconds
+constexpr uint TIMER_WHEEL_SLOT_BITS = 6;
+constexpr uint TIMER_WHEEL_SLOT_COUNT = 1 << TIMER_WHEEL_SLOT_BITS;
+constexpr uint TIMER_WHEEL_LEVEL_COUNT = 4; // covers 2^24 ticks, about 4.6 hours
 
 // Message
 constexpr MessageID NET_MESSAGE_ID_INVALID = (MessageID) ( ~0 );
 constexpr MessageID NET_MESSAGE_ID_AUTO = (MessageID) ( ~0 );
 constexpr size_t MAX_MESSAGE_CHANNELS = 8;
+constexpr size_t MESSAGE_ID_COUNT = (size_t) 1 << ( sizeof( MessageID ) * 8 );
+
+// Fragmentation, reliables written past MESSAGE_MTU go out in fragments
+constexpr size_t FRAGMENT_PAYLOAD_SIZE = 1000; // bytes of the large message per fragment
+constexpr size_t FRAGMENT_MAX_MESSAGE_SIZE = 64 * 1024; // writes past this fail
+constexpr size_t FRAGMENT_MAX_COUNT =
+    ( FRAGMENT_MAX_MESSAGE_SIZE + FRAGMENT_PAYLOAD_SIZE - 1 ) / FRAGMENT_PAYLOAD_SIZE;
+constexpr size_t FRAGMENT_MAX_ASSEMBLIES = 4; // messages being reassembled per connection
 
 
 // Connection
-constexpr uint8 INVALID_CONNECTION_INDEX = (uint8) ( ~0 );
+constexpr ConnectionIdx INVALID_CONNECTION_INDEX = (ConnectionIdx) ( ~0 );
 constexpr size_t MAX_CONNECTION_ID_LENGTH = 16;
-constexpr size_t MAX_CONNECTION_COUNT = INVALID_CONNECTION_INDEX - 1;
+constexpr size_t MAX_CONNECTION_COUNT = 4096; // slots are allocated up front
 
 // Send rate
 #define DEFAULT_SESSION_SEND_RATE (20) // Hz
 #define MAX_SEND_RATE (200) // Hz
 #define DEFAULT_HEARTBEAT_RATE (20) // Hz
 
+// Congestion control
+#define CONGESTION_UPDATE_INTERVAL (0.25f) // Seconds
+#define CONGESTION_MIN_RTT_WINDOW (10.f) // Seconds, lowest rtt is relearned this often
+#define CONGESTION_MIN_SAMPLES (4) // packet outcomes needed to call an interval lossy
+#define CONGESTION_LOSS_THRESHOLD (0.05f) // [0,1]
+#define CONGESTION_RTT_RISE (1.5f) // rtt above lowest * this means queues are filling
+#define CONGESTION_RTT_SLACK (0.02f) // Seconds, so jitter on fast links is not congestion
+#define CONGESTION_BACKOFF (0.7f) // multiplies rate and budget
+#define CONGESTION_PROBE_RATE_STEP (1.f) // Hz per update
+#define CONGESTION_PROBE_BUDGET_STEP ((size_t) 64) // bytes per update
+#define CONGESTION_MIN_SEND_RATE (5.f) // Hz
+#define CONGESTION_MIN_PACKET_BUDGET (256) // bytes
+#define CONGESTION_LOSS_TIMEOUT_RTT (2.f) // unacked for this many round trips is lost
+#define CONGESTION_MIN_LOSS_TIMEOUT (0.25f) // Seconds
+#define BANDWIDTH_BURST_SECONDS (0.1f) // unused bandwidth kept for bursts
+
 // Reliable
 #define RELIABLE_RESEND_WAIT_MULTIPLIER (1.2f) // This is multiplied with the RTT
 #define RELIABLE_RESEND_WAIT_MIN (0.03f) // Seconds
@@ -48,6 +93,8 @@ constexpr size_t MAX_CONNECTION_COUNT = INVALID_CONNECTION_INDEX - 1;
 #define RELIABLE_RESEND_WAIT_FIXED (0.1f) // Seconds
 #define MAX_RELIABLES_PER_PACKET (32)
 #define RELIABLE_WINDOW (64)
+#define FRAGMENT_WINDOW (RELIABLE_WINDOW / 2) // fragments in flight, the rest is for small reliables
+#define IN_ORDER_WINDOW (RELIABLE_WINDOW) // early in order messages buffered per channel
 #define JOIN_REQUEST_RESEND_TIME (0.1f) // Seconds
 #define JOIN_TIMEOUT (5.f) // Seconds
 
@@ -58,6 +105,11 @@ constexpr size_t MAX_CONNECTION_COUNT = INVALID_CONNECTION_INDEX - 1;
 #define MAX_NET_TIME_DILATION (0.1f)
 #define DESIRED_CLIENT_TIME_INERTIA (0.8f) // [0,1] higher values mean changes slower
 
+// Stats
+#define NET_STATS_RATE_INTERVAL (1.f) // Seconds, per second rates are averaged over this
+constexpr uint RTT_HISTOGRAM_BUCKET_COUNT = 16;
+#define RTT_HISTOGRAM_BUCKET_SIZE (0.02f) // Seconds
+
 
 class NetMessage;
 typedef bool( *NetMessageCB )( NetMessage* netMessage );
@@ -72,6 +124,15 @@ class NetMessageDefinition;
 class NetMessageChannel;
 class PacketChannel;
 class PacketTracker;
+class PacketCompressor;
+class CongestionController;
+class LinkConditioner;
+struct LinkConditionerConfig;
+class NetStats;
+class PacketCapture;
+class PacketReplay;
+class FragmentAssembler;
+struct NetConnectionStats;
 class NetSession;
 
 
@@ -101,6 +162,7 @@ enum eNetCoreMessageIdx : uint8_t
     NETMSG_JOIN_FINISHED, // reliable in-order
     NETMSG_UPDATE_CONNECTION_STATE, // reliable in-order
     NETMSG_HANGUP, // unreliable
+    NETMSG_FRAGMENT, // reliable, a piece of a message past MESSAGE_MTU
 
 
     NET_CORE_COUNT,
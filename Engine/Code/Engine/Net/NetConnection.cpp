@@ -2,14 +2,21 @@
 #include "Engine/Net/NetCommonC.hpp"
 
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Time/Timer.hpp"
 #include "Engine/Time/Clock.hpp"
 #include "Engine/Time/Time.hpp"
 
 NetConnection::NetConnection()
 {
-    m_sendTimer = new Timer( Clock::GetRealTimeClock(), 1.f / m_sendRate );
-    m_heartbeatTimer = new Timer( Clock::GetRealTimeClock(), 1.f / m_heartbeatRate );
+    TimerWheelEntry* timers[] = { &m_flushTimer, &m_heartbeatTimer, &m_resendTimer,
+                                  &m_updateTimer, &m_timeoutTimer };
+    eConnectionTimer types[] = { eConnectionTimer::FLUSH, eConnectionTimer::HEARTBEAT,
+                                 eConnectionTimer::RESEND, eConnectionTimer::UPDATE,
+                                 eConnectionTimer::TIMEOUT };
+    for( size_t idx = 0; idx < 5; ++idx )
+    {
+        timers[idx]->m_owner = this;
+        timers[idx]->m_type = (uint) types[idx];
+    }
 
     m_packetTrackers.resize( PACKET_TRACKER_COUNT );
     for( auto& packetTracker : m_packetTrackers )
@@ -31,14 +38,14 @@ NetConnection::~NetConnection()
 {
     if( IsHost() )
         m_owningSession->ShouldDisconnect();
+    StopTimers();
 
     ContainerUtils::DeletePointers( m_packetTrackers );
-    ContainerUtils::DeletePointers( m_unconfirmedReliables );
+    for( NetMessage* msg : m_unconfirmedReliables )
+        delete msg;
     ContainerUtils::DeletePointersQueue( m_unsentUnreliables );
     ContainerUtils::DeletePointersQueue( m_unsentReliables );
-
-    delete m_heartbeatTimer;
-    delete m_sendTimer;
+    ContainerUtils::DeletePointersQueue( m_unsentLargeReliables );
 
     for( int i = 0; i < MAX_MESSAGE_CHANNELS; ++i )
     {
@@ -46,33 +53,32 @@ NetConnection::~NetConnection()
     }
 }
 
-void NetConnection::FlushIfTimeUp()
-{
-    if( !PopSendTimer() )
-        return;
-
-    Flush();
-}
-
 void NetConnection::Flush()
 {
-
-    if( PopHeartbeatTimer() )
-    {
-        uint time = 0;
-        if( m_owningSession->IsHost() )
-            time = (uint) ( Clock::GetRealTimeClock()->GetTimeSinceStartup() * 1000 );
-        QueueSend( EngineNetMessages::Compose_Heartbeat( time ) );
-    }
+    m_lastFlushTime = TimeUtils::GetCurrentTimeSecondsD();
 
     NetPacket packet;
     packet.m_receiverIdx = m_idxInSession;
     packet.m_receiverAddress = this->m_address;
     if( !m_unsentUnreliables.empty()
-        || !m_unconfirmedReliables.empty()
+        || m_unconfirmedReliableCount != 0
         || !m_unsentReliables.empty()
+        || !m_unsentLargeReliables.empty()
         || m_shouldForceSend )
     {
+        m_bandwidth.Refill( TimeUtils::GetCurrentTimeSecondsF() );
+        if( !CanSendWithinBandwidth() )
+        {
+            // over the cap, unreliables are stale by the next send
+            ClearUnreliables();
+            if( HasPendingSend() )
+                ArmFlush();
+            // unconfirmed reliables still need their resend to come back here
+            ArmResend();
+            return;
+        }
+
+        packet.m_byteBudget = m_congestion.GetPacketBudget();
         packet.SetWriteHead( sizeof( PacketHeader ) );
         PacketHeader& header = packet.m_header;
         header.m_senderConnectionIdx = m_owningSession->GetMyConnectionIdx();
@@ -83,6 +89,7 @@ void NetConnection::Flush()
 
         FillPacketWithUnconfirmedReliables( packet );
         FillPacketWithUnsentReliables( packet );
+        FillPacketWithFragments( packet );
         FillPacketWithUnsentUnreliables( packet );
         ClearUnreliables();
 
@@ -98,9 +105,17 @@ void NetConnection::Flush()
         }
 
         packet.PackHeader();
-        SendImmediate( packet );
+        m_stats.SampleReliableQueueDepth( m_unconfirmedReliableCount + m_unsentReliables.size() );
+        SendPacket( packet );
+        m_bandwidth.Spend( packet.GetWrittenByteCount() );
+        m_owningSession->m_bandwidth.Spend( packet.GetWrittenByteCount() );
         m_shouldForceSend = false;
     }
+
+    // reliables past the window or a full packet go next time
+    if( HasPendingSend() )
+        ArmFlush();
+    ArmResend();
 }
 
 bool NetConnection::OnReceivePacket( NetPacket& packet, bool processSuccess )
@@ -108,6 +123,7 @@ bool NetConnection::OnReceivePacket( NetPacket& packet, bool processSuccess )
     UNUSED( processSuccess );
 
     m_timeOfLastReceive = TimeUtils::GetCurrentTimeSecondsF();
+    m_stats.RecordPacketReceived( packet.GetWrittenByteCount() );
 
     PacketHeader& header = packet.m_header;
 
@@ -121,6 +137,8 @@ bool NetConnection::OnReceivePacket( NetPacket& packet, bool processSuccess )
         ConfirmPacketsReceivedByOther( header.m_lastReceivedAck, header.m_receivedAckBitfield );
     }
 
+    if( m_shouldForceSend )
+        ArmFlush();
     return true;
 }
 
@@ -129,29 +147,69 @@ void NetConnection::QueueSend( NetMessage* netMsg )
     auto def = netMsg->m_def;
     if( def == nullptr )
     {
-        LOG_ERROR_TAG( "Net", "Could not send message, no definition for %s",
-                       netMsg->m_name.c_str() );
+        LOG_ERROR_TAG( "Net", "Could not send message, no definition for id [%u]",
+                       netMsg->m_id );
+        delete netMsg;
         return;
     }
 
+    // never leaves the process, no sequence, acks or packets
+    if( IsMe() )
+    {
+        m_owningSession->QueueLoopback( netMsg );
+        return;
+    }
+
+    NetMessageChannel* channel = nullptr;
     if( def->IsInOrder() )
     {
-        NetMessageChannel* channel = m_messageChannels[def->GetChannelIdx()];
+        channel = m_messageChannels[def->GetChannelIdx()];
         netMsg->m_sequenceID = channel->m_nextSequenceIDToSend;
         ++( channel->m_nextSequenceIDToSend );
     }
 
-    if( def->IsReliable() )
+    // only reliables grow past MESSAGE_MTU, the header goes in fragment 0
+    if( netMsg->IsLarge() )
+    {
+        netMsg->PackHeader();
+        m_unsentLargeReliables.push( netMsg );
+        if( channel )
+            ++channel->m_largeQueueCount;
+    }
+    // sent after the large ones ahead of it on the channel, arriving too far
+    // ahead of them would drop it
+    else if( channel && channel->m_largeQueueCount != 0 )
+    {
+        m_unsentLargeReliables.push( netMsg );
+        ++channel->m_largeQueueCount;
+    }
+    else if( def->IsReliable() )
         m_unsentReliables.push( netMsg );
     else
         m_unsentUnreliables.push( netMsg );
+    ArmFlush();
 }
 
-void NetConnection::SendImmediate( const NetPacket& packet )
+void NetConnection::SendPacket( const NetPacket& packet )
 {
     m_timeOfLastSend = TimeUtils::GetCurrentTimeSecondsF();
+    m_stats.RecordPacketSent( packet.GetWrittenByteCount() );
 
-    m_owningSession->SendImmediate( packet );
+    if( m_sendConditioner.IsActive() )
+        m_sendConditioner.Submit( new NetPacket( packet ), m_timeOfLastSend );
+    else
+        m_owningSession->QueuePacket( packet );
+}
+
+void NetConnection::SendConditionedPackets( float currentTime )
+{
+    NetPacket* packet = m_sendConditioner.PopReady( currentTime );
+    while( packet )
+    {
+        m_owningSession->QueuePacket( *packet );
+        delete packet;
+        packet = m_sendConditioner.PopReady( currentTime );
+    }
 }
 
 void NetConnection::Close()
@@ -169,8 +227,11 @@ void NetConnection::FillPacketWithUnsentUnreliables( NetPacket& packet )
     while( !m_unsentUnreliables.empty() )
     {
         NetMessage* msg = m_unsentUnreliables.front();
+        size_t byteCountBefore = packet.GetWrittenByteCount();
         if( packet.WriteMessage( *msg ) )
         {
+            m_owningSession->m_stats.RecordSend(
+                msg->m_id, packet.GetWrittenByteCount() - byteCountBefore, false );
             delete msg;
             m_unsentUnreliables.pop();
         }
@@ -185,53 +246,133 @@ void NetConnection::FillPacketWithUnsentUnreliables( NetPacket& packet )
 void NetConnection::FillPacketWithUnconfirmedReliables( NetPacket& packet )
 {
     float currentTime = TimeUtils::GetCurrentTimeSecondsF();
-    for( auto& msg : m_unconfirmedReliables )
+    float resendWait = GetReliableResendWait();
+    while( !m_resendQueue.empty() )
     {
-        if( currentTime - msg->m_lastSentTime > GetReliableResendWait() )
+        uint16 reliableID = m_resendQueue.front();
+        NetMessage* msg = GetUnconfirmedReliable( reliableID );
+        // confirmed since it was last sent
+        if( msg == nullptr )
         {
-            if( packet.WriteMessage( *msg ) )
-            {
-                msg->m_lastSentTime = currentTime;
-
-                GetCurrentPacketTracker()->AddReliable( msg->m_reliableID );
-                LOG_INFO_TAG( "Debug", "resend msg %s", msg->m_def->GetName().c_str() );
-            }
-            else
-            {
-                return;
-            }
+            m_resendQueue.pop();
+            continue;
         }
+
+        // queue is in send order, nothing behind this is due either
+        if( currentTime - msg->m_lastSentTime <= resendWait )
+            return;
+
+        size_t byteCountBefore = packet.GetWrittenByteCount();
+        if( !packet.WriteMessage( *msg ) )
+            return;
+        m_owningSession->m_stats.RecordSend(
+            msg->m_id, packet.GetWrittenByteCount() - byteCountBefore, true );
+
+        msg->m_lastSentTime = currentTime;
+        m_resendQueue.pop();
+        m_resendQueue.push( reliableID );
+
+        GetCurrentPacketTracker()->AddReliable( msg->m_reliableID );
+        LOG_INFO_TAG( "Debug", "resend msg %s", msg->m_def->GetName().c_str() );
     }
 }
 
 void NetConnection::FillPacketWithUnsentReliables( NetPacket& packet )
 {
-    float currentTime = TimeUtils::GetCurrentTimeSecondsF();
     while( !m_unsentReliables.empty() )
     {
         // reached window limit
         if( !CanSendNewReliable() )
             return;
-        NetMessage* msg = m_unsentReliables.front();
-        msg->m_reliableID = m_nextReliableID;
-        msg->m_lastSentTime = currentTime;
+        // packet is full
+        if( !WriteNewReliable( packet, m_unsentReliables.front() ) )
+            return;
+        m_unsentReliables.pop();
+    }
+}
 
-        if( packet.WriteMessage( *msg ) )
-        {
-            ++m_nextReliableID;
-            m_unconfirmedReliables.push_back( msg );
-            m_unsentReliables.pop();
+void NetConnection::FillPacketWithFragments( NetPacket& packet )
+{
+    while( !m_unsentLargeReliables.empty() )
+    {
+        if( !CanSendNewReliable() )
+            return;
 
-            GetCurrentPacketTracker()->AddReliable( msg->m_reliableID );
+        NetMessage* large = m_unsentLargeReliables.front();
+        // in order one held behind a large one, goes whole
+        if( !large->IsLarge() )
+        {
+            if( !WriteNewReliable( packet, large ) )
+                return;
+            m_unsentLargeReliables.pop();
+            OnLargeQueuePopped( large );
+            continue;
         }
+
+        // a large message never holds the whole window
+        if( m_fragmentsInFlight >= FRAGMENT_WINDOW )
+            return;
+        // a new transfer waits for room to reassemble it
+        uint16 transfersInFlight = m_nextTransferID - m_oldestUnconfirmedTransferID;
+        if( m_nextFragmentIdx == 0 && transfersInFlight >= FRAGMENT_MAX_ASSEMBLIES )
+            return;
+
+        size_t byteCount = large->GetWrittenByteCount();
+        uint16 fragmentCount =
+            (uint16) ( ( byteCount + FRAGMENT_PAYLOAD_SIZE - 1 ) / FRAGMENT_PAYLOAD_SIZE );
+        size_t offset = m_nextFragmentIdx * FRAGMENT_PAYLOAD_SIZE;
+        NetMessage* fragment = EngineNetMessages::Compose_Fragment(
+            m_nextTransferID, m_nextFragmentIdx, fragmentCount,
+            large->GetBuffer() + offset, Min( FRAGMENT_PAYLOAD_SIZE, byteCount - offset ) );
+
         // packet is full
-        else
+        if( !WriteNewReliable( packet, fragment ) )
         {
+            delete fragment;
             return;
         }
+        ++m_fragmentsInFlight;
+        m_fragmentTransferIDs[fragment->m_reliableID % RELIABLE_WINDOW] = m_nextTransferID;
+        ++m_unconfirmedFragmentCounts[m_nextTransferID % FRAGMENT_MAX_ASSEMBLIES];
+        ++m_nextFragmentIdx;
+
+        if( m_nextFragmentIdx == fragmentCount )
+        {
+            OnLargeQueuePopped( large );
+            delete large;
+            m_unsentLargeReliables.pop();
+            m_nextFragmentIdx = 0;
+            ++m_nextTransferID;
+        }
     }
 }
 
+void NetConnection::OnLargeQueuePopped( NetMessage* msg )
+{
+    if( msg->m_def->IsInOrder() )
+        --m_messageChannels[msg->m_def->GetChannelIdx()]->m_largeQueueCount;
+}
+
+bool NetConnection::WriteNewReliable( NetPacket& packet, NetMessage* msg )
+{
+    msg->m_reliableID = m_nextReliableID;
+    msg->m_lastSentTime = TimeUtils::GetCurrentTimeSecondsF();
+
+    size_t byteCountBefore = packet.GetWrittenByteCount();
+    if( !packet.WriteMessage( *msg ) )
+        return false;
+
+    m_owningSession->m_stats.RecordSend(
+        msg->m_id, packet.GetWrittenByteCount() - byteCountBefore, false );
+    ++m_nextReliableID;
+    m_unconfirmedReliables[msg->m_reliableID % RELIABLE_WINDOW] = msg;
+    ++m_unconfirmedReliableCount;
+    m_resendQueue.push( msg->m_reliableID );
+
+    GetCurrentPacketTracker()->AddReliable( msg->m_reliableID );
+    return true;
+}
+
 void NetConnection::ClearUnreliables()
 {
     while( !m_unsentUnreliables.empty() )
@@ -248,33 +389,135 @@ void NetConnection::SetSendRate( float hz )
 
 float NetConnection::GetEffectiveSendInterval() const
 {
-    return 1.f / Min( m_sendRate, m_owningSession->m_sendRate );
+    return 1.f / Min( GetMaxSendRate(), m_congestion.GetSendRate() );
 }
 
-bool NetConnection::PopSendTimer()
+float NetConnection::GetMaxSendRate() const
 {
-    if( GetEffectiveSendInterval() != m_sendTimer->m_lapTime )
-        m_sendTimer->SetLapTime( GetEffectiveSendInterval() );
+    return Min( m_sendRate, m_owningSession->m_sendRate );
+}
+
+void NetConnection::StartTimers()
+{
+    m_hasTimers = true;
+    double currentTime = TimeUtils::GetCurrentTimeSecondsD();
+    TimerWheel& wheel = m_owningSession->m_timerWheel;
+    wheel.Schedule( m_heartbeatTimer, currentTime + 1.0 / m_heartbeatRate );
+    wheel.Schedule( m_updateTimer, currentTime + CONGESTION_UPDATE_INTERVAL );
+    ArmTimeout();
+    if( HasPendingSend() )
+        ArmFlush();
+    ArmResend();
+}
+
+void NetConnection::StopTimers()
+{
+    if( !m_hasTimers || m_owningSession == nullptr )
+        return;
+    m_hasTimers = false;
+    TimerWheel& wheel = m_owningSession->m_timerWheel;
+    wheel.Cancel( m_flushTimer );
+    wheel.Cancel( m_heartbeatTimer );
+    wheel.Cancel( m_resendTimer );
+    wheel.Cancel( m_updateTimer );
+    wheel.Cancel( m_timeoutTimer );
+}
 
-    if( m_sendTimer->PopOneLap() )
+void NetConnection::OnTimer( eConnectionTimer type, double currentTime )
+{
+    TimerWheel& wheel = m_owningSession->m_timerWheel;
+    switch( type )
     {
-        m_sendTimer->Reset();
-        return true;
+    case eConnectionTimer::FLUSH:
+        if( !IsClosed() )
+            Flush();
+        break;
+    case eConnectionTimer::HEARTBEAT:
+    {
+        // closed connections do not flush, nothing should pile up on them
+        if( !IsClosed() )
+        {
+            uint time = 0;
+            if( m_owningSession->IsHost() )
+                time = (uint) ( Clock::GetRealTimeClock()->GetTimeSinceStartup() * 1000 );
+            QueueSend( EngineNetMessages::Compose_Heartbeat( time ) );
+        }
+        wheel.Schedule( m_heartbeatTimer, currentTime + 1.0 / m_heartbeatRate );
+        break;
+    }
+    case eConnectionTimer::RESEND:
+        ArmFlush();
+        break;
+    case eConnectionTimer::UPDATE:
+        UpdateCongestion();
+        m_stats.UpdateRates( (float) currentTime );
+        wheel.Schedule( m_updateTimer, currentTime + CONGESTION_UPDATE_INTERVAL );
+        break;
+    case eConnectionTimer::TIMEOUT:
+        // received since it was scheduled
+        if( m_timeOfLastReceive + DEFAULT_CONNECTION_TIMEOUT >= (float) currentTime )
+            ArmTimeout();
+        else
+            m_owningSession->m_timedOutConnectionIdxs.push_back( m_idxInSession );
+        break;
+    default:
+        break;
     }
-    return false;
 }
 
-bool NetConnection::PopHeartbeatTimer()
+void NetConnection::ArmFlush()
 {
-    if( 1.f / m_heartbeatRate != m_heartbeatTimer->m_lapTime )
-        m_heartbeatTimer->SetLapTime( 1.f / m_heartbeatRate );
+    if( !m_hasTimers || m_flushTimer.IsScheduled() )
+        return;
+    double dueTime = Max( TimeUtils::GetCurrentTimeSecondsD(),
+                          m_lastFlushTime + GetEffectiveSendInterval() );
+    m_owningSession->m_timerWheel.Schedule( m_flushTimer, dueTime );
+}
+
+void NetConnection::ArmResend()
+{
+    if( !m_hasTimers )
+        return;
 
-    if( m_heartbeatTimer->PopOneLap() )
+    // confirmed ones are dropped here the same as when filling a packet
+    while( !m_resendQueue.empty() )
     {
-        m_heartbeatTimer->Reset();
-        return true;
+        NetMessage* msg = GetUnconfirmedReliable( m_resendQueue.front() );
+        if( msg )
+        {
+            double dueTime = (double) msg->m_lastSentTime + GetReliableResendWait();
+            m_owningSession->m_timerWheel.Schedule( m_resendTimer, dueTime );
+            return;
+        }
+        m_resendQueue.pop();
     }
-    return false;
+    m_owningSession->m_timerWheel.Cancel( m_resendTimer );
+}
+
+void NetConnection::ArmTimeout()
+{
+    if( !m_hasTimers )
+        return;
+    double dueTime = (double) m_timeOfLastReceive + DEFAULT_CONNECTION_TIMEOUT;
+    m_owningSession->m_timerWheel.Schedule( m_timeoutTimer, dueTime );
+}
+
+void NetConnection::SetHeartbeatRate( float hz )
+{
+    m_heartbeatRate = hz;
+    if( m_hasTimers )
+    {
+        m_owningSession->m_timerWheel.Schedule(
+            m_heartbeatTimer, TimeUtils::GetCurrentTimeSecondsD() + 1.0 / hz );
+    }
+}
+
+bool NetConnection::HasPendingSend() const
+{
+    return !m_unsentUnreliables.empty()
+        || !m_unsentReliables.empty()
+        || !m_unsentLargeReliables.empty()
+        || m_shouldForceSend;
 }
 
 void NetConnection::UpdateLastReceivedAck( uint16 ackFromOther )
@@ -333,6 +576,8 @@ void NetConnection::ConfirmOnePacketReceivedByOther( uint16 ackISentBefore )
     // Update Round trip time
     float rttLatest = TimeUtils::GetCurrentTimeSecondsF() - tracker->m_timeOfSend;
     m_roundTripTime = Lerp( rttLatest, m_roundTripTime, m_roundTripTimeInertia );
+    m_congestion.OnPacketDelivered( rttLatest );
+    m_stats.RecordAck( rttLatest );
 
     // Reliables
     for( int idx = 0; idx < (int) tracker->m_reliablesInPacket; ++idx )
@@ -360,6 +605,7 @@ PacketTracker* NetConnection::AddPacketTracker( uint16 ackIJustSent )
 
     tracker->m_ack = ackIJustSent;
     tracker->m_timeOfSend = TimeUtils::GetCurrentTimeSecondsF();
+    tracker->m_isCountedLost = false;
 
     ++m_nextFreePacketTrackerSlot;
 
@@ -398,6 +644,36 @@ float NetConnection::CalculateLossRate()
     return 1.f - ( (float) totalNotLost / (float) PACKET_TRACKER_COUNT );
 }
 
+void NetConnection::UpdateCongestion()
+{
+    float currentTime = TimeUtils::GetCurrentTimeSecondsF();
+    m_congestion.m_isEnabled = m_owningSession->m_isCongestionControlEnabled;
+    DetectLostPackets( currentTime );
+    m_congestion.Update( currentTime, GetMaxSendRate(), m_roundTripTime );
+}
+
+void NetConnection::DetectLostPackets( float currentTime )
+{
+    float lossTimeout = Max( m_roundTripTime * CONGESTION_LOSS_TIMEOUT_RTT,
+                             CONGESTION_MIN_LOSS_TIMEOUT );
+    for( PacketTracker* tracker : m_packetTrackers )
+    {
+        // confirmed trackers are invalidated
+        if( tracker->m_ack == INVALID_PACKET_ACK || tracker->m_isCountedLost )
+            continue;
+        if( currentTime - tracker->m_timeOfSend > lossTimeout )
+        {
+            tracker->m_isCountedLost = true;
+            m_congestion.OnPacketLost();
+        }
+    }
+}
+
+bool NetConnection::CanSendWithinBandwidth() const
+{
+    return m_bandwidth.CanSend() && m_owningSession->m_bandwidth.CanSend();
+}
+
 float NetConnection::GetReliableResendWait()
 {
     //float wait = RELIABLE_RESEND_WAIT_MULTIPLIER * m_roundTripTime;
@@ -407,70 +683,87 @@ float NetConnection::GetReliableResendWait()
 
 void NetConnection::ConfirmReliable( uint16 reliableID )
 {
-    for( int i = (int) m_unconfirmedReliables.size() - 1; i >= 0; --i )
-    {
-        NetMessage* msg = m_unconfirmedReliables[i];
-        if( msg->m_reliableID == reliableID )
-        {
-            delete msg;
-            ContainerUtils::EraseAtIndexFast( m_unconfirmedReliables, i );
-            return;
-        }
+    NetMessage* msg = GetUnconfirmedReliable( reliableID );
+    if( msg == nullptr )
+        return;
 
+    if( msg->m_id == NETMSG_FRAGMENT )
+    {
+        --m_fragmentsInFlight;
+        uint16 transferID = m_fragmentTransferIDs[reliableID % RELIABLE_WINDOW];
+        --m_unconfirmedFragmentCounts[transferID % FRAGMENT_MAX_ASSEMBLIES];
+        // the one still being sent stops this even when all its sent ones are in
+        while( m_oldestUnconfirmedTransferID != m_nextTransferID
+               && m_unconfirmedFragmentCounts[m_oldestUnconfirmedTransferID % FRAGMENT_MAX_ASSEMBLIES] == 0 )
+            ++m_oldestUnconfirmedTransferID;
     }
+    delete msg;
+    m_unconfirmedReliables[reliableID % RELIABLE_WINDOW] = nullptr;
+    --m_unconfirmedReliableCount;
+
+    // each id is stepped over once, so this is O(1) amortized
+    while( m_oldestUnconfirmedReliableID != m_nextReliableID
+           && m_unconfirmedReliables[m_oldestUnconfirmedReliableID % RELIABLE_WINDOW] == nullptr )
+        ++m_oldestUnconfirmedReliableID;
+}
+
+NetMessage* NetConnection::GetUnconfirmedReliable( uint16 reliableID )
+{
+    NetMessage* msg = m_unconfirmedReliables[reliableID % RELIABLE_WINDOW];
+    if( msg == nullptr || msg->m_reliableID != reliableID )
+        return nullptr;
+    return msg;
 }
 
 bool NetConnection::HasReliableBeenProcessed( uint16 reliableID )
 {
-    bool hasBeenProcessed = ContainerUtils::Contains(
-        m_receivedReliableIDs, reliableID );
-    uint16 diff = m_highestReceivedReliabeID - RELIABLE_WINDOW + 1;
-    bool outOfTrackingWindow = CyclicLesser( reliableID, diff );
+    if( CyclicGreater( reliableID, m_highestReceivedReliabeID ) )
+        return false;
+
+    // too old to track, it has to have been processed
+    uint16 age = m_highestReceivedReliabeID - reliableID;
+    if( age >= RELIABLE_WINDOW )
+        return true;
 
-    return outOfTrackingWindow || hasBeenProcessed;
+    uint bitIdx = reliableID % RELIABLE_WINDOW;
+    return ( m_processedReliableBits[bitIdx / 64] & ( (uint64) 1 << ( bitIdx % 64 ) ) ) != 0;
 }
 
 void NetConnection::MarkReliableProcessed( uint16 reliableID )
 {
-    if( CyclicLesser( m_highestReceivedReliabeID, reliableID ) )
+    if( CyclicGreater( reliableID, m_highestReceivedReliabeID ) )
     {
-        m_highestReceivedReliabeID = reliableID;
-        for( int i = (int) m_receivedReliableIDs.size() - 1; i >= 0; --i )
+        // ids that slide into the window have not been processed
+        uint16 advance = reliableID - m_highestReceivedReliabeID;
+        if( advance >= RELIABLE_WINDOW )
+        {
+            for( uint64& bits : m_processedReliableBits )
+                bits = 0;
+        }
+        else
         {
-            uint16 msgID = m_receivedReliableIDs[i];
-            uint16 diff = m_highestReceivedReliabeID - msgID;
-            if( diff >= RELIABLE_WINDOW )
+            for( uint16 id = m_highestReceivedReliabeID + 1; id != reliableID; ++id )
             {
-                ContainerUtils::EraseAtIndexFast( m_receivedReliableIDs, i );
+                uint bitIdx = id % RELIABLE_WINDOW;
+                m_processedReliableBits[bitIdx / 64] &= ~( (uint64) 1 << ( bitIdx % 64 ) );
             }
         }
+        m_highestReceivedReliabeID = reliableID;
     }
-    m_receivedReliableIDs.push_back( reliableID );
+
+    uint bitIdx = reliableID % RELIABLE_WINDOW;
+    m_processedReliableBits[bitIdx / 64] |= (uint64) 1 << ( bitIdx % 64 );
 }
 
 uint16 NetConnection::GetOldestUnconfirmedReliableID()
 {
-    uint16 lowestID = m_unconfirmedReliables[0]->m_reliableID;
-
-    for( auto& msg : m_unconfirmedReliables )
-    {
-        uint16 currentID = msg->m_reliableID;
-        if( CyclicLesser( currentID, lowestID ) )
-        {
-            lowestID = currentID;
-        }
-    }
-    return lowestID;
+    return m_oldestUnconfirmedReliableID;
 }
 
 bool NetConnection::CanSendNewReliable()
 {
-    if( m_unconfirmedReliables.empty() )
-        return true;
-
-    uint16 lowestID = GetOldestUnconfirmedReliableID();
     // dist auto wraps around for uint16
-    uint16 dist = m_nextReliableID - lowestID;
+    uint16 dist = m_nextReliableID - m_oldestUnconfirmedReliableID;
     return dist < RELIABLE_WINDOW;
 }
 
@@ -510,13 +803,13 @@ void NetConnection::SetState( eConnectionState state )
     m_state = state;
     if( IsMe() )
     {
-        for( auto& connection : m_owningSession->m_connections )
+        for( NetConnection* connection : m_owningSession->m_connections )
         {
-            if( connection.second != this )
+            if( connection != this )
             {
                 NetMessage* updateState =
                     EngineNetMessages::Compose_UpdateConnectionState( state );
-                m_owningSession->SendToConnection( connection.first, updateState );
+                m_owningSession->SendToConnection( connection->m_idxInSession, updateState );
             }
         }
     }
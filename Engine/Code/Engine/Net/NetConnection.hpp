@@ -2,9 +2,22 @@
 #include "Engine/Net/NetCommonH.hpp"
 #include "Engine/Net/NetAddress.hpp"
 #include "Engine/Net/NetConnectionInfo.hpp"
+#include "Engine/Net/CongestionController.hpp"
+#include "Engine/Net/LinkConditioner.hpp"
+#include "Engine/Net/NetStats.hpp"
+#include "Engine/Net/TimerWheel.hpp"
+#include "Engine/Net/FragmentAssembler.hpp"
 #include <queue>
 
-class Timer;
+// what a connection's TimerWheelEntry does when it fires, see m_type
+enum class eConnectionTimer : uint
+{
+    FLUSH,
+    HEARTBEAT,
+    RESEND, // oldest unconfirmed reliable is due
+    UPDATE, // congestion and stats rates
+    TIMEOUT,
+};
 
 class NetConnection
 {
@@ -13,11 +26,14 @@ public:
     NetConnection();
     ~NetConnection();
 
-    void FlushIfTimeUp();
     void Flush();
     bool OnReceivePacket( NetPacket& packet, bool processSuccess );
     void QueueSend( NetMessage* netMsg );
-    void SendImmediate( const NetPacket& packet );
+    // queued on the session, goes out with the session flush
+    // goes through m_sendConditioner first if it is active
+    void SendPacket( const NetPacket& packet );
+    // queues the packets m_sendConditioner is done holding
+    void SendConditionedPackets( float currentTime );
 
     void SetClosed( bool closed ) { m_isClosed = closed; }
 
@@ -33,19 +49,30 @@ public:
     void FillPacketWithUnsentUnreliables( NetPacket& packet );
     void FillPacketWithUnconfirmedReliables( NetPacket& packet );
     void FillPacketWithUnsentReliables( NetPacket& packet );
+    // after the small reliables, at most FRAGMENT_WINDOW in flight
+    void FillPacketWithFragments( NetPacket& packet );
+    // keeps NetMessageChannel::m_largeQueueCount
+    void OnLargeQueuePopped( NetMessage* msg );
+    // gives msg the next reliable id and tracks it, false if it did not fit
+    bool WriteNewReliable( NetPacket& packet, NetMessage* msg );
     void ClearUnreliables();
 
     void SetSendRate( float hz );
+    // lowest of the connection, session and congestion controller rates
     float GetEffectiveSendInterval() const;
-
-    // checks if lap time has changed
-    // also resets clock if lapped
-    bool PopSendTimer();
-
-    // checks if heartbeat rate has changed
-    // also resets clock if lapped
-    bool PopHeartbeatTimer();
-
+    float GetMaxSendRate() const; // without congestion control
+
+    // Timers, on the session's wheel while the connection is bound
+    void StartTimers();
+    void StopTimers();
+    void OnTimer( eConnectionTimer type, double currentTime );
+    // flushes once the send interval since the last flush is up
+    void ArmFlush();
+    // when the oldest unconfirmed reliable is due a resend
+    void ArmResend();
+    void ArmTimeout();
+    void SetHeartbeatRate( float hz );
+    bool HasPendingSend() const;
 
     // Acks
     void UpdateLastReceivedAck( uint16 ackFromOther );
@@ -62,9 +89,18 @@ public:
     void UpdateLossTracker( bool packetWasReceived );
     float CalculateLossRate();
 
+    // Congestion
+    // runs every CONGESTION_UPDATE_INTERVAL on the update timer
+    void UpdateCongestion();
+    // tells the controller about packets unacked for too long
+    void DetectLostPackets( float currentTime );
+    bool CanSendWithinBandwidth() const;
+
     // Reliable
     float GetReliableResendWait();
     void ConfirmReliable( uint16 reliableID );
+    // null if not in flight
+    NetMessage* GetUnconfirmedReliable( uint16 reliableID );
     bool HasReliableBeenProcessed( uint16 reliableID );
     void MarkReliableProcessed( uint16 reliableID );
     uint16 GetOldestUnconfirmedReliableID(); // cyclic lowest
@@ -95,25 +131,70 @@ public:
 
     // reliables
     std::queue<NetMessage*> m_unsentReliables;
-    std::vector<NetMessage*> m_unconfirmedReliables;
+    // in flight, slot is reliableID % RELIABLE_WINDOW
+    NetMessage* m_unconfirmedReliables[RELIABLE_WINDOW] = {};
+    size_t m_unconfirmedReliableCount = 0;
+    uint16 m_oldestUnconfirmedReliableID = 65530; // m_nextReliableID if none
+    // unconfirmed ids in the order they were last sent so the front is the
+    // next to resend, confirmed ones are dropped when they reach the front
+    std::queue<uint16> m_resendQueue;
     uint16 m_nextReliableID = 65530;
-    std::vector<uint16> m_receivedReliableIDs;
+    // processed ids, bit is reliableID % RELIABLE_WINDOW, only ids within
+    // RELIABLE_WINDOW of the highest are tracked
+    uint64 m_processedReliableBits[( RELIABLE_WINDOW + 63 ) / 64] = {};
     uint16 m_highestReceivedReliabeID = 65530;
 
+    // large reliables, the front goes out a fragment at a time. In order
+    // reliables of a channel with a large one queued wait in here behind it
+    // and go out whole, see NetMessageChannel::m_largeQueueCount
+    std::queue<NetMessage*> m_unsentLargeReliables;
+    uint16 m_nextFragmentIdx = 0; // of the front
+    uint16 m_nextTransferID = 0;
+    size_t m_fragmentsInFlight = 0;
+    // a transfer is in flight until every fragment is sent and confirmed, at
+    // most FRAGMENT_MAX_ASSEMBLIES are so the other end has room for them.
+    // Slot is transferID % FRAGMENT_MAX_ASSEMBLIES
+    uint16 m_unconfirmedFragmentCounts[FRAGMENT_MAX_ASSEMBLIES] = {};
+    uint16 m_oldestUnconfirmedTransferID = 0; // m_nextTransferID if none
+    // transfer of each unconfirmed fragment, slot is reliableID % RELIABLE_WINDOW
+    uint16 m_fragmentTransferIDs[RELIABLE_WINDOW] = {};
+    FragmentAssembler m_fragmentAssembler;
+
     // in order traffic
     NetMessageChannel* m_messageChannels[MAX_MESSAGE_CHANNELS];
 
     // Session
     NetSession* m_owningSession = nullptr;
-    uint8 m_idxInSession = (uint8) -1;
+    ConnectionIdx m_idxInSession = INVALID_CONNECTION_INDEX;
+    size_t m_idxInConnectionList = 0; // position in NetSession::m_connections
 
     // Net tick
     float m_sendRate = MAX_SEND_RATE;
-    Timer* m_sendTimer = nullptr;
+    double m_lastFlushTime = 0.0;
+
+    // Timers, owner is this and type is an eConnectionTimer
+    bool m_hasTimers = false;
+    TimerWheelEntry m_flushTimer;
+    TimerWheelEntry m_heartbeatTimer;
+    TimerWheelEntry m_resendTimer;
+    TimerWheelEntry m_updateTimer;
+    TimerWheelEntry m_timeoutTimer;
+
+    // Congestion
+    CongestionController m_congestion;
+    BandwidthBucket m_bandwidth;
+
+    // Simulated link conditions, pass through unless configured
+    LinkConditioner m_sendConditioner;
+    LinkConditioner m_receiveConditioner;
+    // counted in NetSession::m_conditionedLinkCount until both drain
+    bool m_hasConditionedLink = false;
+
+    // Stats, message stats are in the session
+    NetConnectionStats m_stats;
 
     // Heartbeat
     float m_heartbeatRate = DEFAULT_HEARTBEAT_RATE;
-    Timer* m_heartbeatTimer = nullptr;
 
     // Acks
     uint16 m_nextAckToSend = 0U; // my ack counter
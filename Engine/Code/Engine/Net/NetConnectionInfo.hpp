@@ -6,5 +6,5 @@ struct NetConnectionInfo
 {
     NetAddress m_address;
     char m_id[MAX_CONNECTION_ID_LENGTH];
-    uint8 m_sessionIdx;
+    ConnectionIdx m_sessionIdx;
 };
@@ -1,11 +1,24 @@
 #include "Engine/Net/NetMessage.hpp"
 #include "Engine/Net/NetMessageDefinition.hpp"
 #include "Engine/Net/NetMessageDatabase.hpp"
+#include "Engine/Net/NetPool.hpp"
 #include "Engine/Core/EngineCommonC.hpp"
 
-NetMessage::NetMessage( const string& name )
+#include <string.h>
+#include <stdlib.h>
+
+NetMessage::NetMessage( NetMessageHandle handle )
+    : BytePacker( MESSAGE_MTU, m_localBuffer )
+{
+    SetEndianness( Endianness::LITTLE );
+    m_def = handle.m_def;
+    ASSERT_OR_DIE( m_def != nullptr, "Message handle was never registered" );
+    m_id = m_def->m_id;
+    SetWriteHeadToPayload();
+}
+
+NetMessage::NetMessage( const char* name )
     : BytePacker( MESSAGE_MTU, m_localBuffer )
-    , m_name( name )
 {
     SetEndianness( Endianness::LITTLE );
     m_def = NetMessageDatabase::GetDefinitionByName( name );
@@ -14,6 +27,11 @@ NetMessage::NetMessage( const string& name )
     SetWriteHeadToPayload();
 }
 
+NetMessage::NetMessage( const string& name )
+    : NetMessage( name.c_str() )
+{
+}
+
 NetMessage::NetMessage()
     : BytePacker( MESSAGE_MTU, m_localBuffer )
 {
@@ -24,9 +42,13 @@ NetMessage::NetMessage( NetMessage& copyFrom )
     : BytePacker( MESSAGE_MTU, m_localBuffer )
 {
     SetEndianness( Endianness::LITTLE );
+    if( copyFrom.IsLarge() )
+        MoveToHeap( copyFrom.GetWrittenByteCount() );
+    size_t readHead = copyFrom.GetReadHead();
     copyFrom.SetReadHead( 0 );
     CopyFrom( copyFrom );
-    m_name = copyFrom.m_name;
+    copyFrom.SetReadHead( readHead );
+    SetReadHead( readHead );
     m_def = copyFrom.m_def;
     m_senderAddress = copyFrom.m_senderAddress;
     m_senderIdx = copyFrom.m_senderIdx;
@@ -37,6 +59,22 @@ NetMessage::NetMessage( NetMessage& copyFrom )
     m_lastSentTime = copyFrom.m_lastSentTime;
 }
 
+void* NetMessage::operator new( size_t size )
+{
+    return GetPool().Alloc( size );
+}
+
+void NetMessage::operator delete( void* ptr, size_t size )
+{
+    GetPool().Free( ptr, size );
+}
+
+NetPool& NetMessage::GetPool()
+{
+    static NetPool s_pool( "NetMessage", sizeof( NetMessage ), 64 );
+    return s_pool;
+}
+
 MessageID NetMessage::GetMessageID()
 {
     return m_id;
@@ -89,3 +127,40 @@ void NetMessage::SetWriteHeadToPayload()
 {
     SetWriteHead( m_def->GetHeaderSize() );
 }
+
+void NetMessage::SetAsView( Byte* data, size_t byteCount )
+{
+    SetBufferView( data, byteCount );
+}
+
+bool NetMessage::MoveToHeap( size_t byteCount )
+{
+    if( byteCount > FRAGMENT_MAX_MESSAGE_SIZE )
+        return false;
+    if( OwnsMemory() )
+        return byteCount <= m_bufferSize || Reserve( byteCount );
+
+    Byte* buffer = (Byte*) malloc( byteCount );
+    if( buffer == nullptr )
+        return false;
+    memcpy( buffer, m_buffer, Min( m_writeHead, byteCount ) );
+    m_buffer = buffer;
+    m_bufferSize = byteCount;
+    m_bytePackerOptions = BYTEPACKER_OWNS_MEMORY | BYTEPACKER_CAN_GROW;
+    return true;
+}
+
+bool NetMessage::Grow( size_t byteCount )
+{
+    if( IsView() || m_def == nullptr || !m_def->IsReliable() )
+        return false;
+    // doubles so composing a large message does not copy on every write
+    size_t newSize = Min( Max( byteCount, m_bufferSize * 2 ), FRAGMENT_MAX_MESSAGE_SIZE );
+    if( newSize < byteCount )
+    {
+        LOG_WARNING_TAG( "Net", "[%s] is past the largest message, %u bytes",
+                         m_def->GetName().c_str(), (uint) FRAGMENT_MAX_MESSAGE_SIZE );
+        return false;
+    }
+    return MoveToHeap( newSize );
+}
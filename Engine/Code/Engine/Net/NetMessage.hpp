@@ -3,24 +3,39 @@
 #include "Engine/Net/NetCommonH.hpp"
 #include "Engine/DataUtils/BytePacker.hpp"
 #include "Engine/Net/NetAddress.hpp"
+#include "Engine/Net/NetMessageDatabase.hpp"
 
 class NetConnection;
 class NetMessageDefinition;
+class NetPool;
 
 // [uint8 messageID] // this is header for now
 // [uint16 reliableID] // only for reliable
 // [uint16 sequenceID]
 // [byte_t* messagePayload] // will be message_and_header_length - 1U long for now
 
+// Reliables written past MESSAGE_MTU move to the heap, up to
+// FRAGMENT_MAX_MESSAGE_SIZE, and are sent in fragments, see
+// NetConnection::FillPacketWithFragments
+
 
 class NetMessage : public BytePacker
 {
 public:
+    // no lookup, the handle is from registration, see NET_MESSAGE_DECLARE
+    NetMessage( NetMessageHandle handle );
+    // looks the definition up by name
+    NetMessage( const char* name );
     NetMessage( const string& name );
     NetMessage( NetMessage& copyFrom );
     NetMessage();
     ~NetMessage() {};
 
+    // allocated from a NetPool, see GetPool
+    static void* operator new( size_t size );
+    static void operator delete( void* ptr, size_t size );
+    static NetPool& GetPool();
+
 
     // also sets the read head to be after the header
     MessageID GetMessageID();
@@ -28,17 +43,30 @@ public:
     void PackHeader();
     void SetWriteHeadToPayload();
 
+    // reads byteCount bytes in place instead of copying them in, used for
+    // messages inside a received packet, only valid while the packet is
+    // copying a view copies the bytes into the new message's local buffer
+    void SetAsView( Byte* data, size_t byteCount );
+    bool IsView() const { return m_buffer != m_localBuffer && !OwnsMemory(); }
+
+    // moves the bytes to a heap buffer of at least byteCount, false past
+    // FRAGMENT_MAX_MESSAGE_SIZE
+    bool MoveToHeap( size_t byteCount );
+    bool IsLarge() const { return GetWrittenByteCount() > MESSAGE_MTU; }
+
+    // only reliables grow, see NetConnection::QueueSend
+    bool Grow( size_t byteCount ) override;
+
 public:
 
     Byte m_localBuffer[MESSAGE_MTU];
 
-    string m_name;
-    const NetMessageDefinition* m_def;
+    const NetMessageDefinition* m_def = nullptr;
 
     NetAddress m_senderAddress;
 
-    uint8 m_senderIdx = 0U;
-    uint8 m_receiverIdx = 0U;
+    ConnectionIdx m_senderIdx = 0U;
+    ConnectionIdx m_receiverIdx = 0U;
 
     MessageID m_id = NET_MESSAGE_ID_INVALID;
 
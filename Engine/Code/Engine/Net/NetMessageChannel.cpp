@@ -23,17 +23,15 @@ void NetMessageChannel::IncrementExpectedSequenceID()
 
 NetMessage* NetMessageChannel::PopMessageInOrder()
 {
-    for( int i = (int) m_outOfOrderMessages.size() - 1; i >= 0; --i )
-    {
-        NetMessage* msg = m_outOfOrderMessages[i];
-        if( IsMessageExpected( msg ) )
-        {
-            ContainerUtils::EraseAtIndexFast( m_outOfOrderMessages, i );
-            ++m_nextExpectedSequenceID;
-            return msg;
-        }
-    }
-    return nullptr;
+    NetMessage*& slot = m_outOfOrderMessages[m_nextExpectedSequenceID % IN_ORDER_WINDOW];
+    NetMessage* msg = slot;
+    if( msg == nullptr || !IsMessageExpected( msg ) )
+        return nullptr;
+
+    slot = nullptr;
+    --m_outOfOrderCount;
+    ++m_nextExpectedSequenceID;
+    return msg;
 }
 
 bool NetMessageChannel::IsMessageExpected( NetMessage* msg )
@@ -41,8 +39,54 @@ bool NetMessageChannel::IsMessageExpected( NetMessage* msg )
     return msg->m_sequenceID == m_nextExpectedSequenceID;
 }
 
-void NetMessageChannel::CloneAndPushMessage( NetMessage* msg )
+bool NetMessageChannel::CloneAndPushMessage( NetMessage* msg )
+{
+    // already delivered
+    if( CyclicLesser( msg->m_sequenceID, m_nextExpectedSequenceID ) )
+    {
+        ++m_droppedMessageCount;
+        return true;
+    }
+
+    uint16 distance = msg->m_sequenceID - m_nextExpectedSequenceID;
+    if( distance >= IN_ORDER_WINDOW )
+    {
+        ++m_droppedMessageCount;
+        LOG_WARNING_TAG( "Net", "In order message [%u] is %u ahead of [%u], dropped",
+                         msg->m_sequenceID, distance, m_nextExpectedSequenceID );
+        return false;
+    }
+
+    NetMessage*& slot = m_outOfOrderMessages[msg->m_sequenceID % IN_ORDER_WINDOW];
+    if( slot != nullptr )
+    {
+        // reliables are deduplicated before this, so this should not happen
+        ++m_droppedMessageCount;
+        return true;
+    }
+
+    slot = new NetMessage( *msg );
+    ++m_outOfOrderCount;
+    ++m_bufferedMessageCount;
+    m_peakOutOfOrderCount = Max( m_peakOutOfOrderCount, m_outOfOrderCount );
+    m_peakReorderDistance = Max( m_peakReorderDistance, distance );
+    return true;
+}
+
+void NetMessageChannel::ResetStats()
+{
+    m_bufferedMessageCount = 0;
+    m_peakOutOfOrderCount = m_outOfOrderCount;
+    m_peakReorderDistance = 0;
+    m_droppedMessageCount = 0;
+}
+
+string NetMessageChannel::GetStatsString() const
 {
-    NetMessage* clone = new NetMessage( *msg );
-    m_outOfOrderMessages.push_back( clone );
+    return Stringf(
+        "expected: %5u  waiting: %3u  peak waiting: %3u  peak distance: %3u  "
+        "buffered: %6u  dropped: %u",
+        m_nextExpectedSequenceID, (uint) m_outOfOrderCount,
+        (uint) m_peakOutOfOrderCount, m_peakReorderDistance,
+        (uint) m_bufferedMessageCount, (uint) m_droppedMessageCount );
 }
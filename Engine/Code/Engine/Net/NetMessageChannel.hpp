@@ -1,9 +1,15 @@
 #pragma once
 
 #include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Net/NetCommonH.hpp"
 
 class NetMessage;
 
+// Delivers in-order messages of one channel
+// Early messages wait in a ring buffer, slot is sequenceID % IN_ORDER_WINDOW
+// so pushing and popping do not search. In-order messages are reliable, so
+// the reliable window keeps early ones within IN_ORDER_WINDOW of the
+// expected one
 class NetMessageChannel
 {
 public:
@@ -15,11 +21,24 @@ public:
     NetMessage* PopMessageInOrder();
     bool IsMessageExpected( NetMessage* msg );
     // clones message internally, caller should delete original
-    void CloneAndPushMessage( NetMessage* msg );
+    // false if it is too far ahead to buffer
+    bool CloneAndPushMessage( NetMessage* msg );
+
+    // Stats
+    void ResetStats();
+    string GetStatsString() const;
 
     uint16 m_nextSequenceIDToSend = 0;            // used for sending
+    // this channel's sends in NetConnection::m_unsentLargeReliables, while
+    // there are any later ones queue there too so none overtake a large one
+    size_t m_largeQueueCount = 0;                // used for sending
     uint16 m_nextExpectedSequenceID = 0;        // used for receiving
-    vector<NetMessage*> m_outOfOrderMessages;   // used for receiving
-
+    NetMessage* m_outOfOrderMessages[IN_ORDER_WINDOW] = {}; // used for receiving
+    size_t m_outOfOrderCount = 0;
 
+    // Stats
+    size_t m_bufferedMessageCount = 0; // messages that arrived early
+    size_t m_peakOutOfOrderCount = 0; // most messages waiting at once
+    uint16 m_peakReorderDistance = 0; // furthest ahead of the expected one
+    size_t m_droppedMessageCount = 0; // duplicates and too far ahead
 };
@@ -7,6 +7,15 @@
 namespace
 {
 
+constexpr size_t MAX_MESSAGE_COUNT = 1 << sizeof( MessageID ) * 8;
+
+// filled by Finalize
+const NetMessageDefinition** GetDefinitionsByID()
+{
+    static const NetMessageDefinition* s_definitionsByID[MAX_MESSAGE_COUNT] = {};
+    return s_definitionsByID;
+}
+
 bool MessageNameCompare( const NetMessageDefinition* defA,
                          const NetMessageDefinition* defB )
 {
@@ -14,7 +23,7 @@ bool MessageNameCompare( const NetMessageDefinition* defA,
 }
 }
 
-bool NetMessageDatabase::RegisterDefinition(
+NetMessageHandle NetMessageDatabase::RegisterDefinition(
     const string& name,
     NetMessageCB cb,
     eNetMessageFlag flags /*= eNetMessageFlag::DEFAULT*/,
@@ -29,13 +38,13 @@ bool NetMessageDatabase::RegisterDefinition(
         {
             LOG_WARNING_TAG( "Net", "NetMessageDefinition already exists for [%s]",
                              name.c_str() );
-            return false;
+            return NetMessageHandle();
         }
         if( def->m_id == messageId && def->m_id != NET_MESSAGE_ID_AUTO )
         {
             LOG_WARNING_TAG( "Net", "NetMessageDefinition id already exists for [%u]",
                              messageId );
-            return false;
+            return NetMessageHandle();
         }
     }
 
@@ -43,7 +52,7 @@ bool NetMessageDatabase::RegisterDefinition(
         name, cb, flags, messageId, channelIdx );
 
     defs.push_back( def );
-    return true;
+    return NetMessageHandle( def );
 }
 
 bool NetMessageDatabase::Finalize()
@@ -55,7 +64,6 @@ bool NetMessageDatabase::Finalize()
         defs.end(),
         MessageNameCompare );
 
-    constexpr size_t MAX_MESSAGE_COUNT = 1 << sizeof( MessageID ) * 8;
     NetMessageDefinition* tempDefs[MAX_MESSAGE_COUNT];
 
     for( int idx = 0; idx < MAX_MESSAGE_COUNT; ++idx )
@@ -87,8 +95,10 @@ bool NetMessageDatabase::Finalize()
     size_t capacity = defs.size();
     defs.clear();
     defs.reserve( capacity );
+    const NetMessageDefinition** definitionsByID = GetDefinitionsByID();
     for( int idx = 0; idx < MAX_MESSAGE_COUNT; ++idx )
     {
+        definitionsByID[idx] = tempDefs[idx];
         if( tempDefs[idx] != nullptr )
         {
             defs.push_back( tempDefs[idx] );
@@ -107,11 +117,17 @@ bool NetMessageDatabase::Finalize()
 
 const NetMessageDefinition* NetMessageDatabase::GetDefinitionByName(
     const string& name )
+{
+    return GetDefinitionByName( name.c_str() );
+}
+
+const NetMessageDefinition* NetMessageDatabase::GetDefinitionByName(
+    const char* name )
 {
     vector<NetMessageDefinition*>& defs = GetMessageDefinitions();
     for( auto& def : defs )
     {
-        if( name == def->m_name )
+        if( def->m_name == name )
             return def;
     }
     return nullptr;
@@ -120,13 +136,7 @@ const NetMessageDefinition* NetMessageDatabase::GetDefinitionByName(
 const NetMessageDefinition* NetMessageDatabase::GetDefinitionByID(
     const MessageID idx )
 {
-    vector<NetMessageDefinition*>& defs = GetMessageDefinitions();
-    for( auto& def : defs )
-    {
-        if( idx == def->m_id )
-            return def;
-    }
-    return nullptr;
+    return GetDefinitionsByID()[idx];
 }
 
 vector<NetMessageDefinition*>& NetMessageDatabase::GetMessageDefinitions()
@@ -3,10 +3,26 @@
 
 class NetMessageDefinition;
 
+// A registered message, what RegisterDefinition hands back. Composing with
+// one skips the name lookup. Valid from registration on, the id is only
+// assigned by Finalize
+class NetMessageHandle
+{
+public:
+    NetMessageHandle() {}
+    explicit NetMessageHandle( const NetMessageDefinition* def ) : m_def( def ) {}
+
+    bool IsValid() const { return m_def != nullptr; }
+
+public:
+    const NetMessageDefinition* m_def = nullptr;
+};
+
 namespace NetMessageDatabase
 {
 
-bool RegisterDefinition(
+// invalid handle if the name or id is taken
+NetMessageHandle RegisterDefinition(
     const string& name,
     NetMessageCB cb,
     eNetMessageFlag flags =  eNetMessageFlag::DEFAULT,
@@ -18,7 +34,10 @@ bool Finalize();
 
 // Lookup
 // Only valid after Finalize
+// by name walks every definition, compose with a NetMessageHandle instead
+const NetMessageDefinition* GetDefinitionByName( const char* name );
 const NetMessageDefinition* GetDefinitionByName( const string& name );
+// constant time, a table indexed by id
 const NetMessageDefinition* GetDefinitionByID( const MessageID idx );
 
 // overcomes unknown static init order
@@ -4,6 +4,7 @@
 #include "Engine/Net/NetMessageDatabase.hpp"
 #include "Engine/Core/EngineCommonC.hpp"
 #include "Engine/Net/NetMessageDefinition.hpp"
+#include "Engine/Net/NetPool.hpp"
 
 NetPacket::NetPacket()
     : BytePacker( PACKET_MTU, m_localBuffer )
@@ -11,6 +12,37 @@ NetPacket::NetPacket()
     SetEndianness( Endianness::LITTLE );
 }
 
+NetPacket::NetPacket( const NetPacket& copyFrom )
+    : BytePacker( PACKET_MTU, m_localBuffer )
+{
+    SetEndianness( Endianness::LITTLE );
+    WriteBytes( copyFrom.GetWrittenByteCount(), copyFrom.GetBuffer() );
+    SetReadHead( copyFrom.GetReadHead() );
+    m_header = copyFrom.m_header;
+    m_senderAddress = copyFrom.m_senderAddress;
+    m_receiverAddress = copyFrom.m_receiverAddress;
+    m_reliableMessageCount = copyFrom.m_reliableMessageCount;
+    m_byteBudget = copyFrom.m_byteBudget;
+    m_senderIdx = copyFrom.m_senderIdx;
+    m_receiverIdx = copyFrom.m_receiverIdx;
+}
+
+void* NetPacket::operator new( size_t size )
+{
+    return GetPool().Alloc( size );
+}
+
+void NetPacket::operator delete( void* ptr, size_t size )
+{
+    GetPool().Free( ptr, size );
+}
+
+NetPool& NetPacket::GetPool()
+{
+    static NetPool s_pool( "NetPacket", sizeof( NetPacket ), 32 );
+    return s_pool;
+}
+
 void NetPacket::PackHeader()
 {
     size_t savedWriteHead = GetWrittenByteCount();
@@ -20,6 +52,7 @@ void NetPacket::PackHeader()
     Write( m_header.m_lastReceivedAck );
     Write( m_header.m_receivedAckBitfield );
     Write( m_header.m_message_count );
+    Write( m_header.m_flags );
     SetWriteHead( savedWriteHead );
 }
 
@@ -31,7 +64,8 @@ bool NetPacket::UnpackHeader()
         || !Read( &m_header.m_ack )
         || !Read( &m_header.m_lastReceivedAck )
         || !Read( &m_header.m_receivedAckBitfield )
-        || !Read( &m_header.m_message_count ) )
+        || !Read( &m_header.m_message_count )
+        || !Read( &m_header.m_flags ) )
         return false;
 
     return true;
@@ -69,6 +103,9 @@ bool NetPacket::CanWriteMessage( NetMessage& msg )
     size_t spaceNeeded = msg.GetWrittenByteCount() + sizeof( uint16 );
     if( m_bufferSize - m_writeHead < spaceNeeded )
         return false;
+    // the budget never blocks the first message, it could never be sent
+    if( m_header.m_message_count != 0 && m_byteBudget < m_writeHead + spaceNeeded )
+        return false;
     return true;
 }
 
@@ -81,18 +118,17 @@ bool NetPacket::ExtractMessage( NetMessage& out_msg )
         LOG_WARNING_TAG( "Net", "Could not read message length" );
         return false;
     }
-    // Read message
-    out_msg.SetWriteHead( 0 );
-    uint16 readByteCount = (uint16) out_msg.CopyFrom( *this, messageLength );
-
-    if( readByteCount != messageLength )
+    // Read message in place, no copy
+    if( messageLength > MESSAGE_MTU || messageLength > GetReadableByteCount() )
     {
         LOG_WARNING_TAG( "Net",
-                         "readByteCount != messageLength %d, %d",
-                         readByteCount,
-                         messageLength);
+                         "message length %d does not fit, %d readable",
+                         messageLength,
+                         (int) GetReadableByteCount() );
         return false;
     }
+    out_msg.SetAsView( m_buffer + m_readHead, messageLength );
+    OffsetReadHead( messageLength );
 
     out_msg.m_senderAddress = m_senderAddress;
     out_msg.m_senderIdx = m_senderIdx;
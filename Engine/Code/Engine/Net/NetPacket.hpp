@@ -5,11 +5,16 @@
 
 class NetMessage;
 class NetConnection;
+class NetPool;
 
 // All BytePackers are LITTLE_ENDIAN
 // A packet header is..
-// [uint8 sender_conn_idx]
-// [uint8 unreliable_count]
+// [uint16 sender_conn_idx]
+// [uint16 ack]
+// [uint16 last_received_ack]
+// [uint16 received_ack_bitfield]
+// [uint8 message_count]
+// [uint8 flags] // PACKET_FLAG_COMPRESSED means the rest is compressed, see PacketCompressor
 
 // Followed by all unreliables, each message having the format
 // [uint16 message_and_header_length]
@@ -19,11 +24,12 @@ class NetConnection;
 #pragma pack(push,1)
 struct PacketHeader
 {
-    uint8 m_senderConnectionIdx = INVALID_CONNECTION_INDEX;
+    ConnectionIdx m_senderConnectionIdx = INVALID_CONNECTION_INDEX;
     uint16 m_ack = INVALID_PACKET_ACK;
     uint16 m_lastReceivedAck = INVALID_PACKET_ACK;
     uint16 m_receivedAckBitfield = 0;
     uint8 m_message_count = 0;
+    uint8 m_flags = 0; // PACKET_FLAG_
 };
 #pragma pack(pop)
 
@@ -31,8 +37,14 @@ class NetPacket : public BytePacker
 {
 public:
 	NetPacket();
+	NetPacket( const NetPacket& copyFrom );
 	virtual ~NetPacket(){};
 
+    // allocated from a NetPool, see GetPool
+    static void* operator new( size_t size );
+    static void operator delete( void* ptr, size_t size );
+    static NetPool& GetPool();
+
     // Header
     void PackHeader();
     bool UnpackHeader();
@@ -53,9 +65,9 @@ public:
     NetAddress m_senderAddress;
     NetAddress m_receiverAddress;
 
-    float m_timeOfReceive = 0;
     uint m_reliableMessageCount = 0;
+    size_t m_byteBudget = PACKET_MTU; // messages stop fitting past this
 
-    uint8 m_senderIdx = 0U;
-    uint8 m_receiverIdx = 0U;
+    ConnectionIdx m_senderIdx = 0U;
+    ConnectionIdx m_receiverIdx = 0U;
 };
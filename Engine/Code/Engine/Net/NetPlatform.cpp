@@ -0,0 +1,140 @@
+#include "Engine/Net/NetPlatformCommon.hpp"
+#include "Engine/Net/NetPlatform.hpp"
+#include "Engine/Core/ErrorUtils.hpp"
+#include "Engine/Log/Logger.hpp"
+
+#if defined( _WIN32 )
+#include "Engine/Core/WindowsUtils.hpp"
+#else
+#include <string.h>
+#endif
+
+#if defined( _WIN32 )
+
+//--------------------------------------------------------------------------------------
+// Winsock
+
+bool NetPlatform::Startup()
+{
+    WORD version = MAKEWORD( 2, 2 );
+    WSADATA data;
+
+    int error = WSAStartup( version, &data );
+
+    GUARANTEE_OR_DIE( error == 0, "WSAStartup failed" );
+    return error == 0;
+}
+
+void NetPlatform::Shutdown()
+{
+    ::WSACleanup();
+}
+
+bool NetPlatform::CloseSocket( SocketHandle sock )
+{
+    return ::closesocket( (SOCKET) sock ) == 0;
+}
+
+bool NetPlatform::SetBlocking( SocketHandle sock, bool block )
+{
+    u_long nonBlocking = block ? 0 : 1;
+    int result = ioctlsocket( (SOCKET) sock, FIONBIO, &nonBlocking );
+    return result == NO_ERROR;
+}
+
+int NetPlatform::GetLastErrorCode()
+{
+    return WSAGetLastError();
+}
+
+string NetPlatform::ErrorCodeToString( int errorCode )
+{
+    return WindowsUtils::ErrorCodeToString( errorCode );
+}
+
+bool NetPlatform::IsFatalErrorCode( int errorCode )
+{
+    return !( errorCode == WSAEWOULDBLOCK
+              || errorCode == WSAEMSGSIZE
+              || errorCode == WSAECONNRESET );
+}
+
+bool NetPlatform::IsNotSocketErrorCode( int errorCode )
+{
+    return errorCode == WSAENOTSOCK;
+}
+
+string NetPlatform::GetLocalHostName()
+{
+    return "";
+}
+
+#else
+
+//--------------------------------------------------------------------------------------
+// Posix
+
+bool NetPlatform::Startup()
+{
+    return true;
+}
+
+void NetPlatform::Shutdown()
+{
+}
+
+bool NetPlatform::CloseSocket( SocketHandle sock )
+{
+    return ::close( (SOCKET) sock ) == 0;
+}
+
+bool NetPlatform::SetBlocking( SocketHandle sock, bool block )
+{
+    int flags = ::fcntl( (SOCKET) sock, F_GETFL, 0 );
+    if( flags == -1 )
+        return false;
+
+    if( block )
+        flags &= ~O_NONBLOCK;
+    else
+        flags |= O_NONBLOCK;
+
+    return ::fcntl( (SOCKET) sock, F_SETFL, flags ) == 0;
+}
+
+int NetPlatform::GetLastErrorCode()
+{
+    return errno;
+}
+
+string NetPlatform::ErrorCodeToString( int errorCode )
+{
+    return string( ::strerror( errorCode ) );
+}
+
+bool NetPlatform::IsFatalErrorCode( int errorCode )
+{
+    // ECONNREFUSED is what a udp socket reports after an icmp port
+    // unreachable, same as WSAECONNRESET on windows
+    return !( errorCode == EAGAIN
+              || errorCode == EWOULDBLOCK
+              || errorCode == EINTR
+              || errorCode == EMSGSIZE
+              || errorCode == ECONNREFUSED );
+}
+
+bool NetPlatform::IsNotSocketErrorCode( int errorCode )
+{
+    return errorCode == ENOTSOCK || errorCode == EBADF;
+}
+
+string NetPlatform::GetLocalHostName()
+{
+    char hostName[256];
+    if( ::gethostname( hostName, sizeof( hostName ) ) != 0 )
+        return "localhost";
+    hostName[sizeof( hostName ) - 1] = '\0';
+    return string( hostName );
+}
+
+#endif
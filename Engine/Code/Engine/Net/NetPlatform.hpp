@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include <stdint.h>
+
+// Opaque socket handle, wide enough for a winsock SOCKET and a posix fd
+// internally we cast SocketHandle to SOCKET
+typedef uintptr_t SocketHandle;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = (SocketHandle) ( ~0 );
+
+// Everything that differs between winsock and berkeley sockets
+namespace NetPlatform
+{
+
+bool Startup();
+void Shutdown();
+
+bool CloseSocket( SocketHandle sock );
+bool SetBlocking( SocketHandle sock, bool block );
+
+int GetLastErrorCode();
+string ErrorCodeToString( int errorCode );
+
+// would block, truncated datagram and port unreachable are not fatal
+bool IsFatalErrorCode( int errorCode );
+// operation on something that is not a socket, this is always a bug
+bool IsNotSocketErrorCode( int errorCode );
+
+// node name to resolve when asked for local addresses
+// winsock resolves "" to the local host, posix needs the host name
+string GetLocalHostName();
+
+};
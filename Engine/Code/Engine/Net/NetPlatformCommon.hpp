@@ -0,0 +1,38 @@
+#pragma once
+
+// System socket headers, only include this in .cpp files.
+// Winsock and berkeley sockets are close enough that the socket code can be
+// written once, the few differences are hidden behind NetPlatform
+#if defined( _WIN32 )
+
+#include "Engine/Core/WindowsCommon.hpp"
+
+#define SOCKET_SEND_FLAGS (0)
+
+#else
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+typedef int SOCKET;
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (-1)
+#endif
+
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+
+// a closed tcp peer should be an error, not a SIGPIPE
+#define SOCKET_SEND_FLAGS (MSG_NOSIGNAL)
+
+#endif
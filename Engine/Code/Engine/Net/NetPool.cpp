@@ -0,0 +1,115 @@
+#include "Engine/Net/NetPool.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+
+#include <stdlib.h>
+
+NetPool::NetPool( const char* name, size_t blockSize, size_t blocksPerChunk )
+    : m_name( name )
+    , m_blockSize( Max( blockSize, sizeof( FreeBlock ) ) )
+    , m_blocksPerChunk( blocksPerChunk )
+{
+    GetAllPools().push_back( this );
+}
+
+NetPool::~NetPool()
+{
+    ContainerUtils::EraseOneValue( GetAllPools(), this );
+
+    // static destruction order is unknown, leak rather than pull blocks
+    // out from under something still alive
+    if( m_liveCount != 0 )
+        return;
+    for( void* chunk : m_chunks )
+        ::free( chunk );
+}
+
+void* NetPool::Alloc( size_t size )
+{
+    std::unique_lock<std::mutex> lock( m_lock, std::defer_lock );
+    if( m_isThreadSafe )
+        lock.lock();
+
+    ++m_allocCount;
+    if( size != m_blockSize )
+    {
+        ++m_heapAllocCount;
+        return ::operator new( size );
+    }
+
+    if( m_freeList == nullptr )
+        AllocChunk();
+
+    FreeBlock* block = m_freeList;
+    m_freeList = block->m_next;
+
+    ++m_liveCount;
+    m_peakLiveCount = Max( m_peakLiveCount, m_liveCount );
+    return block;
+}
+
+void NetPool::Free( void* block, size_t size )
+{
+    if( block == nullptr )
+        return;
+
+    std::unique_lock<std::mutex> lock( m_lock, std::defer_lock );
+    if( m_isThreadSafe )
+        lock.lock();
+
+    ++m_freeCount;
+    if( size != m_blockSize )
+    {
+        ::operator delete( block );
+        return;
+    }
+
+    FreeBlock* freeBlock = (FreeBlock*) block;
+    freeBlock->m_next = m_freeList;
+    m_freeList = freeBlock;
+    --m_liveCount;
+}
+
+void NetPool::ResetCounters()
+{
+    m_allocCount = 0;
+    m_freeCount = 0;
+    m_heapAllocCount = 0;
+    m_peakLiveCount = m_liveCount;
+}
+
+string NetPool::GetStatsString() const
+{
+    return Stringf(
+        "%-12s live: %5u  peak: %5u  capacity: %5u  allocs: %8u  frees: %8u  heap allocs: %u",
+        m_name, (uint) m_liveCount, (uint) m_peakLiveCount, (uint) m_capacity,
+        (uint) m_allocCount, (uint) m_freeCount, (uint) m_heapAllocCount );
+}
+
+vector<NetPool*>& NetPool::GetAllPools()
+{
+    static vector<NetPool*> s_pools;
+    return s_pools;
+}
+
+void NetPool::LogAllStats()
+{
+    for( NetPool* pool : GetAllPools() )
+        LOG_INFO_TAG( "Net", "%s", pool->GetStatsString().c_str() );
+}
+
+void NetPool::AllocChunk()
+{
+    Byte* chunk = (Byte*) ::malloc( m_blockSize * m_blocksPerChunk );
+    ASSERT_OR_DIE( chunk != nullptr, "NetPool out of memory" );
+    m_chunks.push_back( chunk );
+    ++m_heapAllocCount;
+    m_capacity += m_blocksPerChunk;
+
+    // push in reverse so blocks come out in address order
+    for( size_t idx = m_blocksPerChunk; idx > 0; --idx )
+    {
+        FreeBlock* block = (FreeBlock*) ( chunk + ( idx - 1 ) * m_blockSize );
+        block->m_next = m_freeList;
+        m_freeList = block;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+
+#include <mutex>
+
+// Free list of fixed size blocks for the net hot path
+// blocks are grabbed from the heap a chunk at a time and never given back,
+// after warm up Alloc and Free are a pointer pop / push
+// Not thread safe unless SetThreadSafe is on, then Alloc and Free take a lock
+class NetPool
+{
+public:
+    NetPool( const char* name, size_t blockSize, size_t blocksPerChunk );
+    ~NetPool();
+
+    // falls back to the heap if size does not match the block size
+    void* Alloc( size_t size );
+    void Free( void* block, size_t size );
+
+    // only change this while one thread is using the pool
+    void SetThreadSafe( bool isThreadSafe ) { m_isThreadSafe = isThreadSafe; }
+
+    void ResetCounters();
+    string GetStatsString() const;
+
+    // every pool that has been constructed, for stats
+    static vector<NetPool*>& GetAllPools();
+    static void LogAllStats();
+
+private:
+    void AllocChunk();
+
+    struct FreeBlock
+    {
+        FreeBlock* m_next;
+    };
+
+public:
+
+    const char* m_name = nullptr;
+    size_t m_blockSize = 0;
+    size_t m_blocksPerChunk = 0;
+
+    FreeBlock* m_freeList = nullptr;
+    vector<void*> m_chunks;
+
+    bool m_isThreadSafe = false;
+    std::mutex m_lock;
+
+    // Counters
+    size_t m_allocCount = 0;
+    size_t m_freeCount = 0;
+    size_t m_heapAllocCount = 0; // chunks plus wrong size fallbacks
+    size_t m_liveCount = 0;
+    size_t m_peakLiveCount = 0;
+    size_t m_capacity = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/DataUtils/BytePacker.hpp"
+
+#include <type_traits>
+
+// Pack and unpack for structs of plain fields, the fields are listed once
+//
+//     struct AddPayload
+//     {
+//         float m_a = 0.f;
+//         float m_b = 0.f;
+//         NET_SCHEMA( m_a, m_b )
+//     };
+//
+//     payload.Pack( *msg );
+//     if( !payload.Unpack( *netMessage ) ) ...
+//
+// Fields go in the order listed through BytePacker::Write and Read, so they
+// have to be numbers or enums. Unpack fails if the packer runs out
+
+#define NET_SCHEMA( ... ) \
+bool Pack( BytePacker& packer ) const { return NetSchema::PackFields( packer, __VA_ARGS__ ); } \
+bool Unpack( BytePacker& packer ) { return NetSchema::UnpackFields( packer, __VA_ARGS__ ); }
+
+namespace NetSchema
+{
+
+inline bool PackFields( BytePacker& )
+{
+    return true;
+}
+
+template <typename T, typename... Rest>
+bool PackFields( BytePacker& packer, const T& field, const Rest&... rest )
+{
+    static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                   "NET_SCHEMA fields are written as single values" );
+    return packer.Write( field ) && PackFields( packer, rest... );
+}
+
+inline bool UnpackFields( BytePacker& )
+{
+    return true;
+}
+
+template <typename T, typename... Rest>
+bool UnpackFields( BytePacker& packer, T& field, Rest&... rest )
+{
+    static_assert( std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                   "NET_SCHEMA fields are read as single values" );
+    return packer.Read( &field ) && UnpackFields( packer, rest... );
+}
+
+}
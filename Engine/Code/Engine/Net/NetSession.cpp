@@ -10,6 +10,17 @@
 namespace
 {
 NetSession* s_defaultSession = nullptr;
+
+thread_local bool s_isNetThread = false;
+thread_local int s_lockDepth = 0;
+
+class ScopedSessionLock
+{
+public:
+    ScopedSessionLock( NetSession* session ) : m_session( session ) { m_session->Lock(); }
+    ~ScopedSessionLock() { m_session->Unlock(); }
+    NetSession* m_session;
+};
 }
 
 NetSession* NetSession::GetDefault()
@@ -22,17 +33,28 @@ NetSession* NetSession::GetDefault()
 NetSession::NetSession()
 {
     m_netClock = new Clock();
+    m_timerWheel.Reset( TimeUtils::GetCurrentTimeSecondsD() );
+    m_compressor = new PacketCompressor();
+    for( NetPacket*& packet : m_receiveBatch )
+        packet = new NetPacket();
+
+    ResetConnectionSlots();
 }
 
 NetSession::~NetSession()
 {
+    StopNetThread();
     Disconnect();
     delete m_netClock;
+    delete m_compressor;
+    for( NetPacket* packet : m_receiveBatch )
+        delete packet;
 }
 
 void NetSession::Host( const string& myID, int port, uint rangeToTry /*= 0U */ )
 {
     UNUSED( myID );
+    ScopedSessionLock lock( this );
     if( m_state != eSessionState::DISCONNECTED )
     {
         LOG_WARNING_TAG( "Net", "Cannot host, not in disconnected state" );
@@ -42,28 +64,40 @@ void NetSession::Host( const string& myID, int port, uint rangeToTry /*= 0U */ )
     if( !BindToPort( port, rangeToTry ) )
         return;
 
-    NetConnection* connection = CreateConnection( m_boundAddress );
-    BindConnection( 0, connection );
-    m_myConnection = connection;
-    m_myConnectionIdx = 0;
-    m_hostConnection = connection;
-    connection->m_state = eConnectionState::READY;
-    m_state = eSessionState::READY;
-    m_shouldResetClock = true;
+    BeginHosting();
 }
 
 void NetSession::Join( const string& myID, const NetAddress& hostAddr )
 {
     UNUSED( myID );
+    ScopedSessionLock lock( this );
     if( m_state != eSessionState::DISCONNECTED )
     {
         LOG_WARNING_TAG( "Net", "Cannot join, not in disconnected state" );
         return;
     }
 
-    if( !BindToPort( hostAddr.m_port, MAX_CONNECTION_COUNT ) )
+    if( !BindToPort( hostAddr.m_port, CLIENT_PORT_RANGE ) )
         return;
 
+    BeginJoining( hostAddr );
+}
+
+void NetSession::BeginHosting()
+{
+    NetConnection* connection = CreateConnection( m_boundAddress );
+    // set before binding so it gets no timers
+    m_myConnection = connection;
+    BindConnection( 0, connection );
+    m_myConnectionIdx = 0;
+    m_hostConnection = connection;
+    connection->m_state = eConnectionState::READY;
+    m_state = eSessionState::READY;
+    m_shouldResetClock = true;
+}
+
+void NetSession::BeginJoining( const NetAddress& hostAddr )
+{
     // host connection
     NetConnection* hostConnection = CreateConnection( hostAddr );
     BindConnection( 0, hostConnection );
@@ -80,6 +114,7 @@ void NetSession::Join( const string& myID, const NetAddress& hostAddr )
 
 void NetSession::Disconnect()
 {
+    ScopedSessionLock lock( this );
     SendHangupToAll();
 
     // these are deleted in the list so do not delete here
@@ -90,11 +125,26 @@ void NetSession::Disconnect()
         delete connection;
     m_unboundConnections.clear();
 
-    for( auto& pair : m_connections )
-        delete pair.second;
-    m_connections.clear();
+    while( !m_connections.empty() )
+    {
+        NetConnection* connection = m_connections.back();
+        RemoveBoundConnection( connection );
+        delete connection;
+    }
+    ResetConnectionSlots();
 
-    m_packetChannel->Close();
+    while( !m_loopbackMessages.empty() )
+    {
+        delete m_loopbackMessages.front();
+        m_loopbackMessages.pop();
+    }
+
+    if( m_packetChannel )
+    {
+        m_packetChannel->StopCapture();
+        m_packetChannel->StopReplay();
+        m_packetChannel->Close();
+    }
     m_state = eSessionState::DISCONNECTED;
     m_lastReceivedHostTime = 0.f;
 }
@@ -106,6 +156,7 @@ void NetSession::ShouldDisconnect()
 
 bool NetSession::IsHost()
 {
+    ScopedSessionLock lock( this );
     return ( m_myConnection != nullptr ) && m_myConnection->IsHost();
 }
 
@@ -134,11 +185,10 @@ bool NetSession::DidJoinTimeout()
 
 void NetSession::SendHangupToAll()
 {
-    for( auto& pair : m_connections )
+    for( NetConnection* connection : m_connections )
     {
         NetMessage* msg = EngineNetMessages::Compose_Hangup();
-        uint8 idx = pair.first;
-        SendToConnection( idx, msg );
+        SendToConnection( connection->m_idxInSession, msg );
     }
     Flush( true );
 }
@@ -146,7 +196,7 @@ void NetSession::SendHangupToAll()
 bool NetSession::ProcessJoinRequest( NetMessage* msg )
 {
     NetAddress senderAddr = msg->m_senderAddress;
-    uint8 idx = GetAvailableConnectionIdx();
+    ConnectionIdx idx = GetAvailableConnectionIdx();
 
     if( !IsHost() || ReachedMaxClients()
         || ( idx == INVALID_CONNECTION_INDEX ) )
@@ -175,7 +225,7 @@ bool NetSession::ProcessJoinDeny( NetMessage* msg )
     return true;
 }
 
-bool NetSession::ProcessJoinAccept( uint8 assignedIdx )
+bool NetSession::ProcessJoinAccept( ConnectionIdx assignedIdx )
 {
     BindConnection( assignedIdx, m_myConnection );
     m_myConnection->SetState( eConnectionState::CONNECTED );
@@ -207,15 +257,53 @@ bool NetSession::ProcessUpdateConnectionState( NetMessage* msg,
 bool NetSession::ProcessHangup( NetMessage* msg )
 {
     LOG_INFO_TAG( "Net", "Graceful hangup" );
-    uint8 connectionIdx = msg->m_senderIdx;
-    if( ContainerUtils::ContainsKey( m_connections, connectionIdx ) )
+    NetConnection* connection = GetConnection( msg->m_senderIdx );
+    if( connection )
     {
-        delete m_connections[connectionIdx];
-        m_connections.erase( connectionIdx );
+        RemoveBoundConnection( connection );
+        delete connection;
     }
     return true;
 }
 
+bool NetSession::ProcessFragment( NetMessage* msg, uint16 transferID,
+                                  uint16 fragmentIdx, uint16 fragmentCount )
+{
+    NetConnection* connection = GetConnection( msg->m_senderIdx );
+    size_t byteCount = msg->GetReadableByteCount();
+    NetMessage* assembled = nullptr;
+    bool addSuccess = connection->m_fragmentAssembler.Add(
+        transferID, fragmentIdx, fragmentCount,
+        msg->GetReadHeadPtr(), byteCount, assembled );
+    msg->OffsetReadHead( (int) byteCount );
+    if( !addSuccess )
+        return false;
+    // more to come
+    if( assembled == nullptr )
+        return true;
+
+    assembled->m_senderAddress = msg->m_senderAddress;
+    assembled->m_senderIdx = msg->m_senderIdx;
+    assembled->m_receiverIdx = msg->m_receiverIdx;
+    bool success = assembled->UnpackHeader();
+    // fragments were the reliables, what they made only keeps its order
+    if( success && !assembled->m_def->IsReliable() )
+    {
+        LOG_WARNING_TAG( "Net", "Fragmented [%s] is not reliable",
+                         assembled->m_def->GetName().c_str() );
+        success = false;
+    }
+    if( success )
+    {
+        if( assembled->m_def->IsInOrder() )
+            success = ProcessInOrderMessage( *assembled );
+        else
+            success = RunMessageCallback( *assembled );
+    }
+    delete assembled;
+    return success;
+}
+
 bool NetSession::ProcessHeartbeat( NetMessage* msg, uint hostTimeMS )
 {
     if( IsHost() )
@@ -264,14 +352,21 @@ void NetSession::Finalize()
     NetMessageDatabase::Finalize();
 }
 
-NetConnection* NetSession::AddConnection( uint8 idx, const NetAddress& addr )
+NetConnection* NetSession::AddConnection( ConnectionIdx idx, const NetAddress& addr )
 {
-    if( ContainerUtils::ContainsKey( m_connections, idx ) )
+    if( idx >= MAX_CONNECTION_COUNT )
+    {
+        LOG_WARNING_TAG( "Net", "Connection index [%d] is out of range", idx );
+        return nullptr;
+    }
+    NetConnection* existing = m_connectionSlots[idx];
+    if( existing )
     {
         LOG_WARNING_TAG(
             "Net", "Connection index [%d] already exists, replacing", idx );
 
-        delete m_connections[idx];
+        RemoveBoundConnection( existing );
+        delete existing;
     }
     LOG_INFO_TAG( "Net", "Connection added at index [%d]", idx );
 
@@ -280,7 +375,8 @@ NetConnection* NetSession::AddConnection( uint8 idx, const NetAddress& addr )
     connection->m_owningSession = this;
     connection->m_idxInSession = idx;
     connection->m_isClosed = false;
-    m_connections[idx] = connection;
+    AddBoundConnection( idx, connection );
+    ConfigureLink( connection, m_defaultSendLink, m_defaultReceiveLink );
 
     if( addr == GetMyAddress() )
         m_myConnectionIdx = idx;
@@ -288,46 +384,45 @@ NetConnection* NetSession::AddConnection( uint8 idx, const NetAddress& addr )
     return connection;
 }
 
-NetConnection* NetSession::AddConnectionSelf( uint8 idx )
+NetConnection* NetSession::AddConnectionSelf( ConnectionIdx idx )
 {
     return AddConnection( idx, GetMyAddress() );
 }
 
-NetConnection* NetSession::GetConnection( uint8 idx )
+NetConnection* NetSession::GetConnection( ConnectionIdx idx )
 {
-    if( !ContainerUtils::ContainsKey( m_connections, idx ) )
-    {
+    ScopedSessionLock lock( this );
+    if( idx >= MAX_CONNECTION_COUNT )
         return nullptr;
-    }
-    return m_connections[idx];
+    return m_connectionSlots[idx];
 }
 
 NetConnection* NetSession::GetConnection( const NetAddress& addr )
 {
-    for( auto& pair : m_connections )
-    {
-        if( pair.second->m_address == addr )
-            return pair.second;
-    }
-    return nullptr;
+    ScopedSessionLock lock( this );
+    auto found = m_connectionsByAddress.find( addr );
+    if( found == m_connectionsByAddress.end() )
+        return nullptr;
+    return found->second;
 }
 
 void NetSession::CloseAllConnections()
 {
-    for( auto& pair : m_connections )
+    for( NetConnection* connection : m_connections )
     {
-        pair.second->Close();
+        connection->Close();
     }
 }
 
 NetConnection* NetSession::GetMyConnection()
 {
-    return m_connections[m_myConnectionIdx];
+    return GetConnection( m_myConnectionIdx );
 }
 
 NetAddress NetSession::GetMyAddress()
 {
-    return m_packetChannel->m_socket->m_address;
+    // same as the socket address, but also set while replaying without one
+    return m_boundAddress;
 }
 
 
@@ -344,7 +439,8 @@ NetConnection* NetSession::CreateConnection( const NetAddress& addr )
 void NetSession::DestroyConnection( NetConnection* connection )
 {
     ContainerUtils::EraseOneValue( m_unboundConnections, connection );
-    ContainerUtils::EraseOneValue( m_connections, connection );
+    if( GetConnection( connection->m_idxInSession ) == connection )
+        RemoveBoundConnection( connection );
     if( m_myConnection == connection )
         m_myConnection = nullptr;
     if( m_hostConnection == connection )
@@ -352,26 +448,111 @@ void NetSession::DestroyConnection( NetConnection* connection )
     delete connection;
 }
 
-void NetSession::BindConnection( uint8 idx, NetConnection* connection )
+void NetSession::BindConnection( ConnectionIdx idx, NetConnection* connection )
 {
-    if( ContainerUtils::ContainsKey( m_connections, idx ) )
+    if( idx >= MAX_CONNECTION_COUNT )
+    {
+        LOG_WARNING_TAG( "Net", "Connection index [%d] is out of range", idx );
+        return;
+    }
+    NetConnection* existing = m_connectionSlots[idx];
+    if( existing )
     {
         LOG_WARNING_TAG(
             "Net", "Connection index [%d] already exists, replacing", idx );
 
-        delete m_connections[idx];
+        RemoveBoundConnection( existing );
+        delete existing;
     }
     LOG_INFO_TAG( "Net", "Connection bound at index [%d]", idx );
 
-    m_connections[idx] = connection;
-    connection->m_idxInSession = idx;
     ContainerUtils::EraseOneValue( m_unboundConnections, connection );
+    AddBoundConnection( idx, connection );
+    ConfigureLink( connection, m_defaultSendLink, m_defaultReceiveLink );
 
     if( connection == m_myConnection )
         m_myConnectionIdx = idx;
 }
 
+void NetSession::AddBoundConnection( ConnectionIdx idx, NetConnection* connection )
+{
+    connection->m_idxInSession = idx;
+    connection->m_idxInConnectionList = m_connections.size();
+    m_connections.push_back( connection );
+    m_connectionSlots[idx] = connection;
+    if( !m_freeConnectionIdxs.empty() && m_freeConnectionIdxs.back() == idx )
+    {
+        m_freeConnectionIdxs.pop_back();
+        m_isConnectionIdxInFreeList[idx] = false;
+    }
+    // first bound wins, a second connection from one address is only
+    // reachable by index
+    m_connectionsByAddress.emplace( connection->m_address, connection );
+    // my connection never sends or receives packets, see QueueLoopback
+    if( connection != m_myConnection )
+        connection->StartTimers();
+}
+
+void NetSession::ResetConnectionSlots()
+{
+    m_connectionSlots.assign( MAX_CONNECTION_COUNT, nullptr );
+    m_freeConnectionIdxs.clear();
+    m_freeConnectionIdxs.reserve( MAX_CONNECTION_COUNT );
+    for( size_t idx = MAX_CONNECTION_COUNT; idx > 0; --idx )
+        m_freeConnectionIdxs.push_back( (ConnectionIdx) ( idx - 1 ) );
+    m_isConnectionIdxInFreeList.assign( MAX_CONNECTION_COUNT, true );
+    m_connectionsByAddress.clear();
+}
+
+void NetSession::RemoveBoundConnection( NetConnection* connection )
+{
+    connection->StopTimers();
+    if( connection->m_hasConditionedLink )
+    {
+        connection->m_hasConditionedLink = false;
+        --m_conditionedLinkCount;
+    }
+
+    // swap with the back so removal does not shift the list
+    size_t listIdx = connection->m_idxInConnectionList;
+    NetConnection* last = m_connections.back();
+    m_connections[listIdx] = last;
+    last->m_idxInConnectionList = listIdx;
+    m_connections.pop_back();
+
+    ConnectionIdx idx = connection->m_idxInSession;
+    m_connectionSlots[idx] = nullptr;
+    // still in there if it was bound by index without being popped
+    if( !m_isConnectionIdxInFreeList[idx] )
+    {
+        m_freeConnectionIdxs.push_back( idx );
+        m_isConnectionIdxInFreeList[idx] = true;
+    }
+
+    auto found = m_connectionsByAddress.find( connection->m_address );
+    if( found != m_connectionsByAddress.end() && found->second == connection )
+        m_connectionsByAddress.erase( found );
+}
+
 void NetSession::Update()
+{
+    if( IsNetThreadRunning() )
+    {
+        RunQueuedGameMessages();
+        ScopedSessionLock lock( this );
+        if( m_state != eSessionState::DISCONNECTED )
+            UpdateNetClock();
+        m_stats.UpdatePeriodicDump( TimeUtils::GetCurrentTimeSecondsF(), m_connections );
+        return;
+    }
+
+    UpdateConnections();
+    if( m_state != eSessionState::DISCONNECTED )
+        UpdateNetClock();
+    m_stats.UpdatePeriodicDump( TimeUtils::GetCurrentTimeSecondsF(), m_connections );
+}
+
+void NetSession::UpdateConnections()
 {
     if( m_state == eSessionState::SHOULD_DISCONNECT )
     {
@@ -402,88 +583,124 @@ void NetSession::Update()
             m_state = eSessionState::READY;
     }
 
-#ifdef SIM_NET_LATENCY
-    ProcessIncommingWithLatency();
-#else
-    ProcessIncommingImmediate();
-#endif // SIM_NET_LATENCY
-
-    UpdateNetClock();
+    ProcessIncomming();
 
     CheckForTimeoutConnections();
-
-
 }
 
-void NetSession::ProcessIncommingWithLatency()
+void NetSession::ProcessIncomming()
 {
-    Random& rnd = *Random::Default();
-    NetPacket* packet = new NetPacket();
-    while( m_packetChannel->Receive( *packet ) )
-    {
-        if( ShouldDiscardPacketForLossSim() )
-            continue;
-
-        packet->m_timeOfReceive = TimeUtils::GetCurrentTimeSecondsF()
-            + rnd.FloatInRange( m_minSimLatency, m_maxSimLatency );
-        m_queuedPacketsToProcess.push( packet );
-        packet = new NetPacket();
-    }
-    delete packet;
+    ProcessLoopback();
 
-    while( !m_queuedPacketsToProcess.empty() )
+    float currentTime = TimeUtils::GetCurrentTimeSecondsF();
+    size_t receivedCount = PACKET_BATCH_SIZE;
+    while( receivedCount == PACKET_BATCH_SIZE )
     {
-        NetPacket* packetToProcess = m_queuedPacketsToProcess.top();
-        if( packetToProcess->m_timeOfReceive < TimeUtils::GetCurrentTimeSecondsF() )
+        receivedCount = m_packetChannel->ReceiveBatch(
+            m_receiveBatch, PACKET_BATCH_SIZE );
+        for( size_t i = 0; i < receivedCount; ++i )
         {
-            bool processSuccess = ProcessPacket( *packetToProcess );
-            if( !processSuccess )
+            NetPacket*& packet = m_receiveBatch[i];
+            LinkConditioner* conditioner = GetReceiveConditioner( *packet, true );
+            if( conditioner == nullptr )
             {
-                // bad packet, update connection with this info
-                LOG_WARNING_TAG(
-                    "Net", "Bad Packet from %s",
-                    packetToProcess->m_senderAddress.ToStringAll().c_str() );
-                LOG_WARNING_TAG(
-                    "Net", "Bad Packet Data: %s",
-                    packetToProcess->ToString().c_str() );
+                ProcessReceivedPacket( *packet );
+                continue;
             }
-            NetConnection* connection =
-                GetConnection( packetToProcess->m_senderIdx );
-            if( connection )
-                connection->OnReceivePacket( *packetToProcess, processSuccess );
+            // the conditioner takes the packet, the batch slot gets a fresh one
+            conditioner->Submit( packet, currentTime );
+            packet = new NetPacket();
+        }
+    }
 
-            delete packetToProcess;
-            m_queuedPacketsToProcess.pop();
+    // the session wide conditioner feeds the per connection ones
+    NetPacket* packet = m_receiveConditioner.PopReady( currentTime );
+    while( packet )
+    {
+        LinkConditioner* conditioner = GetReceiveConditioner( *packet, false );
+        if( conditioner )
+        {
+            conditioner->Submit( packet, currentTime );
         }
         else
         {
-            break;
+            ProcessReceivedPacket( *packet );
+            delete packet;
         }
+        packet = m_receiveConditioner.PopReady( currentTime );
     }
+
+    // collected first, processing can remove connections
+    if( m_conditionedLinkCount != 0 )
+    {
+        for( NetConnection* connection : m_connections )
+        {
+            LinkConditioner& conditioner = connection->m_receiveConditioner;
+            packet = conditioner.PopReady( currentTime );
+            while( packet )
+            {
+                m_conditionedPackets.push_back( packet );
+                packet = conditioner.PopReady( currentTime );
+            }
+        }
+    }
+    for( NetPacket* readyPacket : m_conditionedPackets )
+    {
+        ProcessReceivedPacket( *readyPacket );
+        delete readyPacket;
+    }
+    m_conditionedPackets.clear();
 }
 
-void NetSession::ProcessIncommingImmediate()
+void NetSession::QueueLoopback( NetMessage* message )
 {
-    NetPacket packet;
-    while( m_packetChannel->Receive( packet ) )
+    message->m_senderIdx = m_myConnectionIdx;
+    message->m_receiverIdx = m_myConnectionIdx;
+    message->m_senderAddress = m_boundAddress;
+    message->SetReadHead( message->m_def->GetHeaderSize() );
+    m_loopbackMessages.push( message );
+}
+
+void NetSession::ProcessLoopback()
+{
+    // sends from these callbacks wait for the next receive
+    size_t count = m_loopbackMessages.size();
+    for( size_t idx = 0; idx < count; ++idx )
     {
-        if( ShouldDiscardPacketForLossSim() )
-            continue;
+        NetMessage* message = m_loopbackMessages.front();
+        m_loopbackMessages.pop();
+        m_stats.RecordReceive( message->GetMessageID(), message->GetWrittenByteCount() );
+        RunMessageCallback( *message );
+        delete message;
+    }
+}
 
-        bool processSuccess = ProcessPacket( packet );
-        if( !processSuccess )
-        {
-            // bad packet, update connection with this info
-            LOG_WARNING_TAG( "Net", "Bad Packet from %s",
-                             packet.m_senderAddress.ToStringAll().c_str() );
-            LOG_WARNING_TAG( "Net", "Bad Packet Data: %s",
-                             packet.ToString().c_str() );
-        }
-        NetConnection* connection = GetConnection( packet.m_senderIdx );
-        if( connection )
-            connection->OnReceivePacket( packet, processSuccess );
+LinkConditioner* NetSession::GetReceiveConditioner( const NetPacket& packet,
+                                                    bool includeSessionWide )
+{
+    if( includeSessionWide && m_receiveConditioner.IsActive() )
+        return &m_receiveConditioner;
+
+    NetConnection* connection = GetConnection( packet.m_senderIdx );
+    if( connection && connection->m_receiveConditioner.IsActive() )
+        return &connection->m_receiveConditioner;
+    return nullptr;
+}
 
+void NetSession::ProcessReceivedPacket( NetPacket& packet )
+{
+    bool processSuccess = ProcessPacket( packet );
+    if( !processSuccess )
+    {
+        // bad packet, update connection with this info
+        LOG_WARNING_TAG( "Net", "Bad Packet from %s",
+                         packet.m_senderAddress.ToStringAll().c_str() );
+        LOG_WARNING_TAG( "Net", "Bad Packet Data: %s",
+                         packet.ToString().c_str() );
     }
+    NetConnection* connection = GetConnection( packet.m_senderIdx );
+    if( connection )
+        connection->OnReceivePacket( packet, processSuccess );
 }
 
 bool NetSession::ProcessPacket( NetPacket& packet )
@@ -507,6 +724,7 @@ bool NetSession::ProcessPacket( NetPacket& packet )
     NetMessage msg;
     for( int msgIdx = 0; msgIdx < packet.m_header.m_message_count; ++msgIdx )
     {
+        size_t readHeadBefore = packet.GetReadHead();
         if( !packet.ExtractMessage( msg ) )
         {
             LOG_WARNING_TAG(
@@ -514,6 +732,7 @@ bool NetSession::ProcessPacket( NetPacket& packet )
                 "ExtractMessage Failed!" );
             return false;
         }
+        m_stats.RecordReceive( msg.GetMessageID(), packet.GetReadHead() - readHeadBefore );
 
         if( !ProcessMessage( msg ) )
         {
@@ -580,7 +799,23 @@ bool NetSession::RunMessageCallback( NetMessage& message )
 {
     const NetMessageDefinition* def = message.m_def;
     MessageID msgID = message.GetMessageID();
-    if( !def->m_callback( &message ) )
+
+    // core messages manage the session and stay on the net thread
+    if( IsOnNetThread() && msgID >= NET_CORE_COUNT )
+    {
+        QueueForGameThread( message );
+        return true;
+    }
+
+    double callbackStartTime = TimeUtils::GetCurrentTimeSecondsD();
+    bool callbackSuccess = def->m_callback( &message );
+    double callbackSeconds = TimeUtils::GetCurrentTimeSecondsD() - callbackStartTime;
+    {
+        // game callbacks run unlocked on the game thread while threaded
+        ScopedSessionLock lock( this );
+        m_stats.RecordCallback( msgID, callbackSeconds );
+    }
+    if( !callbackSuccess )
     {
         LOG_WARNING_TAG( "Net", "MessageID [%d] callback failed", msgID );
         return false;
@@ -621,25 +856,65 @@ bool NetSession::ProcessInOrderMessage( NetMessage& message )
     }
     else
     {
-        channel->CloneAndPushMessage( &message );
-        return true;
+        return channel->CloneAndPushMessage( &message );
     }
 }
 
 void NetSession::Flush( bool forced )
 {
+    // the net thread flushes on its own
+    if( IsNetThreadRunning() && !IsLockedByThisThread() )
+        return;
     if( m_state == eSessionState::DISCONNECTED )
         return;
-    for( auto& pair : m_connections )
+    float currentTime = TimeUtils::GetCurrentTimeSecondsF();
+    m_bandwidth.Refill( currentTime );
+    if( forced )
     {
-        if( pair.second->IsClosed() )
-            continue;
+        for( NetConnection* connection : m_connections )
+        {
+            if( !connection->IsClosed() )
+                connection->Flush();
+        }
+    }
+    RunDueTimers();
 
-        if( forced )
-            pair.second->Flush();
-        else
-            pair.second->FlushIfTimeUp();
+    if( m_conditionedLinkCount != 0 )
+    {
+        for( NetConnection* connection : m_connections )
+        {
+            connection->SendConditionedPackets( currentTime );
+
+            // switched off and drained, stop walking it
+            LinkConditioner& send = connection->m_sendConditioner;
+            LinkConditioner& receive = connection->m_receiveConditioner;
+            if( connection->m_hasConditionedLink
+                && !send.IsActive() && send.GetHeldCount() == 0
+                && !receive.IsActive() && receive.GetHeldCount() == 0 )
+            {
+                connection->m_hasConditionedLink = false;
+                --m_conditionedLinkCount;
+            }
+        }
     }
+
+    // everything the connections queued goes out in one batch
+    m_packetChannel->FlushSends();
+}
+
+void NetSession::RunDueTimers()
+{
+    double currentTime = TimeUtils::GetCurrentTimeSecondsD();
+    m_timerWheel.Advance( currentTime, m_dueTimers );
+    for( TimerWheelEntry* timer : m_dueTimers )
+    {
+        // armed again by an earlier timer in this batch, goes at its new time
+        if( timer->IsScheduled() )
+            continue;
+        NetConnection* connection = (NetConnection*) timer->m_owner;
+        connection->OnTimer( (eConnectionTimer) timer->m_type, currentTime );
+    }
+    m_dueTimers.clear();
 }
 
 void NetSession::SendImmediate( const NetPacket& packet )
@@ -647,6 +922,11 @@ void NetSession::SendImmediate( const NetPacket& packet )
     m_packetChannel->SendImmediate( packet );
 }
 
+void NetSession::QueuePacket( const NetPacket& packet )
+{
+    m_packetChannel->QueueSend( packet );
+}
+
 void NetSession::SendImmediateConnectionless( NetMessage* netMessage,
                                               const NetAddress& addr )
 {
@@ -656,15 +936,23 @@ void NetSession::SendImmediateConnectionless( NetMessage* netMessage,
     PacketHeader& header = packet.m_header;
     header.m_senderConnectionIdx = INVALID_CONNECTION_INDEX;
 
-    packet.WriteMessage( *netMessage );
+    if( packet.WriteMessage( *netMessage ) )
+    {
+        m_stats.RecordSend( netMessage->m_id,
+                            packet.GetWrittenByteCount() - sizeof( PacketHeader ),
+                            false );
+    }
 
     packet.PackHeader();
     SendImmediate( packet );
     delete netMessage;
 }
 
-bool NetSession::SendToConnection( uint8 idx, NetMessage* message )
+bool NetSession::SendToConnection( ConnectionIdx idx, NetMessage* message )
 {
+    if( IsNetThreadRunning() && !IsLockedByThisThread() )
+        return QueueForNetThread( eSendTarget::CONNECTION, idx, message );
+
     NetConnection* connection = GetConnection( idx );
     if( !connection )
     {
@@ -680,12 +968,14 @@ bool NetSession::SendToConnection( uint8 idx, NetMessage* message )
 
 bool NetSession::SendToAll( NetMessage* message )
 {
+    if( IsNetThreadRunning() && !IsLockedByThisThread() )
+        return QueueForNetThread( eSendTarget::ALL, INVALID_CONNECTION_INDEX, message );
+
     bool success = true;
-    for( auto& pair : m_connections )
+    for( NetConnection* connection : m_connections )
     {
-        uint8 idx = pair.first;
         NetMessage* copyMsg = new NetMessage( *message );
-        if( !SendToConnection( idx, copyMsg ) )
+        if( !SendToConnection( connection->m_idxInSession, copyMsg ) )
             success = false;
     }
     delete message;
@@ -694,10 +984,13 @@ bool NetSession::SendToAll( NetMessage* message )
 
 bool NetSession::SendToAllButMe( NetMessage* message )
 {
+    if( IsNetThreadRunning() && !IsLockedByThisThread() )
+        return QueueForNetThread( eSendTarget::ALL_BUT_ME, INVALID_CONNECTION_INDEX, message );
+
     bool success = true;
-    for( auto& pair : m_connections )
+    for( NetConnection* connection : m_connections )
     {
-        uint8 idx = pair.first;
+        ConnectionIdx idx = connection->m_idxInSession;
         if( idx == m_myConnectionIdx )
             continue;
         NetMessage* copyMsg = new NetMessage( *message );
@@ -715,22 +1008,263 @@ bool NetSession::SendToHost( NetMessage* message )
 
 void NetSession::SetSimLoss( float lossAmount )
 {
-    m_simLossAmount = lossAmount;
+    ScopedSessionLock lock( this );
+    LinkConditionerConfig config = m_receiveConditioner.GetConfig();
+    config.m_lossGood = Clampf01( lossAmount );
+    m_receiveConditioner.SetConfig( config );
 }
 
 void NetSession::SetSimLatency( uint minSimLatencyMS, uint maxSimLatencyMS /*= 0U */ )
 {
-    m_minSimLatency = (float) minSimLatencyMS / 1000;
-    m_maxSimLatency = Max( m_minSimLatency, (float) maxSimLatencyMS / 1000 );
+    ScopedSessionLock lock( this );
+    LinkConditionerConfig config = m_receiveConditioner.GetConfig();
+    config.m_latency = (float) minSimLatencyMS / 1000;
+    config.m_jitter = Max( 0.f, (float) maxSimLatencyMS / 1000 - config.m_latency );
+    config.m_jitterDistribution = eJitterDistribution::UNIFORM;
+    m_receiveConditioner.SetConfig( config );
 }
 
-bool NetSession::ShouldDiscardPacketForLossSim() const
+void NetSession::SetLinkConditioner( ConnectionIdx connectionIdx,
+                                     const LinkConditionerConfig& send,
+                                     const LinkConditionerConfig& receive )
 {
-#ifdef SIM_NET_LOSS
-    return Random::Default()->CheckChance( m_simLossAmount );
-#else
-    return false;
-#endif // SIM_NET_LOSS
+    ScopedSessionLock lock( this );
+    if( connectionIdx == INVALID_CONNECTION_INDEX )
+    {
+        m_defaultSendLink = send;
+        m_defaultReceiveLink = receive;
+        for( NetConnection* connection : m_connections )
+            ConfigureLink( connection, send, receive );
+        return;
+    }
+
+    NetConnection* connection = GetConnection( connectionIdx );
+    if( connection )
+        ConfigureLink( connection, send, receive );
+}
+
+bool NetSession::SetLinkParameter( ConnectionIdx connectionIdx, const string& direction,
+                                   const string& name, const string& value )
+{
+    ScopedSessionLock lock( this );
+    bool setSend = direction == "send" || direction == "both";
+    bool setReceive = direction == "recv" || direction == "both";
+    if( !setSend && !setReceive )
+        return false;
+
+    LinkConditionerConfig send = m_defaultSendLink;
+    LinkConditionerConfig receive = m_defaultReceiveLink;
+    if( connectionIdx != INVALID_CONNECTION_INDEX )
+    {
+        NetConnection* connection = GetConnection( connectionIdx );
+        if( connection == nullptr )
+            return false;
+        send = connection->m_sendConditioner.GetConfig();
+        receive = connection->m_receiveConditioner.GetConfig();
+    }
+
+    if( setSend && !send.SetParameter( name, value ) )
+        return false;
+    if( setReceive && !receive.SetParameter( name, value ) )
+        return false;
+    SetLinkConditioner( connectionIdx, send, receive );
+    return true;
+}
+
+void NetSession::ConfigureLink( NetConnection* connection,
+                                const LinkConditionerConfig& send,
+                                const LinkConditionerConfig& receive )
+{
+    // links get different rolls from one seed, a run still repeats
+    LinkConditionerConfig sendConfig = send;
+    LinkConditionerConfig receiveConfig = receive;
+    uint seedOffset = connection->m_idxInSession * 2U;
+    if( sendConfig.m_seed != 0 )
+        sendConfig.m_seed += seedOffset;
+    if( receiveConfig.m_seed != 0 )
+        receiveConfig.m_seed += seedOffset + 1;
+    connection->m_sendConditioner.SetConfig( sendConfig );
+    connection->m_receiveConditioner.SetConfig( receiveConfig );
+
+    // cleared in Flush once it is switched off and drained
+    if( !connection->m_hasConditionedLink
+        && ( connection->m_sendConditioner.IsActive()
+             || connection->m_receiveConditioner.IsActive() ) )
+    {
+        connection->m_hasConditionedLink = true;
+        ++m_conditionedLinkCount;
+    }
+}
+
+string NetSession::GetLinkConditionerString()
+{
+    ScopedSessionLock lock( this );
+    string str = Stringf( "session recv: %s\n    %s\n",
+                          m_receiveConditioner.GetConfig().ToString().c_str(),
+                          m_receiveConditioner.GetStatsString().c_str() );
+    for( NetConnection* connection : m_connections )
+    {
+        str += Stringf(
+            "[%d] send: %s\n    %s\n[%d] recv: %s\n    %s\n",
+            connection->m_idxInSession,
+            connection->m_sendConditioner.GetConfig().ToString().c_str(),
+            connection->m_sendConditioner.GetStatsString().c_str(),
+            connection->m_idxInSession,
+            connection->m_receiveConditioner.GetConfig().ToString().c_str(),
+            connection->m_receiveConditioner.GetStatsString().c_str() );
+    }
+    return str;
+}
+
+bool NetSession::StartCapture( const string& path )
+{
+    ScopedSessionLock lock( this );
+    return m_packetChannel->StartCapture( path );
+}
+
+void NetSession::StopCapture()
+{
+    ScopedSessionLock lock( this );
+    m_packetChannel->StopCapture();
+}
+
+bool NetSession::StartReplay( const string& path, float speed )
+{
+    ScopedSessionLock lock( this );
+    PacketReplay* replay = new PacketReplay();
+    if( !replay->Load( path ) || replay->IsFinished() )
+    {
+        LOG_WARNING_TAG( "Net", "Nothing to replay in %s", path.c_str() );
+        delete replay;
+        return false;
+    }
+
+    if( m_state == eSessionState::DISCONNECTED )
+    {
+        m_boundAddress = replay->m_myAddress;
+        if( replay->m_isHost )
+            BeginHosting();
+        else
+            BeginJoining( replay->m_hostAddress );
+    }
+    m_packetChannel->StartReplay( replay, speed );
+    return true;
+}
+
+void NetSession::StopReplay()
+{
+    ScopedSessionLock lock( this );
+    m_packetChannel->StopReplay();
+}
+
+string NetSession::GetCaptureStatusString()
+{
+    ScopedSessionLock lock( this );
+    return m_packetChannel->GetCaptureStatusString();
+}
+
+string NetSession::GetStatsReport()
+{
+    ScopedSessionLock lock( this );
+    return m_stats.GetReportString( m_connections );
+}
+
+bool NetSession::WriteStatsToFile( const string& path )
+{
+    ScopedSessionLock lock( this );
+    return m_stats.WriteToFile( path, TimeUtils::GetCurrentTimeSecondsF(),
+                                m_connections, false );
+}
+
+void NetSession::SetStatsDump( const string& path, float intervalSeconds )
+{
+    ScopedSessionLock lock( this );
+    m_stats.SetPeriodicDump( path, intervalSeconds );
+}
+
+void NetSession::ResetStats()
+{
+    ScopedSessionLock lock( this );
+    m_stats.Reset();
+    for( NetConnection* connection : m_connections )
+        connection->m_stats.Reset();
+}
+
+string NetSession::GetChannelStatsString()
+{
+    ScopedSessionLock lock( this );
+    string str;
+    for( NetConnection* connection : m_connections )
+    {
+        for( int channelIdx = 0; channelIdx < MAX_MESSAGE_CHANNELS; ++channelIdx )
+        {
+            NetMessageChannel* channel = connection->m_messageChannels[channelIdx];
+            // skip channels that never received anything
+            if( channel->m_nextExpectedSequenceID == 0 && channel->m_outOfOrderCount == 0 )
+                continue;
+            str += Stringf( "conn %u channel %d  %s\n", connection->m_idxInSession,
+                            channelIdx, channel->GetStatsString().c_str() );
+        }
+    }
+    return str;
+}
+
+void NetSession::ResetChannelStats()
+{
+    ScopedSessionLock lock( this );
+    for( NetConnection* connection : m_connections )
+    {
+        for( int channelIdx = 0; channelIdx < MAX_MESSAGE_CHANNELS; ++channelIdx )
+            connection->m_messageChannels[channelIdx]->ResetStats();
+    }
+}
+
+void NetSession::SetCompressionEnabled( bool enabled )
+{
+    ScopedSessionLock lock( this );
+    m_compressor->m_isEnabled = enabled;
+}
+
+string NetSession::GetCompressionStatsString()
+{
+    ScopedSessionLock lock( this );
+    return m_compressor->GetStatsString();
+}
+
+void NetSession::ResetCompressionStats()
+{
+    ScopedSessionLock lock( this );
+    m_compressor->ResetStats();
+}
+
+void NetSession::StartCompressionTraining()
+{
+    ScopedSessionLock lock( this );
+    m_compressor->StartTraining();
+}
+
+void NetSession::StopCompressionTraining()
+{
+    ScopedSessionLock lock( this );
+    m_compressor->StopTraining();
+}
+
+bool NetSession::LoadCompressionDictionary( const string& path )
+{
+    ScopedSessionLock lock( this );
+    return m_compressor->LoadDictionary( path );
+}
+
+bool NetSession::SaveCompressionDictionary( const string& path )
+{
+    ScopedSessionLock lock( this );
+    return m_compressor->SaveDictionary( path );
+}
+
+void NetSession::ClearCompressionDictionary()
+{
+    ScopedSessionLock lock( this );
+    m_compressor->ClearDictionary();
 }
 
 void NetSession::SetSessionSendRate( float Hz )
@@ -738,18 +1272,42 @@ void NetSession::SetSessionSendRate( float Hz )
     m_sendRate = Hz;
 }
 
-void NetSession::SetConnectionSendRate( uint8 connectionIdx, float Hz )
+void NetSession::SetConnectionSendRate( ConnectionIdx connectionIdx, float Hz )
 {
+    ScopedSessionLock lock( this );
     NetConnection* connection = GetConnection( connectionIdx );
     if( connection )
         connection->SetSendRate( Hz );
 }
 
+void NetSession::SetSessionBandwidthCap( float bytesPerSecond )
+{
+    ScopedSessionLock lock( this );
+    m_bandwidth.SetCap( bytesPerSecond );
+}
+
+void NetSession::SetConnectionBandwidthCap( ConnectionIdx connectionIdx, float bytesPerSecond )
+{
+    ScopedSessionLock lock( this );
+    NetConnection* connection = GetConnection( connectionIdx );
+    if( connection )
+        connection->m_bandwidth.SetCap( bytesPerSecond );
+}
+
+void NetSession::SetCongestionControlEnabled( bool enabled )
+{
+    ScopedSessionLock lock( this );
+    m_isCongestionControlEnabled = enabled;
+    for( NetConnection* connection : m_connections )
+        connection->m_congestion.Reset( connection->GetMaxSendRate() );
+}
+
 void NetSession::SetHeartBeat( float Hz )
 {
-    for( auto& pair : m_connections )
+    ScopedSessionLock lock( this );
+    for( NetConnection* connection : m_connections )
     {
-        pair.second->m_heartbeatRate = Hz;
+        connection->SetHeartbeatRate( Hz );
     }
 }
 
@@ -776,14 +1334,16 @@ bool NetSession::ReachedMaxClients()
     return m_connections.size() >= MAX_CONNECTION_COUNT;
 }
 
-uint8 NetSession::GetAvailableConnectionIdx()
+ConnectionIdx NetSession::GetAvailableConnectionIdx()
 {
-    for( uint8 idx = 0; idx < MAX_CONNECTION_COUNT; ++idx )
+    while( !m_freeConnectionIdxs.empty() )
     {
-        if( GetConnection( idx ) != nullptr )
-            continue;
-        else
+        ConnectionIdx idx = m_freeConnectionIdxs.back();
+        if( m_connectionSlots[idx] == nullptr )
             return idx;
+        // bound by index, see m_freeConnectionIdxs
+        m_freeConnectionIdxs.pop_back();
+        m_isConnectionIdxInFreeList[idx] = false;
     }
     return INVALID_CONNECTION_INDEX;
 }
@@ -810,29 +1370,33 @@ void NetSession::CheckForTimeoutConnections()
         }
     }
 
-    for( auto iter = m_connections.cbegin(); iter != m_connections.cend(); )
+    // bound ones whose timeout timer fired
+    for( ConnectionIdx idx : m_timedOutConnectionIdxs )
     {
-        NetConnection* connection = iter->second;
-        if( connection->DidTimeout() )
+        // removed or replaced since it fired
+        NetConnection* connection = GetConnection( idx );
+        if( connection == nullptr )
+            continue;
+        if( !connection->DidTimeout() )
         {
-            if( connection == m_hostConnection )
-            {
-                m_hostConnection = nullptr;
-                ShouldDisconnect();
-            }
-            if( connection == m_myConnection )
-            {
-                m_myConnection = nullptr;
-                ShouldDisconnect();
-            }
-            delete connection;
-            iter = m_connections.erase( iter ); // returned iter is next iter
+            connection->ArmTimeout();
+            continue;
         }
-        else
+
+        if( connection == m_hostConnection )
         {
-            ++iter;
+            m_hostConnection = nullptr;
+            ShouldDisconnect();
+        }
+        if( connection == m_myConnection )
+        {
+            m_myConnection = nullptr;
+            ShouldDisconnect();
         }
+        RemoveBoundConnection( connection );
+        delete connection;
     }
+    m_timedOutConnectionIdxs.clear();
 }
 
 void NetSession::UpdateNetClock()
@@ -872,8 +1436,144 @@ void NetSession::UpdateNetClock()
     }
 }
 
-bool NetSession::GreaterThanByTime::operator()(
-    const NetPacket* lhs, const NetPacket* rhs ) const
+void NetSession::StartNetThread()
+{
+    if( IsNetThreadRunning() )
+        return;
+
+    // messages are made on one thread and freed on the other
+    NetMessage::GetPool().SetThreadSafe( true );
+    NetPacket::GetPool().SetThreadSafe( true );
+
+    m_isNetThreadRunning = true;
+    m_netThread = Thread::Create( &NetSession::NetThreadMain, this );
+    LOG_INFO_TAG( "Net", "Net thread started" );
+}
+
+void NetSession::StopNetThread()
+{
+    if( !IsNetThreadRunning() )
+        return;
+
+    m_isNetThreadRunning = false;
+    Thread::Join( m_netThread );
+    delete m_netThread;
+    m_netThread = nullptr;
+
+    // nothing is dropped, both directions are finished here
+    SendQueuedFromGameThread();
+    while( !m_incomingOverflow.empty() || m_incomingGameMessages.GetCount() != 0 )
+    {
+        PushOverflowToGameThread();
+        RunQueuedGameMessages();
+    }
+
+    NetMessage::GetPool().SetThreadSafe( false );
+    NetPacket::GetPool().SetThreadSafe( false );
+    LOG_INFO_TAG( "Net", "Net thread stopped" );
+}
+
+bool NetSession::IsOnNetThread() const
+{
+    return s_isNetThread;
+}
+
+void NetSession::Lock()
+{
+    m_lock.lock();
+    ++s_lockDepth;
+}
+
+void NetSession::Unlock()
+{
+    --s_lockDepth;
+    m_lock.unlock();
+}
+
+bool NetSession::IsLockedByThisThread() const
+{
+    return s_lockDepth > 0;
+}
+
+void NetSession::NetThreadMain()
+{
+    s_isNetThread = true;
+    while( m_isNetThreadRunning )
+    {
+        {
+            ScopedSessionLock lock( this );
+            SendQueuedFromGameThread();
+            UpdateConnections();
+            Flush();
+            PushOverflowToGameThread();
+        }
+        Thread::SleepMS( NET_THREAD_SLEEP_MS );
+    }
+    s_isNetThread = false;
+}
+
+bool NetSession::QueueForNetThread( eSendTarget target, ConnectionIdx idx, NetMessage* message )
 {
-    return lhs->m_timeOfReceive > rhs->m_timeOfReceive;
+    QueuedSend send;
+    send.m_message = message;
+    send.m_connectionIdx = idx;
+    send.m_target = target;
+    if( !m_outgoingGameMessages.Push( send ) )
+    {
+        LOG_WARNING_TAG( "Net", "Net thread send queue is full, [%s] dropped",
+                         message->m_def->m_name.c_str() );
+        delete message;
+        return false;
+    }
+    return true;
+}
+
+void NetSession::RunQueuedGameMessages()
+{
+    NetMessage* message;
+    while( m_incomingGameMessages.Pop( &message ) )
+    {
+        // failures are logged by the callback check, the packet is long gone
+        RunMessageCallback( *message );
+        delete message;
+    }
+}
+
+void NetSession::QueueForGameThread( NetMessage& message )
+{
+    // the message is a view into the packet, the copy owns its bytes
+    NetMessage* copy = new NetMessage( message );
+    if( !m_incomingOverflow.empty() || !m_incomingGameMessages.Push( copy ) )
+        m_incomingOverflow.push( copy );
+}
+
+void NetSession::PushOverflowToGameThread()
+{
+    while( !m_incomingOverflow.empty()
+           && m_incomingGameMessages.Push( m_incomingOverflow.front() ) )
+    {
+        m_incomingOverflow.pop();
+    }
+}
+
+void NetSession::SendQueuedFromGameThread()
+{
+    QueuedSend send;
+    while( m_outgoingGameMessages.Pop( &send ) )
+    {
+        switch( send.m_target )
+        {
+        case eSendTarget::CONNECTION:
+            SendToConnection( send.m_connectionIdx, send.m_message );
+            break;
+        case eSendTarget::ALL:
+            SendToAll( send.m_message );
+            break;
+        case eSendTarget::ALL_BUT_ME:
+            SendToAllButMe( send.m_message );
+            break;
+        default:
+            break;
+        }
+    }
 }
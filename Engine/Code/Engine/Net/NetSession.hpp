@@ -2,9 +2,18 @@
 
 #include "Engine/Net/NetCommonH.hpp"
 #include "Engine/Net/NetAddress.hpp"
+#include "Engine/Net/CongestionController.hpp"
+#include "Engine/Net/LinkConditioner.hpp"
+#include "Engine/Net/NetStats.hpp"
+#include "Engine/Net/TimerWheel.hpp"
+#include "Engine/Thread/Thread.hpp"
+#include "Engine/Thread/SPSCQueue.hpp"
 
 #include <map>
+#include <unordered_map>
 #include <queue>
+#include <mutex>
+#include <atomic>
 
 class Clock;
 class Timer;
@@ -33,34 +42,44 @@ public:
     // Message processing
     bool ProcessJoinRequest( NetMessage* msg );
     bool ProcessJoinDeny( NetMessage* msg );
-    bool ProcessJoinAccept( uint8 assignedIdx );
+    bool ProcessJoinAccept( ConnectionIdx assignedIdx );
     bool ProcessNewConnection( NetMessage* msg );
     bool ProcessJoinFinished( NetMessage* msg );
     bool ProcessUpdateConnectionState( NetMessage* msg, eConnectionState state );
     bool ProcessHangup( NetMessage* msg );
     bool ProcessHeartbeat( NetMessage* msg, uint hostTimeMS );
+    // reads the rest of msg, runs the whole message once the last fragment is in
+    bool ProcessFragment( NetMessage* msg, uint16 transferID,
+                          uint16 fragmentIdx, uint16 fragmentCount );
 
     // Starting a session (finalizes definitions - can't add more once
     // the session is running)
     bool BindToPort( int port, uint rangeToTry = 0U );
     void Finalize();
+    // the rest of Host and Join once m_boundAddress is set
+    void BeginHosting();
+    void BeginJoining( const NetAddress& hostAddr );
 
     // Connection management
-    NetConnection* AddConnection( uint8 idx, const NetAddress& addr );
-    NetConnection* AddConnectionSelf( uint8 idx );
-    NetConnection* GetConnection( uint8 idx );
+    NetConnection* AddConnection( ConnectionIdx idx, const NetAddress& addr );
+    NetConnection* AddConnectionSelf( ConnectionIdx idx );
+    NetConnection* GetConnection( ConnectionIdx idx );
     NetConnection* GetConnection( const NetAddress& addr );
     void CloseAllConnections();
-    uint8 GetMyConnectionIdx() const { return m_myConnectionIdx; }
+    ConnectionIdx GetMyConnectionIdx() const { return m_myConnectionIdx; }
     NetConnection* GetMyConnection();
     NetAddress GetMyAddress();
 
     NetConnection* CreateConnection( const NetAddress& addr );
     void DestroyConnection( NetConnection* connection );
-    void BindConnection( uint8 idx, NetConnection* connection );
+    void BindConnection( ConnectionIdx idx, NetConnection* connection );
 
     // updates
+    // with the net thread running this only runs the queued game message
+    // callbacks and the net clock
     void Update();
+    // receive, process and timeouts, on the net thread if it is running
+    void UpdateConnections();
 
     bool ProcessPacket( NetPacket& packet );
     bool ProcessMessage( NetMessage& message );
@@ -72,15 +91,18 @@ public:
     void Flush(bool forced = false);
 
     void SendImmediate( const NetPacket& packet );
+    // batched, goes out at the end of Flush
+    void QueuePacket( const NetPacket& packet );
     // takes ownership of netMessage, only works for connectionless
     void SendImmediateConnectionless( NetMessage* netMessage,
                                       const NetAddress& addr );
-    bool SendToConnection( uint8 idx, NetMessage* message ); // takes ownership of netMessage
+    bool SendToConnection( ConnectionIdx idx, NetMessage* message ); // takes ownership of netMessage
     bool SendToAll( NetMessage* message ); // takes ownership of netMessage
     bool SendToAllButMe( NetMessage* message ); // takes ownership of netMessage
     bool SendToHost( NetMessage* message ); // takes ownership of netMessage
 
     // network condition simulation
+    // SetSimLoss and SetSimLatency apply to every received packet
     // 1 for all loss
     // 0 for no loss
     void SetSimLoss( float lossAmount );
@@ -88,10 +110,53 @@ public:
     // if max is 0, range will be [min-min]
     void SetSimLatency( uint minAddedLatencyMS, uint maxAddedLatencyMS = 0U );
 
-    bool ShouldDiscardPacketForLossSim() const;
+    // per connection, INVALID_CONNECTION_INDEX for every connection including
+    // ones that join later. Seeds are offset per connection so links differ
+    // but a run repeats
+    void SetLinkConditioner( ConnectionIdx connectionIdx,
+                             const LinkConditionerConfig& send,
+                             const LinkConditionerConfig& receive );
+    // direction is send, recv or both, see LinkConditionerConfig::SetParameter
+    bool SetLinkParameter( ConnectionIdx connectionIdx, const string& direction,
+                           const string& name, const string& value );
+    string GetLinkConditionerString();
+
+    // capture and replay, see PacketCapture and PacketReplay
+    bool StartCapture( const string& path );
+    void StopCapture();
+    // a disconnected session hosts or joins like the captured one did,
+    // without binding a socket. speed 0 replays everything at once
+    bool StartReplay( const string& path, float speed );
+    void StopReplay();
+    string GetCaptureStatusString();
+
+    // stats, see NetStats, files are .csv or .json from the extension
+    string GetStatsReport();
+    bool WriteStatsToFile( const string& path );
+    // appends a dump every interval, 0 stops
+    void SetStatsDump( const string& path, float intervalSeconds );
+    void ResetStats();
+    // one line per channel that has received anything
+    string GetChannelStatsString();
+    void ResetChannelStats();
+
+    // compression, see PacketCompressor, the net thread compresses with it
+    void SetCompressionEnabled( bool enabled );
+    string GetCompressionStatsString();
+    void ResetCompressionStats();
+    void StartCompressionTraining();
+    void StopCompressionTraining();
+    bool LoadCompressionDictionary( const string& path );
+    bool SaveCompressionDictionary( const string& path );
+    void ClearCompressionDictionary();
 
     void SetSessionSendRate( float Hz );
-    void SetConnectionSendRate( uint8 connectionIdx, float Hz );
+    void SetConnectionSendRate( ConnectionIdx connectionIdx, float Hz );
+
+    // bytes per second, 0 for no cap
+    void SetSessionBandwidthCap( float bytesPerSecond );
+    void SetConnectionBandwidthCap( ConnectionIdx connectionIdx, float bytesPerSecond );
+    void SetCongestionControlEnabled( bool enabled );
 
     void SetHeartBeat( float Hz );
 
@@ -101,45 +166,129 @@ public:
     eSessionError GetLastError();
 
     bool ReachedMaxClients();
-    uint8 GetAvailableConnectionIdx();
+    // from the free list, the most recently freed index first
+    ConnectionIdx GetAvailableConnectionIdx();
 
+    // bound connections are checked when their timeout timer fires
     void CheckForTimeoutConnections();
 
     // Net Clock
     void UpdateNetClock();
     Clock* GetNetClock() { return m_netClock; };
 
+    // Net thread
+    // The net thread receives, acks, resends and flushes on its own. Messages
+    // outside the core engine ones are handed to the game thread and run in
+    // Update, sends from the game thread are handed to the net thread. Both
+    // hand offs are lock free queues
+    void StartNetThread();
+    void StopNetThread();
+    bool IsNetThreadRunning() const { return m_isNetThreadRunning; }
+    bool IsOnNetThread() const;
+    // the net thread holds this for all its work, game thread calls that
+    // touch connections take it too, recursive
+    void Lock();
+    void Unlock();
+    bool IsLockedByThisThread() const;
+
 public:
 
-    void ProcessIncommingWithLatency();
-    void ProcessIncommingImmediate();
+    enum class eSendTarget : uint8
+    {
+        CONNECTION,
+        ALL,
+        ALL_BUT_ME,
+    };
+
+    struct QueuedSend
+    {
+        NetMessage* m_message = nullptr;
+        ConnectionIdx m_connectionIdx = INVALID_CONNECTION_INDEX;
+        eSendTarget m_target = eSendTarget::CONNECTION;
+    };
+
+    void NetThreadMain();
+    // game thread side of the hand offs
+    bool QueueForNetThread( eSendTarget target, ConnectionIdx idx, NetMessage* message );
+    void RunQueuedGameMessages();
+    // net thread side
+    void QueueForGameThread( NetMessage& message );
+    void PushOverflowToGameThread();
+    void SendQueuedFromGameThread();
+
+    void ProcessIncomming();
+    // messages sent to my own connection, run in the order they were sent
+    // at the start of the next receive, like they would off the socket
+    void QueueLoopback( NetMessage* message );
+    void ProcessLoopback();
+    // nullptr if the packet can be processed right away
+    LinkConditioner* GetReceiveConditioner( const NetPacket& packet,
+                                            bool includeSessionWide );
+    void ProcessReceivedPacket( NetPacket& packet );
+    void ConfigureLink( NetConnection* connection,
+                        const LinkConditionerConfig& send,
+                        const LinkConditionerConfig& receive );
+
+    // bound connection bookkeeping, the slot, the list and the address
+    // table always agree
+    void AddBoundConnection( ConnectionIdx idx, NetConnection* connection );
+    // does not delete the connection
+    void RemoveBoundConnection( NetConnection* connection );
+    // every index free, the lowest handed out first
+    void ResetConnectionSlots();
+    // runs the connection timers that are due
+    void RunDueTimers();
 
     // Connections
     vector<NetConnection*> m_unboundConnections;
-    map<uint8, NetConnection*> m_connections; // all bound connections I know about;
+    // all bound connections I know about, unordered, for walking them
+    vector<NetConnection*> m_connections;
+    // indexed by connection index, nullptr when free
+    vector<NetConnection*> m_connectionSlots;
+    // indices handed out by the host, each at most once, see
+    // m_isConnectionIdxInFreeList. Binding pops the index if it is at the
+    // back, ones bound from further in (clients bind by the host's index)
+    // stay until GetAvailableConnectionIdx skips them
+    vector<ConnectionIdx> m_freeConnectionIdxs;
+    vector<bool> m_isConnectionIdxInFreeList;
+    std::unordered_map<NetAddress, NetConnection*, NetAddressHash> m_connectionsByAddress;
     NetConnection* m_myConnection = nullptr;
     NetConnection* m_hostConnection = nullptr;
     NetAddress m_boundAddress;
     Timer* m_joinTimeoutTimer = nullptr;
 
-    uint8 m_myConnectionIdx = INVALID_CONNECTION_INDEX;
+    ConnectionIdx m_myConnectionIdx = INVALID_CONNECTION_INDEX;
     PacketChannel* m_packetChannel = nullptr; // what we send/receive packets on;
+    NetPacket* m_receiveBatch[PACKET_BATCH_SIZE]; // drained from the channel every update
+
+
+    // Connection flush, heartbeat, resend, update and timeout timers, see
+    // eConnectionTimer. Cost per frame follows the due timers, not the
+    // connection count
+    TimerWheel m_timerWheel;
+    vector<TimerWheelEntry*> m_dueTimers; // reused
+    // fired timeouts, handled with the other timeouts
+    vector<ConnectionIdx> m_timedOutConnectionIdxs;
 
+    // sent to myself, waiting for ProcessLoopback
+    std::queue<NetMessage*> m_loopbackMessages;
 
     // Send rate
     float m_sendRate = DEFAULT_SESSION_SEND_RATE;
+    bool m_isCongestionControlEnabled = true;
+    BandwidthBucket m_bandwidth; // shared by all connections
 
     // network condition simulation
-    float m_simLossAmount = 0.f;
-    float m_minSimLatency = 0.f;
-    float m_maxSimLatency = 0.f;
+    LinkConditioner m_receiveConditioner; // every received packet, see SetSimLoss
+    LinkConditionerConfig m_defaultSendLink;
+    LinkConditionerConfig m_defaultReceiveLink;
+    vector<NetPacket*> m_conditionedPackets; // ready to process, reused
+    // connections with an active or draining conditioner, the per connection
+    // walks are skipped when 0
+    size_t m_conditionedLinkCount = 0;
 
-    // using this for compare puts the oldest time at the top of the queue
-    struct GreaterThanByTime
-    {
-        bool operator()( const NetPacket* lhs, const NetPacket* rhs ) const;
-    };
-    std::priority_queue<NetPacket*, vector<NetPacket*>, GreaterThanByTime> m_queuedPacketsToProcess;
+    // per message type, connections keep their own
+    NetStats m_stats;
 
     // error
     eSessionError m_lastError = eSessionError::OK;
@@ -152,4 +301,16 @@ public:
     float m_desiredClientTime = 0.f;
     Clock* m_netClock = nullptr;
     bool m_shouldResetClock = false;
+
+    // packet compression, off until enabled
+    PacketCompressor* m_compressor = nullptr;
+
+    // Net thread
+    Thread::Handle m_netThread = nullptr;
+    std::atomic<bool> m_isNetThreadRunning { false };
+    std::recursive_mutex m_lock;
+    SPSCQueue<NetMessage*, NET_THREAD_QUEUE_SIZE> m_incomingGameMessages;
+    SPSCQueue<QueuedSend, NET_THREAD_QUEUE_SIZE> m_outgoingGameMessages;
+    // net thread only, keeps the order when the game thread falls behind
+    std::queue<NetMessage*> m_incomingOverflow;
 };
\ No newline at end of file
@@ -11,6 +11,25 @@
 #include "Engine/Core/RuntimeVars.hpp"
 #include "Engine/Time/Clock.hpp"
 
+namespace
+{
+// the three message types that sent the most
+string GetBandwidthHogsString( const NetStats& stats )
+{
+    vector<MessageID> hogs;
+    stats.GetBandwidthHogs( hogs );
+    string str;
+    for( size_t hogIdx = 0; hogIdx < hogs.size() && hogIdx < 3; ++hogIdx )
+    {
+        const NetMessageDefinition* def = NetMessageDatabase::GetDefinitionByID( hogs[hogIdx] );
+        str += Stringf( "%s %uB  ",
+                        def ? def->GetName().c_str() : "?",
+                        (uint) stats.GetMessageStats( hogs[hogIdx] ).GetTotalSentBytes() );
+    }
+    return str;
+}
+}
+
 NetSessionDisplay* NetSessionDisplay::GetDefault()
 {
     static NetSessionDisplay* s_default = nullptr;;
@@ -67,29 +86,38 @@ void NetSessionDisplay::Render()
     if( session->m_state == eSessionState::DISCONNECTED )
         return;
 
+    // the net thread may be changing connections
+    session->Lock();
+    const LinkConditionerConfig& simConfig = session->m_receiveConditioner.GetConfig();
     string infoStr = Stringf(
-        "sim lag: %0.2fs-%0.2fs  sim loss: %0.2f%%  net clock: %0.2fs \n  My Addr:\n    %s \n  Connections:\n"
-        "%-1s %-3s %-22s %-5s %-5s %-4s %-4s %-4s %-4s %-16s\n",
-        session->m_minSimLatency, session->m_maxSimLatency,
-        session->m_simLossAmount * 100,
+        "sim lag: %0.2fs-%0.2fs  sim loss: %0.2f%%  net clock: %0.2fs  net thread: %s \n  %s \n  top bytes: %s \n  My Addr:\n    %s \n  Connections:\n"
+        "%-1s %-3s %-22s %-5s %-5s %-5s %-5s %-6s %-6s %-4s %-4s %-4s %-4s %-16s\n",
+        simConfig.m_latency, simConfig.m_latency + simConfig.m_jitter,
+        simConfig.m_lossGood * 100,
         session->GetNetClock()->GetTimeSinceStartupF(),
-        session->m_packetChannel->m_socket->m_address.ToStringAll().c_str(),
-        "-", "idx", "addr", "rtt/s", "loss%", "lrcv", "lsnt", "oAck", "iAck", "rcvBits"
+        session->IsNetThreadRunning() ? "on" : "off",
+        session->m_compressor->GetStatsString().c_str(),
+        GetBandwidthHogsString( session->m_stats ).c_str(),
+        session->m_boundAddress.ToStringAll().c_str(),
+        "-", "idx", "addr", "rtt/s", "loss%", "hz", "mtu", "outB/s", "inB/s", "lrcv", "lsnt", "oAck", "iAck", "rcvBits"
     );
 
-    for ( auto& pair : session->m_connections )
+    for ( NetConnection* connection : session->m_connections )
     {
         char indicator = ' ';
-        if( pair.first == session->m_myConnectionIdx )
+        if( connection->m_idxInSession == session->m_myConnectionIdx )
             indicator = 'L';
-        NetConnection* connection = pair.second;
         string connectionStr = Stringf(
-            "%-1c %-3d %-22s %-5.2f %-5.1f %-4.2f %-4.2f %-4d %-4d %-16s\n",
+            "%-1c %-3d %-22s %-5.2f %-5.1f %-5.1f %-5u %-6.0f %-6.0f %-4.2f %-4.2f %-4d %-4d %-16s\n",
             indicator,
-            pair.first,
+            connection->m_idxInSession,
             connection->m_address.ToStringAll().c_str(),
             connection->m_roundTripTime,
             connection->CalculateLossRate() * 100.f,
+            1.f / connection->GetEffectiveSendInterval(),
+            (uint) connection->m_congestion.GetPacketBudget(),
+            connection->m_stats.m_bytesSentPerSecond,
+            connection->m_stats.m_bytesReceivedPerSecond,
             TimeUtils::GetCurrentTimeSecondsF() - connection->m_timeOfLastReceive,
             TimeUtils::GetCurrentTimeSecondsF() - connection->m_timeOfLastSend,
             connection->m_nextAckToSend,
@@ -98,6 +126,7 @@ void NetSessionDisplay::Render()
         );
         infoStr += connectionStr;
     }
+    session->Unlock();
     m_infoText->UpdateText( infoStr );
 
     Renderer* renderer = Renderer::GetDefault();
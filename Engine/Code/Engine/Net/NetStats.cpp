@@ -0,0 +1,331 @@
+#include "Engine/Net/NetStats.hpp"
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/FileIO/IOUtils.hpp"
+
+#include <algorithm>
+
+namespace
+{
+string GetMessageName( MessageID id )
+{
+    const NetMessageDefinition* def = NetMessageDatabase::GetDefinitionByID( id );
+    if( def == nullptr )
+        return Stringf( "unknown_%u", id );
+    return def->GetName();
+}
+
+bool IsJsonPath( const string& path )
+{
+    const string extension = ".json";
+    return path.size() >= extension.size()
+        && path.compare( path.size() - extension.size(), extension.size(), extension ) == 0;
+}
+}
+
+//--------------------------------------------------------------------------------------
+// NetMessageStats
+
+double NetMessageStats::GetCallbackMillisecondsPerCall() const
+{
+    if( m_callbackCount == 0 )
+        return 0.0;
+    return m_callbackSeconds * 1000.0 / (double) m_callbackCount;
+}
+
+//--------------------------------------------------------------------------------------
+// NetConnectionStats
+
+void NetConnectionStats::RecordPacketSent( size_t byteCount )
+{
+    ++m_packetsSent;
+    m_bytesSent += byteCount;
+    ++m_rateWindowPacketsSent;
+    m_rateWindowBytesSent += byteCount;
+}
+
+void NetConnectionStats::RecordPacketReceived( size_t byteCount )
+{
+    ++m_packetsReceived;
+    m_bytesReceived += byteCount;
+    ++m_rateWindowPacketsReceived;
+    m_rateWindowBytesReceived += byteCount;
+}
+
+void NetConnectionStats::RecordAck( float roundTripTime )
+{
+    ++m_ackedPacketCount;
+    uint bucket = (uint) ( Max( roundTripTime, 0.f ) / RTT_HISTOGRAM_BUCKET_SIZE );
+    ++m_roundTripTimeHistogram[Min( bucket, RTT_HISTOGRAM_BUCKET_COUNT - 1 )];
+}
+
+void NetConnectionStats::SampleReliableQueueDepth( size_t depth )
+{
+    m_reliableQueueDepth = depth;
+    m_peakReliableQueueDepth = Max( m_peakReliableQueueDepth, depth );
+}
+
+void NetConnectionStats::UpdateRates( float currentTime )
+{
+    float elapsed = currentTime - m_rateWindowStart;
+    if( elapsed < NET_STATS_RATE_INTERVAL )
+        return;
+
+    m_bytesSentPerSecond = (float) m_rateWindowBytesSent / elapsed;
+    m_bytesReceivedPerSecond = (float) m_rateWindowBytesReceived / elapsed;
+    m_packetsSentPerSecond = (float) m_rateWindowPacketsSent / elapsed;
+    m_packetsReceivedPerSecond = (float) m_rateWindowPacketsReceived / elapsed;
+
+    m_rateWindowStart = currentTime;
+    m_rateWindowPacketsSent = 0;
+    m_rateWindowPacketsReceived = 0;
+    m_rateWindowBytesSent = 0;
+    m_rateWindowBytesReceived = 0;
+}
+
+void NetConnectionStats::Reset()
+{
+    float rateWindowStart = m_rateWindowStart;
+    *this = NetConnectionStats();
+    m_rateWindowStart = rateWindowStart;
+}
+
+float NetConnectionStats::GetRoundTripTimePercentile( float fraction ) const
+{
+    uint total = 0;
+    for( uint count : m_roundTripTimeHistogram )
+        total += count;
+    if( total == 0 )
+        return 0.f;
+
+    // upper edge of the bucket the percentile falls in
+    uint target = (uint) ceilf( Clampf01( fraction ) * (float) total );
+    uint seen = 0;
+    for( uint bucket = 0; bucket < RTT_HISTOGRAM_BUCKET_COUNT; ++bucket )
+    {
+        seen += m_roundTripTimeHistogram[bucket];
+        if( seen >= target )
+            return (float) ( bucket + 1 ) * RTT_HISTOGRAM_BUCKET_SIZE;
+    }
+    return (float) RTT_HISTOGRAM_BUCKET_COUNT * RTT_HISTOGRAM_BUCKET_SIZE;
+}
+
+//--------------------------------------------------------------------------------------
+// NetStats
+
+void NetStats::RecordSend( MessageID id, size_t byteCount, bool isResend )
+{
+    NetMessageStats& stats = m_messages[id];
+    if( isResend )
+    {
+        ++stats.m_resentCount;
+        stats.m_resentBytes += byteCount;
+    }
+    else
+    {
+        ++stats.m_sentCount;
+        stats.m_sentBytes += byteCount;
+    }
+}
+
+void NetStats::RecordReceive( MessageID id, size_t byteCount )
+{
+    NetMessageStats& stats = m_messages[id];
+    ++stats.m_receivedCount;
+    stats.m_receivedBytes += byteCount;
+}
+
+void NetStats::RecordCallback( MessageID id, double seconds )
+{
+    NetMessageStats& stats = m_messages[id];
+    ++stats.m_callbackCount;
+    stats.m_callbackSeconds += seconds;
+}
+
+void NetStats::Reset()
+{
+    for( NetMessageStats& stats : m_messages )
+        stats = NetMessageStats();
+}
+
+void NetStats::GetBandwidthHogs( vector<MessageID>& out_ids ) const
+{
+    out_ids.clear();
+    for( size_t id = 0; id < MESSAGE_ID_COUNT; ++id )
+    {
+        if( m_messages[id].GetTotalSentBytes() != 0 )
+            out_ids.push_back( (MessageID) id );
+    }
+    std::sort( out_ids.begin(), out_ids.end(), [this]( MessageID lhs, MessageID rhs )
+    {
+        return m_messages[lhs].GetTotalSentBytes() > m_messages[rhs].GetTotalSentBytes();
+    } );
+}
+
+string NetStats::GetReportString( const vector<NetConnection*>& connections ) const
+{
+    string str = Stringf( "%-24s %-4s %-8s %-10s %-8s %-10s %-8s %-10s %-8s\n",
+                          "message", "id", "sent", "sentB", "resent", "resentB",
+                          "recv", "recvB", "cb ms" );
+    for( size_t id = 0; id < MESSAGE_ID_COUNT; ++id )
+    {
+        const NetMessageStats& stats = m_messages[id];
+        if( stats.m_sentCount == 0 && stats.m_resentCount == 0 && stats.m_receivedCount == 0 )
+            continue;
+        str += Stringf( "%-24s %-4u %-8u %-10u %-8u %-10u %-8u %-10u %-8.3f\n",
+                        GetMessageName( (MessageID) id ).c_str(), (uint) id,
+                        (uint) stats.m_sentCount, (uint) stats.m_sentBytes,
+                        (uint) stats.m_resentCount, (uint) stats.m_resentBytes,
+                        (uint) stats.m_receivedCount, (uint) stats.m_receivedBytes,
+                        stats.GetCallbackMillisecondsPerCall() );
+    }
+
+    str += Stringf( "%-4s %-22s %-9s %-9s %-8s %-8s %-8s %-7s %-7s %-5s %-5s\n",
+                    "idx", "addr", "out B/s", "in B/s", "pktOut", "pktIn", "acked",
+                    "rtt50", "rtt95", "relQ", "peak" );
+    for( NetConnection* connection : connections )
+    {
+        const NetConnectionStats& stats = connection->m_stats;
+        str += Stringf( "%-4d %-22s %-9.0f %-9.0f %-8u %-8u %-8u %-7.3f %-7.3f %-5u %-5u\n",
+                        connection->m_idxInSession, connection->m_address.ToStringAll().c_str(),
+                        stats.m_bytesSentPerSecond, stats.m_bytesReceivedPerSecond,
+                        (uint) stats.m_packetsSent, (uint) stats.m_packetsReceived,
+                        (uint) stats.m_ackedPacketCount,
+                        stats.GetRoundTripTimePercentile( 0.5f ),
+                        stats.GetRoundTripTimePercentile( 0.95f ),
+                        (uint) stats.m_reliableQueueDepth,
+                        (uint) stats.m_peakReliableQueueDepth );
+    }
+    return str;
+}
+
+string NetStats::GetCSV( float time, const vector<NetConnection*>& connections,
+                         bool includeHeader ) const
+{
+    string csv;
+    if( includeHeader )
+    {
+        csv += "time,type,id,name,"
+            "sent_count,sent_bytes,resent_count,resent_bytes,"
+            "received_count,received_bytes,callback_count,callback_ms,"
+            "bytes_out_per_s,bytes_in_per_s,packets_out,packets_in,acked,"
+            "rtt_p50,rtt_p95,reliable_queue,reliable_queue_peak\n";
+    }
+
+    for( size_t id = 0; id < MESSAGE_ID_COUNT; ++id )
+    {
+        const NetMessageStats& stats = m_messages[id];
+        if( stats.m_sentCount == 0 && stats.m_resentCount == 0 && stats.m_receivedCount == 0 )
+            continue;
+        csv += Stringf( "%.3f,message,%u,%s,%u,%u,%u,%u,%u,%u,%u,%.3f,,,,,,,,,\n",
+                        time, (uint) id, GetMessageName( (MessageID) id ).c_str(),
+                        (uint) stats.m_sentCount, (uint) stats.m_sentBytes,
+                        (uint) stats.m_resentCount, (uint) stats.m_resentBytes,
+                        (uint) stats.m_receivedCount, (uint) stats.m_receivedBytes,
+                        (uint) stats.m_callbackCount, stats.m_callbackSeconds * 1000.0 );
+    }
+
+    for( NetConnection* connection : connections )
+    {
+        const NetConnectionStats& stats = connection->m_stats;
+        csv += Stringf( "%.3f,connection,%d,%s,,,,,,,,,%.0f,%.0f,%u,%u,%u,%.3f,%.3f,%u,%u\n",
+                        time, connection->m_idxInSession, connection->m_address.ToStringAll().c_str(),
+                        stats.m_bytesSentPerSecond, stats.m_bytesReceivedPerSecond,
+                        (uint) stats.m_packetsSent, (uint) stats.m_packetsReceived,
+                        (uint) stats.m_ackedPacketCount,
+                        stats.GetRoundTripTimePercentile( 0.5f ),
+                        stats.GetRoundTripTimePercentile( 0.95f ),
+                        (uint) stats.m_reliableQueueDepth,
+                        (uint) stats.m_peakReliableQueueDepth );
+    }
+    return csv;
+}
+
+string NetStats::GetJson( float time, const vector<NetConnection*>& connections ) const
+{
+    string json = Stringf( "{\"time\":%.3f,\"messages\":[", time );
+    bool isFirst = true;
+    for( size_t id = 0; id < MESSAGE_ID_COUNT; ++id )
+    {
+        const NetMessageStats& stats = m_messages[id];
+        if( stats.m_sentCount == 0 && stats.m_resentCount == 0 && stats.m_receivedCount == 0 )
+            continue;
+        json += Stringf(
+            "%s{\"id\":%u,\"name\":\"%s\",\"sent_count\":%u,\"sent_bytes\":%u,"
+            "\"resent_count\":%u,\"resent_bytes\":%u,\"received_count\":%u,"
+            "\"received_bytes\":%u,\"callback_count\":%u,\"callback_ms\":%.3f}",
+            isFirst ? "" : ",", (uint) id, GetMessageName( (MessageID) id ).c_str(),
+            (uint) stats.m_sentCount, (uint) stats.m_sentBytes,
+            (uint) stats.m_resentCount, (uint) stats.m_resentBytes,
+            (uint) stats.m_receivedCount, (uint) stats.m_receivedBytes,
+            (uint) stats.m_callbackCount, stats.m_callbackSeconds * 1000.0 );
+        isFirst = false;
+    }
+
+    json += "],\"connections\":[";
+    isFirst = true;
+    for( NetConnection* connection : connections )
+    {
+        const NetConnectionStats& stats = connection->m_stats;
+        string histogram;
+        for( uint bucket = 0; bucket < RTT_HISTOGRAM_BUCKET_COUNT; ++bucket )
+        {
+            histogram += Stringf( "%s%u", bucket == 0 ? "" : ",",
+                                  stats.m_roundTripTimeHistogram[bucket] );
+        }
+        json += Stringf(
+            "%s{\"idx\":%d,\"address\":\"%s\",\"bytes_out_per_s\":%.0f,"
+            "\"bytes_in_per_s\":%.0f,\"packets_out\":%u,\"packets_in\":%u,"
+            "\"bytes_out\":%u,\"bytes_in\":%u,\"acked\":%u,"
+            "\"reliable_queue\":%u,\"reliable_queue_peak\":%u,"
+            "\"rtt_bucket_s\":%.3f,\"rtt_histogram\":[%s]}",
+            isFirst ? "" : ",", connection->m_idxInSession, connection->m_address.ToStringAll().c_str(),
+            stats.m_bytesSentPerSecond, stats.m_bytesReceivedPerSecond,
+            (uint) stats.m_packetsSent, (uint) stats.m_packetsReceived,
+            (uint) stats.m_bytesSent, (uint) stats.m_bytesReceived,
+            (uint) stats.m_ackedPacketCount,
+            (uint) stats.m_reliableQueueDepth, (uint) stats.m_peakReliableQueueDepth,
+            RTT_HISTOGRAM_BUCKET_SIZE, histogram.c_str() );
+        isFirst = false;
+    }
+    json += "]}";
+    return json;
+}
+
+bool NetStats::WriteToFile( const string& path, float time,
+                            const vector<NetConnection*>& connections,
+                            bool append ) const
+{
+    string text;
+    if( IsJsonPath( path ) )
+        text = GetJson( time, connections ) + "\n";
+    else
+        text = GetCSV( time, connections, !append || !IOUtils::FileExists( path ) );
+
+    bool success = append
+        ? IOUtils::AppendToFile( path, text )
+        : IOUtils::WriteBufferToFile( path, text.data(), text.size() );
+    if( !success )
+        LOG_WARNING_TAG( "Net", "Could not write net stats to %s", path.c_str() );
+    return success;
+}
+
+void NetStats::SetPeriodicDump( const string& path, float intervalSeconds )
+{
+    m_dumpPath = path;
+    m_dumpInterval = Max( intervalSeconds, 0.f );
+    m_lastDumpTime = 0.f;
+}
+
+void NetStats::UpdatePeriodicDump( float currentTime,
+                                   const vector<NetConnection*>& connections )
+{
+    if( m_dumpInterval <= 0.f || m_dumpPath.empty() )
+        return;
+    if( currentTime - m_lastDumpTime < m_dumpInterval )
+        return;
+
+    m_lastDumpTime = currentTime;
+    // keep the game going if the disk is not there
+    if( !WriteToFile( m_dumpPath, currentTime, connections, true ) )
+        m_dumpInterval = 0.f;
+}
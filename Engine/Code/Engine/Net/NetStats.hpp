@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+
+#include <map>
+
+// Byte counts are packet bytes before compression, the PacketChannel
+// counts what actually goes on the wire
+
+// One message type, indexed by MessageID
+struct NetMessageStats
+{
+    size_t GetTotalSentBytes() const { return m_sentBytes + m_resentBytes; }
+    double GetCallbackMillisecondsPerCall() const;
+
+    size_t m_sentCount = 0;   // first sends
+    size_t m_sentBytes = 0;   // includes the uint16 length in the packet
+    size_t m_resentCount = 0; // reliable resends
+    size_t m_resentBytes = 0;
+    size_t m_receivedCount = 0; // includes duplicates of reliables
+    size_t m_receivedBytes = 0;
+    size_t m_callbackCount = 0;
+    double m_callbackSeconds = 0.0;
+};
+
+// One connection, owned by the NetConnection
+struct NetConnectionStats
+{
+    void RecordPacketSent( size_t byteCount );
+    void RecordPacketReceived( size_t byteCount );
+    void RecordAck( float roundTripTime );
+    void SampleReliableQueueDepth( size_t depth );
+    // rolls the per second rates every NET_STATS_RATE_INTERVAL
+    void UpdateRates( float currentTime );
+    void Reset();
+
+    // from the histogram, fraction in [0,1], 0.5 for the median
+    float GetRoundTripTimePercentile( float fraction ) const;
+
+    // Totals
+    size_t m_packetsSent = 0;
+    size_t m_packetsReceived = 0;
+    size_t m_bytesSent = 0;
+    size_t m_bytesReceived = 0;
+    size_t m_ackedPacketCount = 0;
+
+    // Rates over the last interval
+    float m_bytesSentPerSecond = 0.f;
+    float m_bytesReceivedPerSecond = 0.f;
+    float m_packetsSentPerSecond = 0.f;
+    float m_packetsReceivedPerSecond = 0.f;
+
+    // unsent plus unconfirmed reliables, sampled every flush
+    size_t m_reliableQueueDepth = 0;
+    size_t m_peakReliableQueueDepth = 0;
+
+    // RTT_HISTOGRAM_BUCKET_SIZE wide, the last one holds everything slower
+    uint m_roundTripTimeHistogram[RTT_HISTOGRAM_BUCKET_COUNT] = {};
+
+    // Rate window
+    float m_rateWindowStart = 0.f;
+    size_t m_rateWindowPacketsSent = 0;
+    size_t m_rateWindowPacketsReceived = 0;
+    size_t m_rateWindowBytesSent = 0;
+    size_t m_rateWindowBytesReceived = 0;
+};
+
+// Which message types and connections use the bandwidth
+// The session owns one and records every message going through it
+class NetStats
+{
+public:
+    // Recording
+    // byteCount is what the message takes in the packet
+    void RecordSend( MessageID id, size_t byteCount, bool isResend );
+    void RecordReceive( MessageID id, size_t byteCount );
+    void RecordCallback( MessageID id, double seconds );
+    void Reset();
+
+    // Query
+    const NetMessageStats& GetMessageStats( MessageID id ) const { return m_messages[id]; }
+    // ids of message types that sent anything, most bytes first
+    void GetBandwidthHogs( vector<MessageID>& out_ids ) const;
+
+    // Reports
+    string GetReportString( const vector<NetConnection*>& connections ) const;
+    // one row per message type and per connection, the type column says which
+    string GetCSV( float time, const vector<NetConnection*>& connections,
+                   bool includeHeader ) const;
+    // one object, no line breaks so appended dumps are one per line
+    string GetJson( float time, const vector<NetConnection*>& connections ) const;
+    // .json or .csv from the extension, append for periodic dumps
+    bool WriteToFile( const string& path, float time,
+                      const vector<NetConnection*>& connections,
+                      bool append ) const;
+
+    // Periodic dumps, interval 0 stops
+    void SetPeriodicDump( const string& path, float intervalSeconds );
+    void UpdatePeriodicDump( float currentTime,
+                             const vector<NetConnection*>& connections );
+
+public:
+
+    NetMessageStats m_messages[MESSAGE_ID_COUNT];
+
+    string m_dumpPath;
+    float m_dumpInterval = 0.f;
+    float m_lastDumpTime = 0.f;
+};
@@ -0,0 +1,125 @@
+#include "Engine/Net/PacketCapture.hpp"
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/FileIO/IOUtils.hpp"
+
+PacketCapture::PacketCapture()
+{
+    m_buffer.SetEndianness( Endianness::LITTLE );
+}
+
+PacketCapture::~PacketCapture()
+{
+    Stop();
+}
+
+bool PacketCapture::Start( const string& path, NetSession* session )
+{
+    Stop();
+
+    m_buffer.ResetWriteHead();
+    m_buffer.Write( PACKET_CAPTURE_MAGIC );
+    m_buffer.Write( PACKET_CAPTURE_VERSION );
+    if( !IOUtils::WriteBufferToFile( path, m_buffer.GetBuffer(), m_buffer.GetWrittenByteCount() ) )
+    {
+        LOG_WARNING_TAG( "Net", "Could not start capture to %s", path.c_str() );
+        return false;
+    }
+    m_buffer.ResetWriteHead();
+
+    m_path = path;
+    m_session = session;
+    m_isCapturing = true;
+    m_hasWrittenHeader = false;
+    m_packetCount = 0;
+    m_byteCount = 0;
+    return true;
+}
+
+void PacketCapture::Stop()
+{
+    if( !m_isCapturing )
+        return;
+    Flush();
+    m_isCapturing = false;
+    LOG_INFO_TAG( "Net", "Capture stopped, %s", GetStatusString().c_str() );
+}
+
+void PacketCapture::Record( const NetPacket& packet,
+                            const NetAddress& sender,
+                            double currentTime )
+{
+    if( !m_isCapturing )
+        return;
+
+    if( !m_hasWrittenHeader )
+    {
+        WriteSessionHeader();
+        m_lastRecordTime = currentTime;
+    }
+
+    uint deltaMicroseconds = (uint) ( ( currentTime - m_lastRecordTime ) * 1000000.0 );
+    m_lastRecordTime = currentTime;
+
+    uint16 byteCount = (uint16) packet.GetWrittenByteCount();
+    m_buffer.Write( deltaMicroseconds );
+    m_buffer.Write( sender.m_ip4Address );
+    m_buffer.Write( (uint16) sender.m_port );
+    m_buffer.Write( byteCount );
+
+    // same layout as NetPacket::PackHeader, the body is already decompressed
+    const PacketHeader& header = packet.m_header;
+    m_buffer.Write( header.m_senderConnectionIdx );
+    m_buffer.Write( header.m_ack );
+    m_buffer.Write( header.m_lastReceivedAck );
+    m_buffer.Write( header.m_receivedAckBitfield );
+    m_buffer.Write( header.m_message_count );
+    m_buffer.Write( (uint8) ( header.m_flags & ~PACKET_FLAG_COMPRESSED ) );
+    m_buffer.WriteBytes( byteCount - sizeof( PacketHeader ),
+                         packet.GetBuffer() + sizeof( PacketHeader ) );
+
+    ++m_packetCount;
+    m_byteCount += byteCount;
+
+    if( m_buffer.GetWrittenByteCount() >= PACKET_CAPTURE_FLUSH_SIZE )
+        Flush();
+}
+
+string PacketCapture::GetStatusString() const
+{
+    return Stringf( "capture %s  %s  packets %u  bytes %u",
+                    m_isCapturing ? "on" : "off", m_path.c_str(),
+                    (uint) m_packetCount, (uint) m_byteCount );
+}
+
+void PacketCapture::WriteSessionHeader()
+{
+    m_hasWrittenHeader = true;
+
+    NetAddress hostAddress;
+    if( m_session->m_hostConnection )
+        hostAddress = m_session->m_hostConnection->m_address;
+
+    m_buffer.Write( (uint8) ( m_session->IsHost() ? 1 : 0 ) );
+    m_buffer.Write( m_session->m_boundAddress.m_ip4Address );
+    m_buffer.Write( (uint16) m_session->m_boundAddress.m_port );
+    m_buffer.Write( hostAddress.m_ip4Address );
+    m_buffer.Write( (uint16) hostAddress.m_port );
+}
+
+bool PacketCapture::Flush()
+{
+    if( m_buffer.GetWrittenByteCount() == 0 )
+        return true;
+
+    bool success = IOUtils::AppendBufferToFile( m_path,
+                                                m_buffer.GetBuffer(),
+                                                m_buffer.GetWrittenByteCount() );
+    m_buffer.ResetWriteHead();
+    if( !success )
+    {
+        // a capture with holes would replay wrong, stop instead
+        LOG_WARNING_TAG( "Net", "Could not write capture to %s, stopping", m_path.c_str() );
+        m_isCapturing = false;
+    }
+    return success;
+}
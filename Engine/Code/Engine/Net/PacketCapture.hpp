@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+#include "Engine/Net/NetAddress.hpp"
+#include "Engine/DataUtils/BytePacker.hpp"
+
+// Records every datagram a PacketChannel receives so PacketReplay can feed
+// the same stream back later
+// File, little endian
+// [uint32 magic][uint16 version]
+// [uint8 is_host][uint32 my_ip][uint16 my_port][uint32 host_ip][uint16 host_port]
+// then for every packet
+// [uint32 microseconds_since_last_packet]
+// [uint32 sender_ip][uint16 sender_port]
+// [uint16 byte_count]
+// [Byte* packet] // decompressed with PACKET_FLAG_COMPRESSED cleared,
+//                // so a replay does not need the dictionary
+class PacketCapture
+{
+public:
+    PacketCapture();
+    ~PacketCapture();
+
+    // truncates the file, the session header is written with the first packet
+    // since the session may not have hosted or joined yet
+    bool Start( const string& path, NetSession* session );
+    // flushes what is left
+    void Stop();
+    bool IsCapturing() const { return m_isCapturing; }
+
+    // packet is unpacked and decompressed
+    void Record( const NetPacket& packet, const NetAddress& sender, double currentTime );
+
+    string GetStatusString() const;
+
+private:
+    void WriteSessionHeader();
+    bool Flush();
+
+public:
+
+    string m_path;
+    NetSession* m_session = nullptr;
+    bool m_isCapturing = false;
+    bool m_hasWrittenHeader = false;
+    double m_lastRecordTime = 0.0;
+    BytePacker m_buffer; // written to the file every PACKET_CAPTURE_FLUSH_SIZE
+
+    // Stats
+    size_t m_packetCount = 0;
+    size_t m_byteCount = 0;
+};
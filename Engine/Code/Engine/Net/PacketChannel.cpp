@@ -2,6 +2,9 @@
 #include "Engine/Net/NetCommonC.hpp"
 
 #include "Engine/Math/MathUtils.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include <algorithm>
 
 bool PacketChannel::Bind( const NetAddress& addr )
 {
@@ -29,15 +32,72 @@ void PacketChannel::Close()
 
 void PacketChannel::SendImmediate( const NetPacket& packet )
 {
+    if( IsReplaying() )
+        return;
+
     if( IsClosed() )
         LOG_ERROR_TAG( "Net", "Cannot send, socket is closed or unbound" );
 
     if( packet.m_receiverAddress.IsInvalid() )
         LOG_ERROR_TAG( "Net", "Cannot send, invalid packet receiver address" );
 
-    m_socket->SendTo( packet.m_receiverAddress,
-                      packet.m_localBuffer,
-                      packet.GetWrittenByteCount() );
+    size_t sent = m_socket->SendTo( packet.m_receiverAddress,
+                                    packet.m_localBuffer,
+                                    packet.GetWrittenByteCount() );
+    if( sent > 0U )
+    {
+        ++m_sentPacketCount;
+        m_sentByteCount += sent;
+    }
+}
+
+void PacketChannel::QueueSend( const NetPacket& packet )
+{
+    if( packet.m_receiverAddress.IsInvalid() )
+    {
+        LOG_ERROR_TAG( "Net", "Cannot send, invalid packet receiver address" );
+        return;
+    }
+
+    if( m_queuedSendCount == PACKET_BATCH_SIZE )
+        FlushSends();
+
+    UDPDatagram& datagram = m_queuedSends[m_queuedSendCount];
+    datagram.m_address = packet.m_receiverAddress;
+    datagram.m_buffer = m_queuedSendBuffers[m_queuedSendCount];
+    // compresses on the way into the batch if the session has it on
+    datagram.m_byteCount = m_owningSession->m_compressor->WritePacket(
+        packet, m_queuedSendBuffers[m_queuedSendCount] );
+    ++m_queuedSendCount;
+}
+
+void PacketChannel::FlushSends()
+{
+    if( m_queuedSendCount == 0 )
+        return;
+
+    // the other side is a file, replies go nowhere
+    if( IsReplaying() )
+    {
+        m_queuedSendCount = 0;
+        return;
+    }
+
+    if( IsClosed() )
+    {
+        LOG_ERROR_TAG( "Net", "Cannot send, socket is closed or unbound" );
+        m_queuedSendCount = 0;
+        return;
+    }
+
+    size_t sent = m_socket->SendToBatch( m_queuedSends, m_queuedSendCount );
+    for( size_t i = 0; i < sent; ++i )
+        m_sentByteCount += m_queuedSends[i].m_byteCount;
+    m_sentPacketCount += sent;
+    ++m_sendBatchCount;
+
+    // unreliable transport, whatever did not go out is dropped
+    m_queuedSendCount = 0;
 }
 
 bool PacketChannel::Receive( NetPacket& out_packet )
@@ -48,27 +108,80 @@ bool PacketChannel::Receive( NetPacket& out_packet )
         out_packet.GetBuffer(),
         out_packet.GetBufferMaxSize() );
 
-    out_packet.SetWriteHead( readBytes );
+    return PrepareReceivedPacket( out_packet, senderAddr, readBytes );
+}
+
+size_t PacketChannel::ReceiveBatch( NetPacket** out_packets, size_t maxCount )
+{
+    if( IsReplaying() )
+        return ReceiveReplayBatch( out_packets, maxCount );
 
-    if( readBytes > 0U )
+    UDPDatagram datagrams[PACKET_BATCH_SIZE];
+    size_t validCount = 0;
+    while( validCount < maxCount && !IsClosed() )
     {
-        if( !out_packet.UnpackHeader() )
-            return false;
+        size_t batchStart = validCount;
+        size_t requestCount = Min( maxCount - validCount, PACKET_BATCH_SIZE );
+        for( size_t i = 0; i < requestCount; ++i )
+        {
+            NetPacket* packet = out_packets[batchStart + i];
+            datagrams[i].m_buffer = packet->GetBuffer();
+            datagrams[i].m_bufferSize = packet->GetBufferMaxSize();
+        }
 
-        NetConnection* connection = m_owningSession->GetConnection(
-            out_packet.m_header.m_senderConnectionIdx );
-        if( !connection )
-            connection = m_owningSession->GetConnection( senderAddr );
+        size_t receivedCount = m_socket->ReceiveFromBatch( datagrams, requestCount );
+        if( receivedCount == 0 )
+            break;
+        ++m_receiveBatchCount;
 
-        out_packet.m_senderIdx = connection ?
-            connection->m_idxInSession : INVALID_CONNECTION_INDEX; // can be null
-        out_packet.m_senderAddress = senderAddr;
-        return true;
+        // compact valid packets to the front, bad ones get their slot reused
+        for( size_t i = 0; i < receivedCount; ++i )
+        {
+            NetPacket* packet = out_packets[batchStart + i];
+            if( !PrepareReceivedPacket( *packet, datagrams[i].m_address,
+                                        datagrams[i].m_byteCount ) )
+                continue;
+
+            std::swap( out_packets[validCount], out_packets[batchStart + i] );
+            ++validCount;
+        }
+
+        if( receivedCount < requestCount )
+            break;
     }
-    else
-    {
+    return validCount;
+}
+
+bool PacketChannel::PrepareReceivedPacket( NetPacket& packet,
+                                           const NetAddress& senderAddr,
+                                           size_t readBytes )
+{
+    packet.SetWriteHead( readBytes );
+
+    if( readBytes == 0U )
         return false;
-    }
+
+    ++m_receivedPacketCount;
+    m_receivedByteCount += readBytes;
+
+    if( !packet.UnpackHeader() )
+        return false;
+
+    if( !m_owningSession->m_compressor->ReadPacket( packet ) )
+        return false;
+
+    if( m_capture )
+        m_capture->Record( packet, senderAddr, TimeUtils::GetCurrentTimeSecondsD() );
+
+    NetConnection* connection = m_owningSession->GetConnection(
+        packet.m_header.m_senderConnectionIdx );
+    if( !connection )
+        connection = m_owningSession->GetConnection( senderAddr );
+
+    packet.m_senderIdx = connection ?
+        connection->m_idxInSession : INVALID_CONNECTION_INDEX; // can be null
+    packet.m_senderAddress = senderAddr;
+    return true;
 }
 
 bool PacketChannel::IsClosed()
@@ -77,3 +190,64 @@ bool PacketChannel::IsClosed()
         return m_socket->IsClosed();
     return true;
 }
+
+bool PacketChannel::StartCapture( const string& path )
+{
+    StopCapture();
+    m_capture = new PacketCapture();
+    if( !m_capture->Start( path, m_owningSession ) )
+    {
+        StopCapture();
+        return false;
+    }
+    return true;
+}
+
+void PacketChannel::StopCapture()
+{
+    delete m_capture;
+    m_capture = nullptr;
+}
+
+void PacketChannel::StartReplay( PacketReplay* replay, float speed )
+{
+    StopReplay();
+    m_replay = replay;
+    m_replay->Start( speed, TimeUtils::GetCurrentTimeSecondsD() );
+}
+
+void PacketChannel::StopReplay()
+{
+    delete m_replay;
+    m_replay = nullptr;
+}
+
+string PacketChannel::GetCaptureStatusString() const
+{
+    string str = m_capture ? m_capture->GetStatusString() : "capture off";
+    str += "\n";
+    str += m_replay ? m_replay->GetStatusString() : "replay off";
+    return str;
+}
+
+size_t PacketChannel::ReceiveReplayBatch( NetPacket** out_packets, size_t maxCount )
+{
+    double currentTime = TimeUtils::GetCurrentTimeSecondsD();
+    size_t validCount = 0;
+    while( validCount < maxCount )
+    {
+        NetPacket* packet = out_packets[validCount];
+        NetAddress senderAddr;
+        size_t readBytes = m_replay->PopDue( currentTime,
+                                             packet->GetBuffer(),
+                                             packet->GetBufferMaxSize(),
+                                             senderAddr );
+        if( readBytes == 0 )
+            break;
+
+        // same path as the socket, a bad packet just gets its slot reused
+        if( PrepareReceivedPacket( *packet, senderAddr, readBytes ) )
+            ++validCount;
+    }
+    return validCount;
+}
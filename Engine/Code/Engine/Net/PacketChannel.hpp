@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Net/NetCommonH.hpp"
+#include "Engine/Net/UDPSocket.hpp"
 
 // collection of UDP sockets to communicate on
 // can allocate and free packets
@@ -13,15 +14,62 @@ public:
     bool Bind( const NetAddress& addr );
     void Close();
 
+    // skips the outgoing batch
     void SendImmediate( const NetPacket& packet );
 
+    // copies the packet into the outgoing batch, the batch goes out on
+    // FlushSends or when it fills up
+    // the copy is compressed if the session's PacketCompressor is enabled
+    void QueueSend( const NetPacket& packet );
+    void FlushSends();
+
     bool Receive( NetPacket& out_packet );
 
+    // drains up to maxCount valid packets from the socket in batches
+    // returns less than maxCount once the socket is empty
+    size_t ReceiveBatch( NetPacket** out_packets, size_t maxCount );
+
     bool IsClosed();
 
+    // Capture and replay, see PacketCapture and PacketReplay
+    bool StartCapture( const string& path );
+    void StopCapture();
+    // takes ownership, replaces the socket until StopReplay,
+    // everything sent meanwhile is dropped
+    void StartReplay( PacketReplay* replay, float speed );
+    void StopReplay();
+    bool IsReplaying() const { return m_replay != nullptr; }
+    string GetCaptureStatusString() const;
+
+private:
+    size_t ReceiveReplayBatch( NetPacket** out_packets, size_t maxCount );
+
+    // unpacks header, decompresses and finds the sender
+    // false if the packet is garbage
+    bool PrepareReceivedPacket( NetPacket& packet,
+                                const NetAddress& senderAddr,
+                                size_t readBytes );
+
 public:
 
-    UDPSocket* m_socket;
-    NetSession* m_owningSession;
+    UDPSocket* m_socket = nullptr;
+    NetSession* m_owningSession = nullptr;
+
+    // Outgoing batch
+    UDPDatagram m_queuedSends[PACKET_BATCH_SIZE];
+    Byte m_queuedSendBuffers[PACKET_BATCH_SIZE][PACKET_MTU];
+    size_t m_queuedSendCount = 0;
+
+    // Capture and replay
+    PacketCapture* m_capture = nullptr;
+    PacketReplay* m_replay = nullptr;
+
+    // Analytics
+    size_t m_sentPacketCount = 0;
+    size_t m_sentByteCount = 0;
+    size_t m_receivedPacketCount = 0;
+    size_t m_receivedByteCount = 0;
+    size_t m_sendBatchCount = 0;
+    size_t m_receiveBatchCount = 0;
 
-};
\ No newline at end of file
+};
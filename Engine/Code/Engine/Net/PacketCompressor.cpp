@@ -0,0 +1,497 @@
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/Net/PacketCompressor.hpp"
+#include "Engine/FileIO/IOUtils.hpp"
+#include "Engine/Time/Time.hpp"
+
+#include <string.h>
+#include <stddef.h>
+#include <unordered_map>
+
+namespace
+{
+
+constexpr size_t MIN_MATCH_LENGTH = 4;
+constexpr uint HASH_BITS = 12;
+constexpr size_t HASH_SIZE = (size_t) 1 << HASH_BITS;
+constexpr uint16 INVALID_HASH_POSITION = (uint16) ( ~0 );
+constexpr size_t MAX_MATCH_OFFSET = 0xFFFF;
+
+// dictionary training
+constexpr size_t TRAINING_GRAM_SIZE = 8;
+constexpr size_t TRAINING_SEGMENT_SIZE = 32;
+
+uint HashFourBytes( const Byte* bytes )
+{
+    uint32 value;
+    memcpy( &value, bytes, sizeof( value ) );
+    return ( value * 2654435761U ) >> ( 32 - HASH_BITS );
+}
+
+bool WriteByte( Byte* dst, size_t dstCapacity, size_t& io_size, Byte value )
+{
+    if( io_size >= dstCapacity )
+        return false;
+    dst[io_size++] = value;
+    return true;
+}
+
+// 255 means another length byte follows
+bool WriteExtraLength( Byte* dst, size_t dstCapacity, size_t& io_size, size_t length )
+{
+    while( length >= 255 )
+    {
+        if( !WriteByte( dst, dstCapacity, io_size, 255 ) )
+            return false;
+        length -= 255;
+    }
+    return WriteByte( dst, dstCapacity, io_size, (Byte) length );
+}
+
+bool ReadExtraLength( const Byte* src, size_t srcSize, size_t& io_offset, size_t& io_length )
+{
+    Byte value;
+    do
+    {
+        if( io_offset >= srcSize )
+            return false;
+        value = src[io_offset++];
+        io_length += value;
+    } while( value == 255 );
+    return true;
+}
+
+// a matchLength of 0 writes the last, literals only, sequence
+bool WriteSequence( Byte* dst, size_t dstCapacity, size_t& io_size,
+                    const Byte* literals, size_t literalCount,
+                    size_t matchOffset, size_t matchLength )
+{
+    size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH_LENGTH;
+    Byte token = (Byte) ( ( Min( literalCount, (size_t) 15 ) << 4 )
+                          | Min( matchCode, (size_t) 15 ) );
+    if( !WriteByte( dst, dstCapacity, io_size, token ) )
+        return false;
+    if( literalCount >= 15
+        && !WriteExtraLength( dst, dstCapacity, io_size, literalCount - 15 ) )
+        return false;
+
+    if( io_size + literalCount > dstCapacity )
+        return false;
+    memcpy( dst + io_size, literals, literalCount );
+    io_size += literalCount;
+
+    if( matchLength == 0 )
+        return true;
+
+    if( !WriteByte( dst, dstCapacity, io_size, (Byte) ( matchOffset & 0xFF ) )
+        || !WriteByte( dst, dstCapacity, io_size, (Byte) ( matchOffset >> 8 ) ) )
+        return false;
+    if( matchCode >= 15
+        && !WriteExtraLength( dst, dstCapacity, io_size, matchCode - 15 ) )
+        return false;
+    return true;
+}
+
+}
+
+//--------------------------------------------------------------------------------------
+// Packets
+
+size_t PacketCompressor::WritePacket( const NetPacket& packet, Byte* out_buffer )
+{
+    size_t headerSize = sizeof( PacketHeader );
+    size_t packetSize = packet.GetWrittenByteCount();
+    const Byte* body = packet.m_localBuffer + headerSize;
+    size_t bodySize = packetSize - headerSize;
+
+    if( m_isTraining && packetSize > headerSize
+        && m_trainingSamples.size() < COMPRESSION_TRAINING_SAMPLE_COUNT )
+        m_trainingSamples.emplace_back( body, body + bodySize );
+
+    memcpy( out_buffer, packet.m_localBuffer, headerSize );
+    if( !m_isEnabled || packetSize <= headerSize )
+    {
+        memcpy( out_buffer + headerSize, body, bodySize );
+        return packetSize;
+    }
+
+    double startTime = TimeUtils::GetCurrentTimeSecondsD();
+    // only worth it if it comes out smaller
+    size_t compressedSize = Compress(
+        body, bodySize, out_buffer + headerSize, bodySize - 1 );
+    m_encodeSeconds += TimeUtils::GetCurrentTimeSecondsD() - startTime;
+    ++m_encodeCount;
+    m_encodeInputBytes += packetSize;
+
+    if( compressedSize == 0 )
+    {
+        memcpy( out_buffer + headerSize, body, bodySize );
+        m_encodeOutputBytes += packetSize;
+        return packetSize;
+    }
+
+    out_buffer[offsetof( PacketHeader, m_flags )] |= PACKET_FLAG_COMPRESSED;
+    ++m_compressedCount;
+    m_encodeOutputBytes += headerSize + compressedSize;
+    return headerSize + compressedSize;
+}
+
+bool PacketCompressor::ReadPacket( NetPacket& packet )
+{
+    if( ( packet.m_header.m_flags & PACKET_FLAG_COMPRESSED ) == 0 )
+        return true;
+
+    size_t headerSize = sizeof( PacketHeader );
+    Byte body[PACKET_MTU];
+
+    double startTime = TimeUtils::GetCurrentTimeSecondsD();
+    size_t bodySize = Decompress( packet.m_localBuffer + headerSize,
+                                  packet.GetWrittenByteCount() - headerSize,
+                                  body, PACKET_MTU - headerSize );
+    m_decodeSeconds += TimeUtils::GetCurrentTimeSecondsD() - startTime;
+    ++m_decodeCount;
+
+    if( bodySize == 0 )
+    {
+        ++m_decodeFailCount;
+        LOG_WARNING_TAG( "Net", "Could not decompress packet, dictionary [%u]",
+                         packet.m_localBuffer[headerSize] );
+        return false;
+    }
+
+    memcpy( packet.m_localBuffer + headerSize, body, bodySize );
+    packet.SetWriteHead( headerSize + bodySize );
+    return true;
+}
+
+//--------------------------------------------------------------------------------------
+// Codec
+
+size_t PacketCompressor::Compress( const Byte* src, size_t srcSize,
+                                   Byte* dst, size_t dstCapacity ) const
+{
+    if( srcSize > PACKET_MTU )
+        return 0;
+
+    // matches can reach back into the dictionary so it goes in front
+    Byte window[COMPRESSION_DICTIONARY_MAX_SIZE + PACKET_MTU];
+    size_t dictionarySize = m_dictionary.size();
+    if( dictionarySize != 0 )
+        memcpy( window, m_dictionary.data(), dictionarySize );
+    memcpy( window + dictionarySize, src, srcSize );
+    size_t windowSize = dictionarySize + srcSize;
+
+    uint16 hashTable[HASH_SIZE];
+    for( uint16& position : hashTable )
+        position = INVALID_HASH_POSITION;
+    for( size_t pos = 0; pos + MIN_MATCH_LENGTH <= dictionarySize; ++pos )
+        hashTable[HashFourBytes( window + pos )] = (uint16) pos;
+
+    size_t size = 0;
+    if( !WriteByte( dst, dstCapacity, size, m_dictionaryID ) )
+        return 0;
+
+    size_t pos = dictionarySize;
+    size_t literalStart = dictionarySize;
+    while( pos + MIN_MATCH_LENGTH <= windowSize )
+    {
+        uint hash = HashFourBytes( window + pos );
+        size_t candidate = hashTable[hash];
+        hashTable[hash] = (uint16) pos;
+
+        if( candidate == INVALID_HASH_POSITION
+            || pos - candidate > MAX_MATCH_OFFSET
+            || memcmp( window + candidate, window + pos, MIN_MATCH_LENGTH ) != 0 )
+        {
+            ++pos;
+            continue;
+        }
+
+        size_t matchLength = MIN_MATCH_LENGTH;
+        while( pos + matchLength < windowSize
+               && window[candidate + matchLength] == window[pos + matchLength] )
+            ++matchLength;
+
+        if( !WriteSequence( dst, dstCapacity, size,
+                            window + literalStart, pos - literalStart,
+                            pos - candidate, matchLength ) )
+            return 0;
+
+        // positions inside the match are still good for later matches
+        size_t matchEnd = pos + matchLength;
+        for( ++pos; pos < matchEnd && pos + MIN_MATCH_LENGTH <= windowSize; ++pos )
+            hashTable[HashFourBytes( window + pos )] = (uint16) pos;
+        pos = matchEnd;
+        literalStart = pos;
+    }
+
+    if( !WriteSequence( dst, dstCapacity, size,
+                        window + literalStart, windowSize - literalStart, 0, 0 ) )
+        return 0;
+    return size;
+}
+
+size_t PacketCompressor::Decompress( const Byte* src, size_t srcSize,
+                                     Byte* dst, size_t dstCapacity ) const
+{
+    if( srcSize < 2 || src[0] != m_dictionaryID )
+        return 0;
+
+    const Byte* dictionary = m_dictionary.data();
+    size_t dictionarySize = m_dictionary.size();
+
+    size_t in = 1;
+    size_t out = 0;
+    while( in < srcSize )
+    {
+        Byte token = src[in++];
+
+        size_t literalCount = token >> 4;
+        if( literalCount == 15 && !ReadExtraLength( src, srcSize, in, literalCount ) )
+            return 0;
+        if( in + literalCount > srcSize || out + literalCount > dstCapacity )
+            return 0;
+        memcpy( dst + out, src + in, literalCount );
+        in += literalCount;
+        out += literalCount;
+
+        // last sequence has no match
+        if( in == srcSize )
+            return out;
+
+        if( in + 2 > srcSize )
+            return 0;
+        size_t matchOffset = src[in] | ( src[in + 1] << 8 );
+        in += 2;
+        size_t matchLength = ( token & 0x0F ) + MIN_MATCH_LENGTH;
+        if( ( token & 0x0F ) == 15 && !ReadExtraLength( src, srcSize, in, matchLength ) )
+            return 0;
+
+        if( matchOffset == 0 || matchOffset > out + dictionarySize
+            || out + matchLength > dstCapacity )
+            return 0;
+
+        // byte at a time, matches can overlap what they write
+        for( size_t i = 0; i < matchLength; ++i, ++out )
+        {
+            if( matchOffset <= out )
+                dst[out] = dst[out - matchOffset];
+            else
+                dst[out] = dictionary[dictionarySize - ( matchOffset - out )];
+        }
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------
+// Dictionary
+
+void PacketCompressor::SetDictionary( const Byte* dictionary, size_t byteCount )
+{
+    if( byteCount > COMPRESSION_DICTIONARY_MAX_SIZE )
+    {
+        LOG_WARNING_TAG( "Net", "Dictionary of %u bytes truncated to %u",
+                         (uint) byteCount, (uint) COMPRESSION_DICTIONARY_MAX_SIZE );
+        // keep the end, that is where the most useful bytes are
+        dictionary += byteCount - COMPRESSION_DICTIONARY_MAX_SIZE;
+        byteCount = COMPRESSION_DICTIONARY_MAX_SIZE;
+    }
+    m_dictionary.assign( dictionary, dictionary + byteCount );
+    m_dictionaryID = CalculateDictionaryID( dictionary, byteCount );
+}
+
+void PacketCompressor::ClearDictionary()
+{
+    m_dictionary.clear();
+    m_dictionaryID = 0;
+}
+
+bool PacketCompressor::LoadDictionary( const string& path )
+{
+    size_t byteCount = 0;
+    Byte* buffer = (Byte*) IOUtils::ReadFileToNewRawBuffer( path.c_str(), byteCount );
+    if( buffer == nullptr )
+    {
+        LOG_WARNING_TAG( "Net", "Could not load dictionary %s", path.c_str() );
+        return false;
+    }
+    SetDictionary( buffer, byteCount );
+    free( buffer );
+    return true;
+}
+
+bool PacketCompressor::SaveDictionary( const string& path ) const
+{
+    return IOUtils::WriteBufferToFile( path, m_dictionary.data(), m_dictionary.size() );
+}
+
+uint8 PacketCompressor::CalculateDictionaryID( const Byte* dictionary, size_t byteCount )
+{
+    if( byteCount == 0 )
+        return 0;
+
+    // FNV-1a folded to a byte, 0 is kept for no dictionary
+    uint32 hash = 2166136261U;
+    for( size_t i = 0; i < byteCount; ++i )
+    {
+        hash ^= dictionary[i];
+        hash *= 16777619U;
+    }
+    uint8 id = (uint8) ( hash ^ ( hash >> 8 ) ^ ( hash >> 16 ) ^ ( hash >> 24 ) );
+    return id == 0 ? 1 : id;
+}
+
+//--------------------------------------------------------------------------------------
+// Training
+
+void PacketCompressor::StartTraining()
+{
+    m_trainingSamples.clear();
+    m_isTraining = true;
+}
+
+void PacketCompressor::StopTraining( size_t dictionarySize )
+{
+    m_isTraining = false;
+
+    vector<Byte> dictionary;
+    TrainDictionary( m_trainingSamples, dictionarySize, dictionary );
+    LOG_INFO_TAG( "Net", "Trained %u byte dictionary from %u packets",
+                  (uint) dictionary.size(), (uint) m_trainingSamples.size() );
+    m_trainingSamples.clear();
+
+    if( dictionary.empty() )
+        ClearDictionary();
+    else
+        SetDictionary( dictionary.data(), dictionary.size() );
+}
+
+void PacketCompressor::TrainDictionary( const vector<vector<Byte>>& samples,
+                                        size_t dictionarySize,
+                                        vector<Byte>& out_dictionary )
+{
+    out_dictionary.clear();
+
+    // give every distinct gram an index and count how many samples have it
+    std::unordered_map<uint64, uint> gramIndices;
+    vector<uint> gramCounts;
+    vector<uint> gramLastSample;
+    vector<vector<uint>> sampleGrams( samples.size() );
+    for( size_t sampleIdx = 0; sampleIdx < samples.size(); ++sampleIdx )
+    {
+        const vector<Byte>& sample = samples[sampleIdx];
+        for( size_t pos = 0; pos + TRAINING_GRAM_SIZE <= sample.size(); ++pos )
+        {
+            uint64 gram;
+            memcpy( &gram, sample.data() + pos, TRAINING_GRAM_SIZE );
+            auto result = gramIndices.emplace( gram, (uint) gramCounts.size() );
+            uint gramIdx = result.first->second;
+            if( result.second )
+            {
+                gramCounts.push_back( 0 );
+                gramLastSample.push_back( (uint) ( ~0 ) );
+            }
+            if( gramLastSample[gramIdx] != sampleIdx )
+            {
+                ++gramCounts[gramIdx];
+                gramLastSample[gramIdx] = (uint) sampleIdx;
+            }
+            sampleGrams[sampleIdx].push_back( gramIdx );
+        }
+    }
+
+    // greedily take the segment whose grams are most common, then zero those
+    // grams so the next pick covers something new
+    const size_t gramsPerSegment = TRAINING_SEGMENT_SIZE - TRAINING_GRAM_SIZE + 1;
+    vector<const Byte*> segments;
+    while( ( segments.size() + 1 ) * TRAINING_SEGMENT_SIZE <= dictionarySize )
+    {
+        uint64 bestScore = 0;
+        size_t bestSampleIdx = 0;
+        size_t bestPos = 0;
+        for( size_t sampleIdx = 0; sampleIdx < samples.size(); ++sampleIdx )
+        {
+            const vector<uint>& grams = sampleGrams[sampleIdx];
+            if( grams.size() < gramsPerSegment )
+                continue;
+
+            uint64 score = 0;
+            for( size_t i = 0; i < gramsPerSegment; ++i )
+                score += gramCounts[grams[i]];
+            for( size_t pos = 0; ; ++pos )
+            {
+                if( score > bestScore )
+                {
+                    bestScore = score;
+                    bestSampleIdx = sampleIdx;
+                    bestPos = pos;
+                }
+                if( pos + gramsPerSegment >= grams.size() )
+                    break;
+                score += gramCounts[grams[pos + gramsPerSegment]];
+                score -= gramCounts[grams[pos]];
+            }
+        }
+
+        // grams only one packet had are not worth keeping
+        if( bestScore <= gramsPerSegment )
+            break;
+
+        segments.push_back( samples[bestSampleIdx].data() + bestPos );
+        const vector<uint>& grams = sampleGrams[bestSampleIdx];
+        for( size_t i = 0; i < gramsPerSegment; ++i )
+            gramCounts[grams[bestPos + i]] = 0;
+    }
+
+    // best segments go last, closest to the packet
+    for( auto iter = segments.rbegin(); iter != segments.rend(); ++iter )
+        out_dictionary.insert( out_dictionary.end(), *iter, *iter + TRAINING_SEGMENT_SIZE );
+}
+
+//--------------------------------------------------------------------------------------
+// Stats
+
+void PacketCompressor::ResetStats()
+{
+    m_encodeCount = 0;
+    m_compressedCount = 0;
+    m_encodeInputBytes = 0;
+    m_encodeOutputBytes = 0;
+    m_encodeSeconds = 0.0;
+    m_decodeCount = 0;
+    m_decodeFailCount = 0;
+    m_decodeSeconds = 0.0;
+}
+
+float PacketCompressor::GetCompressionRatio() const
+{
+    if( m_encodeInputBytes == 0 )
+        return 1.f;
+    return (float) m_encodeOutputBytes / (float) m_encodeInputBytes;
+}
+
+double PacketCompressor::GetEncodeNanosecondsPerPacket() const
+{
+    if( m_encodeCount == 0 )
+        return 0.0;
+    return m_encodeSeconds * 1000000000.0 / (double) m_encodeCount;
+}
+
+double PacketCompressor::GetDecodeNanosecondsPerPacket() const
+{
+    if( m_decodeCount == 0 )
+        return 0.0;
+    return m_decodeSeconds * 1000000000.0 / (double) m_decodeCount;
+}
+
+string PacketCompressor::GetStatsString() const
+{
+    return Stringf(
+        "compression: %s  dict: %u bytes [%u]  ratio: %0.3f  compressed: %u/%u  "
+        "encode: %0.0fns  decode: %0.0fns  decode fails: %u",
+        m_isEnabled ? "on" : "off",
+        (uint) m_dictionary.size(), m_dictionaryID,
+        GetCompressionRatio(),
+        (uint) m_compressedCount, (uint) m_encodeCount,
+        GetEncodeNanosecondsPerPacket(), GetDecodeNanosecondsPerPacket(),
+        (uint) m_decodeFailCount );
+}
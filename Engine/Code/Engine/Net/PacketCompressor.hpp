@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+
+// Optional compression of packet bodies, the PacketHeader is never compressed
+// and has PACKET_FLAG_COMPRESSED set when the body is
+//
+// The codec is LZ77 style, a compressed body is
+// [uint8 dictionary_id] // 0 for no dictionary
+// followed by sequences of
+// [uint8 token] // high 4 bits literal count, low 4 bits match length - 4
+// [uint8 extra literal count]* // if literal count is 15, 255 means more follow
+// [Byte* literals]
+// [uint16 match_offset] // back from the current output, can reach into the dictionary
+// [uint8 extra match length]* // if match length - 4 is 15, 255 means more follow
+// the last sequence has literals only and ends the body
+//
+// Both ends need the same dictionary, packets made with another dictionary
+// are dropped. A dictionary can be trained from outgoing traffic, see
+// StartTraining
+class PacketCompressor
+{
+public:
+    // Packets
+    // writes packet into out_buffer, compressed if that makes it smaller
+    // returns the byte count written
+    size_t WritePacket( const NetPacket& packet, Byte* out_buffer );
+    // decompresses the body in place if the header says it is compressed
+    bool ReadPacket( NetPacket& packet );
+
+    // Codec, returns the compressed / decompressed size, 0 if it did not fit
+    size_t Compress( const Byte* src, size_t srcSize,
+                     Byte* dst, size_t dstCapacity ) const;
+    size_t Decompress( const Byte* src, size_t srcSize,
+                       Byte* dst, size_t dstCapacity ) const;
+
+    // Dictionary
+    void SetDictionary( const Byte* dictionary, size_t byteCount );
+    void ClearDictionary();
+    bool LoadDictionary( const string& path );
+    bool SaveDictionary( const string& path ) const;
+    bool HasDictionary() const { return !m_dictionary.empty(); }
+    uint8 GetDictionaryID() const { return m_dictionaryID; }
+
+    // Training, collects outgoing packet bodies until StopTraining
+    void StartTraining();
+    // builds a dictionary out of the collected bodies and uses it
+    void StopTraining( size_t dictionarySize = COMPRESSION_DICTIONARY_MAX_SIZE );
+    bool IsTraining() const { return m_isTraining; }
+    static void TrainDictionary( const vector<vector<Byte>>& samples,
+                                 size_t dictionarySize,
+                                 vector<Byte>& out_dictionary );
+
+    // Stats
+    void ResetStats();
+    float GetCompressionRatio() const; // compressed bytes / original bytes
+    double GetEncodeNanosecondsPerPacket() const;
+    double GetDecodeNanosecondsPerPacket() const;
+    string GetStatsString() const;
+
+private:
+    static uint8 CalculateDictionaryID( const Byte* dictionary, size_t byteCount );
+
+public:
+
+    bool m_isEnabled = false; // receiving always works, this is for sending
+
+    vector<Byte> m_dictionary;
+    uint8 m_dictionaryID = 0;
+
+    bool m_isTraining = false;
+    vector<vector<Byte>> m_trainingSamples;
+
+    // Stats
+    size_t m_encodeCount = 0;
+    size_t m_compressedCount = 0; // encodes that were worth sending
+    size_t m_encodeInputBytes = 0;
+    size_t m_encodeOutputBytes = 0; // uncompressed size when it was not worth it
+    double m_encodeSeconds = 0.0;
+    size_t m_decodeCount = 0;
+    size_t m_decodeFailCount = 0;
+    double m_decodeSeconds = 0.0;
+};
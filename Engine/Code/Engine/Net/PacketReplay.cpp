@@ -0,0 +1,128 @@
+#include "Engine/Net/PacketReplay.hpp"
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/FileIO/IOUtils.hpp"
+
+#include <string.h>
+
+PacketReplay::~PacketReplay()
+{
+    free( m_fileBuffer );
+}
+
+bool PacketReplay::Load( const string& path )
+{
+    free( m_fileBuffer );
+    m_packets.clear();
+    m_nextPacketIdx = 0;
+
+    size_t fileSize = 0;
+    m_fileBuffer = (Byte*) IOUtils::ReadFileToNewRawBuffer( path.c_str(), fileSize );
+    if( m_fileBuffer == nullptr )
+    {
+        LOG_WARNING_TAG( "Net", "Could not open capture %s", path.c_str() );
+        return false;
+    }
+    m_path = path;
+
+    BytePacker reader( fileSize, m_fileBuffer );
+    reader.SetEndianness( Endianness::LITTLE );
+    reader.SetWriteHead( fileSize );
+
+    uint magic = 0;
+    uint16 version = 0;
+    if( !reader.Read( &magic ) || magic != PACKET_CAPTURE_MAGIC
+        || !reader.Read( &version ) || version != PACKET_CAPTURE_VERSION )
+    {
+        LOG_WARNING_TAG( "Net", "%s is not a version %u capture",
+                         path.c_str(), PACKET_CAPTURE_VERSION );
+        return false;
+    }
+
+    // nothing was received while capturing
+    if( reader.GetReadableByteCount() == 0 )
+        return true;
+
+    uint8 isHost = 0;
+    uint16 myPort = 0;
+    uint16 hostPort = 0;
+    if( !reader.Read( &isHost )
+        || !reader.Read( &m_myAddress.m_ip4Address )
+        || !reader.Read( &myPort )
+        || !reader.Read( &m_hostAddress.m_ip4Address )
+        || !reader.Read( &hostPort ) )
+    {
+        LOG_WARNING_TAG( "Net", "Capture %s has a bad session header", path.c_str() );
+        return false;
+    }
+    m_isHost = isHost != 0;
+    m_myAddress.m_port = myPort;
+    m_hostAddress.m_port = hostPort;
+
+    double time = 0.0;
+    while( reader.GetReadableByteCount() != 0 )
+    {
+        CapturedPacket captured;
+        uint deltaMicroseconds = 0;
+        uint16 senderPort = 0;
+        if( !reader.Read( &deltaMicroseconds )
+            || !reader.Read( &captured.m_sender.m_ip4Address )
+            || !reader.Read( &senderPort )
+            || !reader.Read( &captured.m_byteCount )
+            || captured.m_byteCount > reader.GetReadableByteCount()
+            || captured.m_byteCount > PACKET_MTU )
+        {
+            // the game may have closed before the last flush, keep what is whole
+            LOG_WARNING_TAG( "Net", "Capture %s is cut short after %u packets",
+                             path.c_str(), (uint) m_packets.size() );
+            break;
+        }
+        time += (double) deltaMicroseconds / 1000000.0;
+        captured.m_time = time;
+        captured.m_sender.m_port = senderPort;
+        captured.m_offset = reader.GetReadHead();
+        reader.OffsetReadHead( captured.m_byteCount );
+        m_packets.push_back( captured );
+    }
+    return true;
+}
+
+void PacketReplay::Start( float speed, double currentTime )
+{
+    m_speed = Max( speed, 0.f );
+    m_startTime = currentTime;
+    m_nextPacketIdx = 0;
+}
+
+size_t PacketReplay::PopDue( double currentTime, Byte* buffer, size_t bufferSize,
+                             NetAddress& out_sender )
+{
+    if( IsFinished() )
+        return 0;
+
+    const CapturedPacket& captured = m_packets[m_nextPacketIdx];
+    if( m_speed > 0.f
+        && ( currentTime - m_startTime ) * m_speed < captured.m_time )
+        return 0;
+    if( captured.m_byteCount > bufferSize )
+        return 0;
+
+    memcpy( buffer, m_fileBuffer + captured.m_offset, captured.m_byteCount );
+    out_sender = captured.m_sender;
+    ++m_nextPacketIdx;
+
+    if( IsFinished() )
+    {
+        LOG_INFO_TAG( "Net", "Replay of %s finished after %.3fs",
+                      m_path.c_str(), currentTime - m_startTime );
+    }
+    return captured.m_byteCount;
+}
+
+string PacketReplay::GetStatusString() const
+{
+    double capturedLength = m_packets.empty() ? 0.0 : m_packets.back().m_time;
+    return Stringf( "replay %s  %s  packet %u/%u  %.1fs captured  speed %.2f",
+                    IsFinished() ? "done" : "running", m_path.c_str(),
+                    (uint) m_nextPacketIdx, (uint) m_packets.size(),
+                    capturedLength, m_speed );
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+#include "Engine/Net/NetAddress.hpp"
+
+// Plays a PacketCapture file back through a PacketChannel in place of its
+// socket, packets come out at the captured pace scaled by the speed
+class PacketReplay
+{
+public:
+    PacketReplay() {};
+    ~PacketReplay();
+
+    bool Load( const string& path );
+    // speed 1 for the captured pace, 2 for twice as fast,
+    // 0 for everything at once
+    void Start( float speed, double currentTime );
+
+    // copies the next due packet into buffer, returns its byte count,
+    // 0 if nothing is due
+    size_t PopDue( double currentTime, Byte* buffer, size_t bufferSize,
+                   NetAddress& out_sender );
+    bool IsFinished() const { return m_nextPacketIdx >= m_packets.size(); }
+
+    string GetStatusString() const;
+
+private:
+    struct CapturedPacket
+    {
+        double m_time = 0.0; // since the first packet
+        NetAddress m_sender;
+        size_t m_offset = 0; // into m_fileBuffer
+        uint16 m_byteCount = 0;
+    };
+
+public:
+
+    string m_path;
+
+    // Session the capture was taken from
+    bool m_isHost = false;
+    NetAddress m_myAddress;
+    NetAddress m_hostAddress;
+
+    Byte* m_fileBuffer = nullptr;
+    vector<CapturedPacket> m_packets;
+    size_t m_nextPacketIdx = 0;
+
+    float m_speed = 1.f;
+    double m_startTime = 0.0;
+};
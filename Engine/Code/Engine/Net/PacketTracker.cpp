@@ -13,4 +13,5 @@ void PacketTracker::Invalidate()
     m_ack = INVALID_PACKET_ACK;
     m_timeOfSend = 0.f;
     m_reliablesInPacket = 0;
+    m_isCountedLost = false;
 }
@@ -12,5 +12,6 @@ public:
 
     uint16 m_sentReliableIds[MAX_RELIABLES_PER_PACKET];
     uint m_reliablesInPacket = 0;
+    bool m_isCountedLost = false; // for congestion control, only counted once
 
 };
@@ -1,6 +1,5 @@
-#include "Engine/Core/WindowsUtils.hpp"
 #include "Engine/Net/Socket.hpp"
-#include "Engine/Core/WindowsCommon.hpp"
+#include "Engine/Net/NetPlatform.hpp"
 #include "Engine/Log/Logger.hpp"
 #include "Engine/Net/NetAddress.hpp"
 #include "Engine/String/StringUtils.hpp"
@@ -27,7 +26,7 @@ char* GetStrBuffer()
 size_t Socket::Error = (size_t) -1;
 
 
-Socket::Socket( unsigned __int64 socket )
+Socket::Socket( SocketHandle socket )
 {
     m_sock = socket;
     m_isClosed = false; // assume it is open until proven otherwise
@@ -42,15 +41,14 @@ Socket::~Socket()
 void Socket::SetBlocking( bool block )
 {
     m_blocking = block;
-    u_long nonBlocking = m_blocking ? 0 : 1;
-    int result = ioctlsocket( m_sock, FIONBIO, &nonBlocking );
-    if( result != NO_ERROR )
+    if( !NetPlatform::SetBlocking( m_sock, m_blocking ) )
     {
-        string errStr = WindowsUtils::ErrorCodeToString( result );
+        int errCode = GetLastErrorCode();
+        string errStr = NetPlatform::ErrorCodeToString( errCode );
         LOG_WARNING_TAG(
             "Net",
-            "ioctlsocket failed with error: %d, %s\n",
-            result,
+            "SetBlocking failed with error: %d, %s\n",
+            errCode,
             errStr.c_str() );
     }
 }
@@ -58,7 +56,7 @@ void Socket::SetBlocking( bool block )
 void Socket::Close()
 {
     LOG_INFO_TAG( "Net", "Connection closed %s", m_address.ToStringAll().c_str() );
-    ::closesocket( (SOCKET) m_sock );
+    NetPlatform::CloseSocket( m_sock );
     m_isClosed = true;
 }
 
@@ -78,24 +76,24 @@ bool Socket::IsFatalError( size_t result ) const
 
 bool Socket::HasFatalError() const
 {
-    int err = WSAGetLastError();
-    AssertBreakpoint( err != 10038 );
-    if( err == WSAEWOULDBLOCK || err == WSAEMSGSIZE || err == WSAECONNRESET )
+    int err = NetPlatform::GetLastErrorCode();
+    AssertBreakpoint( !NetPlatform::IsNotSocketErrorCode( err ) );
+    if( !NetPlatform::IsFatalErrorCode( err ) )
         return false;
-    string errStr = WindowsUtils::ErrorCodeToString( err );
-    LOG_WARNING_TAG( "Net", "winsock error: %d, %s", err, errStr.c_str() );
+    string errStr = NetPlatform::ErrorCodeToString( err );
+    LOG_WARNING_TAG( "Net", "socket error: %d, %s", err, errStr.c_str() );
     return true;
 }
 
 int Socket::GetLastErrorCode() const
 {
-    return WSAGetLastError();
+    return NetPlatform::GetLastErrorCode();
 }
 
 string Socket::GetLastErrorString() const
 {
     int errCode = GetLastErrorCode();
-    return WindowsUtils::ErrorCodeToString( errCode );
+    return NetPlatform::ErrorCodeToString( errCode );
 }
 
 
@@ -1,12 +1,6 @@
 #pragma once
 #include "Engine/Net/NetAddress.hpp"
-
-// net/socket.hpp
-// this is just so it is a typed pointer - but
-// internally we cast socket_t to SOCKET
-class socket_type;
-typedef socket_type* socket_t;
-
+#include "Engine/Net/NetPlatform.hpp"
 
 
 enum eSocketOptionBit : uint
@@ -28,7 +22,7 @@ public:
 public:
     Socket() {}
     // used for accept
-    Socket( unsigned __int64 socket );
+    Socket( SocketHandle socket );
 
     virtual ~Socket();
 
@@ -52,7 +46,7 @@ public:
 
 
 public:
-    unsigned __int64 m_sock = (unsigned __int64) -1;
+    SocketHandle m_sock = INVALID_SOCKET_HANDLE;
 
     // if you're a listening, the address is YOUR address
     // if you are connecting (or socket is from an accept)
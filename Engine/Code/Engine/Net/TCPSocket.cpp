@@ -1,6 +1,6 @@
-#include "Engine/Core/WindowsUtils.hpp"
 #include "Engine/Net/TCPSocket.hpp"
-#include "Engine/Core/WindowsCommon.hpp"
+#include "Engine/Net/NetPlatformCommon.hpp"
+#include <string.h>
 #include "Engine/Log/Logger.hpp"
 #include "Engine/Net/NetAddress.hpp"
 #include "Engine/String/StringUtils.hpp"
@@ -25,8 +25,8 @@ char* GetStrBuffer()
 
 TCPSocket::TCPSocket()
 {
-    m_sock = ::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
-    if( INVALID_SOCKET == m_sock )
+    m_sock = (SocketHandle) ::socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+    if( INVALID_SOCKET_HANDLE == m_sock )
     {
         LOG_WARNING_TAG( "Net", "Could not create socket" );
     }
@@ -54,7 +54,7 @@ bool TCPSocket::Listen( const NetAddress& localAddr, uint maxQueued )
     size_t addrlen;
     localAddr.ToSockAddr( (sockaddr*) &saddr, &addrlen );
 
-    size_t result = ::bind( (SOCKET) m_sock, (sockaddr*) &saddr, (int) addrlen );
+    size_t result = ::bind( (SOCKET) m_sock, (sockaddr*) &saddr, (socklen_t) addrlen );
     if( IsFatalError( result ) )
     {
         LOG_WARNING_TAG( "Net", "failed to bind socket" );
@@ -89,7 +89,7 @@ TCPSocket* TCPSocket::Accept()
         return nullptr;
     }
 
-    TCPSocket* theirTCPSock = new TCPSocket( theirSock );
+    TCPSocket* theirTCPSock = new TCPSocket( (SocketHandle) theirSock );
     theirTCPSock->m_address = NetAddress( (sockaddr*) &theirAddr );
     theirTCPSock->m_isClosed = false;
     return theirTCPSock;
@@ -101,7 +101,7 @@ bool TCPSocket::Connect( const NetAddress& addr )
     size_t addrlen;
     addr.ToSockAddr( (sockaddr*) &saddr, &addrlen );
 
-    int result = ::connect( (SOCKET) m_sock, (sockaddr*) &saddr, (int) addrlen );
+    int result = ::connect( (SOCKET) m_sock, (sockaddr*) &saddr, (socklen_t) addrlen );
     if( IsFatalError( result ) )
     {
         LOG_INFO_TAG( "Net", "Could not connect" );
@@ -115,7 +115,7 @@ bool TCPSocket::Connect( const NetAddress& addr )
 
 size_t TCPSocket::Send( void const *data, int dataByteSize )
 {
-    size_t sent = ::send( (SOCKET) m_sock, (const char*) data, dataByteSize, 0 );
+    size_t sent = ::send( (SOCKET) m_sock, (const char*) data, dataByteSize, SOCKET_SEND_FLAGS );
     if( IsFatalError( sent ) )
     {
         LOG_INFO_TAG( "Net", "Could not Send" );
@@ -8,7 +8,7 @@ public:
 
     TCPSocket();
 
-    TCPSocket( unsigned __int64 socket ) : Socket( socket ) {}
+    TCPSocket( SocketHandle socket ) : Socket( socket ) {}
 
     ~TCPSocket();
 
@@ -0,0 +1,158 @@
+#include "Engine/Net/TimerWheel.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <math.h>
+
+namespace
+{
+constexpr uint64 SLOT_MASK = TIMER_WHEEL_SLOT_COUNT - 1;
+constexpr uint64 WHEEL_RANGE_MASK =
+    ( (uint64) 1 << ( TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVEL_COUNT ) ) - 1;
+constexpr double TICKS_PER_SECOND = 1.0 / TIMER_WHEEL_TICK;
+
+// lowest level whose turn covers ticksAway
+uint GetLevel( uint64 ticksAway )
+{
+    uint level = 0;
+    while( ( ticksAway >> ( TIMER_WHEEL_SLOT_BITS * ( level + 1 ) ) ) != 0 )
+        ++level;
+    return level;
+}
+}
+
+TimerWheel::TimerWheel()
+{
+    for( auto& level : m_slots )
+    {
+        for( TimerWheelEntry& sentinel : level )
+        {
+            sentinel.m_prev = &sentinel;
+            sentinel.m_next = &sentinel;
+        }
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    Reset( 0.0 );
+}
+
+void TimerWheel::Reset( double currentTime )
+{
+    for( auto& level : m_slots )
+    {
+        for( TimerWheelEntry& sentinel : level )
+        {
+            while( sentinel.m_next != &sentinel )
+                Unlink( *sentinel.m_next );
+        }
+    }
+    m_startTime = currentTime;
+    m_currentTick = 0;
+    m_scheduledCount = 0;
+}
+
+void TimerWheel::Schedule( TimerWheelEntry& entry, double dueTime )
+{
+    if( entry.IsScheduled() )
+        Unlink( entry );
+
+    // rounded up so nothing fires early
+    double ticks = ceil( ( dueTime - m_startTime ) * TICKS_PER_SECOND );
+    uint64 dueTick = ticks <= 0.0 ? 0 : (uint64) ticks;
+    entry.m_dueTick = Max( dueTick, m_currentTick + 1 );
+    Insert( entry );
+}
+
+void TimerWheel::Cancel( TimerWheelEntry& entry )
+{
+    if( entry.IsScheduled() )
+        Unlink( entry );
+}
+
+void TimerWheel::Advance( double currentTime, vector<TimerWheelEntry*>& out_dueEntries )
+{
+    uint64 targetTick = GetTickForTime( currentTime );
+    while( m_currentTick < targetTick )
+    {
+        // nothing to visit, skip straight there
+        if( m_scheduledCount == 0 )
+        {
+            m_currentTick = targetTick;
+            return;
+        }
+
+        ++m_currentTick;
+
+        // highest first, a cascade can drop entries into the slot of the
+        // level below that is about to cascade too
+        for( uint level = TIMER_WHEEL_LEVEL_COUNT - 1; level > 0; --level )
+        {
+            uint64 lowerDigitsMask = ( (uint64) 1 << ( TIMER_WHEEL_SLOT_BITS * level ) ) - 1;
+            if( ( m_currentTick & lowerDigitsMask ) == 0 )
+                Cascade( level );
+        }
+
+        TimerWheelEntry& sentinel = m_slots[0][m_currentTick & SLOT_MASK];
+        while( sentinel.m_next != &sentinel )
+        {
+            TimerWheelEntry* entry = sentinel.m_next;
+            Unlink( *entry );
+            out_dueEntries.push_back( entry );
+        }
+    }
+}
+
+double TimerWheel::GetCurrentTime() const
+{
+    return m_startTime + (double) m_currentTick * TIMER_WHEEL_TICK;
+}
+
+uint64 TimerWheel::GetTickForTime( double time ) const
+{
+    double ticks = floor( ( time - m_startTime ) * TICKS_PER_SECOND );
+    return ticks <= 0.0 ? 0 : (uint64) ticks;
+}
+
+void TimerWheel::Insert( TimerWheelEntry& entry )
+{
+    uint level = 0;
+    uint64 slotIdx = m_currentTick & SLOT_MASK;
+    // due now only happens on a cascade, the current slot fires next
+    if( entry.m_dueTick > m_currentTick )
+    {
+        // past the range, fires at the end of it
+        uint64 delta = Min( entry.m_dueTick - m_currentTick, WHEEL_RANGE_MASK );
+        entry.m_dueTick = m_currentTick + delta;
+        level = GetLevel( delta );
+        slotIdx = ( entry.m_dueTick >> ( TIMER_WHEEL_SLOT_BITS * level ) ) & SLOT_MASK;
+    }
+
+    TimerWheelEntry& sentinel = m_slots[level][slotIdx];
+    entry.m_prev = sentinel.m_prev;
+    entry.m_next = &sentinel;
+    sentinel.m_prev->m_next = &entry;
+    sentinel.m_prev = &entry;
+    ++m_scheduledCount;
+}
+
+void TimerWheel::Unlink( TimerWheelEntry& entry )
+{
+    entry.m_prev->m_next = entry.m_next;
+    entry.m_next->m_prev = entry.m_prev;
+    entry.m_prev = nullptr;
+    entry.m_next = nullptr;
+    --m_scheduledCount;
+}
+
+void TimerWheel::Cascade( uint level )
+{
+    uint64 slotIdx = ( m_currentTick >> ( TIMER_WHEEL_SLOT_BITS * level ) ) & SLOT_MASK;
+    TimerWheelEntry& sentinel = m_slots[level][slotIdx];
+    while( sentinel.m_next != &sentinel )
+    {
+        TimerWheelEntry& entry = *sentinel.m_next;
+        Unlink( entry );
+        Insert( entry );
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Engine/Net/NetCommonH.hpp"
+
+// One scheduled event, lives in whatever owns it, the wheel only links it
+// Not copyable while scheduled
+struct TimerWheelEntry
+{
+    bool IsScheduled() const { return m_prev != nullptr; }
+
+    void* m_owner = nullptr;
+    uint m_type = 0; // what the owner should do when it fires
+
+    // Wheel
+    TimerWheelEntry* m_prev = nullptr; // slot list, nullptr when not scheduled
+    TimerWheelEntry* m_next = nullptr;
+    uint64 m_dueTick = 0;
+};
+
+// Hierarchical timer wheel, TIMER_WHEEL_LEVEL_COUNT levels of
+// TIMER_WHEEL_SLOT_COUNT slots, TIMER_WHEEL_TICK seconds apart at the bottom
+// and each level's slot spanning a whole turn of the level below. Entries sit
+// in the lowest level whose turn covers how far out they are, and move down a
+// level when the wheel reaches their slot. Scheduling and cancelling are O(1),
+// advancing costs one slot per tick plus the entries that move or fire
+// Never fires early. Entries further out than the wheel covers fire at the end
+// of its range, owners are expected to check and reschedule
+class TimerWheel
+{
+public:
+    TimerWheel();
+    ~TimerWheel();
+
+    // cancels everything, time starts at currentTime
+    void Reset( double currentTime );
+
+    // reschedules if already scheduled, a dueTime in the past fires on the
+    // next Advance
+    void Schedule( TimerWheelEntry& entry, double dueTime );
+    void Cancel( TimerWheelEntry& entry );
+
+    // appends everything due by currentTime, the entries are unscheduled
+    // and can be scheduled again right away
+    void Advance( double currentTime, vector<TimerWheelEntry*>& out_dueEntries );
+
+    size_t GetScheduledCount() const { return m_scheduledCount; }
+    double GetCurrentTime() const;
+
+private:
+    uint64 GetTickForTime( double time ) const;
+    void Insert( TimerWheelEntry& entry );
+    void Unlink( TimerWheelEntry& entry );
+    // moves a slot down a level
+    void Cascade( uint level );
+
+public:
+
+    // slot lists are circular around a sentinel so unlinking needs no checks
+    TimerWheelEntry m_slots[TIMER_WHEEL_LEVEL_COUNT][TIMER_WHEEL_SLOT_COUNT];
+    double m_startTime = 0.0;
+    uint64 m_currentTick = 0;
+    size_t m_scheduledCount = 0;
+};
@@ -1,7 +1,8 @@
 #include "Engine/Net/UDPSocket.hpp"
 #include "Engine/Net/NetAddress.hpp"
 #include "Engine/Core/EngineCommonC.hpp"
-#include "Engine/Core/WindowsCommon.hpp"
+#include "Engine/Net/NetPlatformCommon.hpp"
+#include <string.h>
 
 
 bool UDPSocket::Bind( const NetAddress &addr )
@@ -20,15 +21,16 @@ bool UDPSocket::Bind( const NetAddress &addr )
     addr.ToSockAddr( (sockaddr*) &sock_addr, &sock_addr_len );
 
     // try to bind - if it succeeds - great.  If not, try the next port in the range.
-    int result = ::bind( my_socket, (sockaddr*) &sock_addr, (int) sock_addr_len );
+    int result = ::bind( my_socket, (sockaddr*) &sock_addr, (socklen_t) sock_addr_len );
     if( 0 == result )
     {
-        m_sock = my_socket;
+        m_sock = (SocketHandle) my_socket;
         m_address = addr;
         m_isClosed = false;
         return true;
     }
 
+    NetPlatform::CloseSocket( (SocketHandle) my_socket );
     return false;
 }
 
@@ -50,7 +52,7 @@ size_t UDPSocket::SendTo( const NetAddress &addr, const void *data,
         (int) byte_count,
         0,
         (sockaddr*) &saddr,
-        (int)addr_len );
+        (socklen_t) addr_len );
 
     if( sent > 0 )
     {
@@ -77,7 +79,7 @@ size_t UDPSocket::ReceiveFrom( NetAddress& out_addr,
     //         return 0U;
 
     sockaddr_storage fromaddr;
-    int addr_len = sizeof( sockaddr_storage );
+    socklen_t addr_len = sizeof( sockaddr_storage );
 
     SOCKET sock = (SOCKET) m_sock;
 
@@ -105,3 +107,111 @@ size_t UDPSocket::ReceiveFrom( NetAddress& out_addr,
         return 0;
     }
 }
+
+#if defined( __linux__ )
+
+size_t UDPSocket::SendToBatch( const UDPDatagram* datagrams, size_t count )
+{
+    mmsghdr messages[PACKET_BATCH_SIZE];
+    iovec iovecs[PACKET_BATCH_SIZE];
+    sockaddr_storage addrs[PACKET_BATCH_SIZE];
+
+    SOCKET sock = (SOCKET) m_sock;
+    size_t totalSent = 0;
+    while( totalSent < count )
+    {
+        size_t batchCount = Min( count - totalSent, PACKET_BATCH_SIZE );
+        for( size_t i = 0; i < batchCount; ++i )
+        {
+            const UDPDatagram& datagram = datagrams[totalSent + i];
+            size_t addrLen;
+            datagram.m_address.ToSockAddr( (sockaddr*) &addrs[i], &addrLen );
+
+            iovecs[i].iov_base = datagram.m_buffer;
+            iovecs[i].iov_len = datagram.m_byteCount;
+
+            memset( &messages[i], 0, sizeof( mmsghdr ) );
+            messages[i].msg_hdr.msg_name = &addrs[i];
+            messages[i].msg_hdr.msg_namelen = (socklen_t) addrLen;
+            messages[i].msg_hdr.msg_iov = &iovecs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int sent = sendmmsg( sock, messages, (uint) batchCount, 0 );
+        if( sent <= 0 )
+        {
+            if( HasFatalError() )
+                Close();
+            break;
+        }
+        totalSent += (size_t) sent;
+    }
+    return totalSent;
+}
+
+size_t UDPSocket::ReceiveFromBatch( UDPDatagram* datagrams, size_t count )
+{
+    mmsghdr messages[PACKET_BATCH_SIZE];
+    iovec iovecs[PACKET_BATCH_SIZE];
+    sockaddr_storage addrs[PACKET_BATCH_SIZE];
+
+    count = Min( count, PACKET_BATCH_SIZE );
+    for( size_t i = 0; i < count; ++i )
+    {
+        iovecs[i].iov_base = datagrams[i].m_buffer;
+        iovecs[i].iov_len = datagrams[i].m_bufferSize;
+
+        memset( &messages[i], 0, sizeof( mmsghdr ) );
+        messages[i].msg_hdr.msg_name = &addrs[i];
+        messages[i].msg_hdr.msg_namelen = sizeof( sockaddr_storage );
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int recvd = recvmmsg( (SOCKET) m_sock, messages, (uint) count, 0, nullptr );
+    if( recvd <= 0 )
+    {
+        if( HasFatalError() )
+            Close();
+        return 0;
+    }
+
+    for( int i = 0; i < recvd; ++i )
+    {
+        datagrams[i].m_address.FromSockAddr( (sockaddr*) &addrs[i] );
+        datagrams[i].m_byteCount = messages[i].msg_len;
+    }
+    return (size_t) recvd;
+}
+
+#else
+
+size_t UDPSocket::SendToBatch( const UDPDatagram* datagrams, size_t count )
+{
+    size_t totalSent = 0;
+    for( size_t i = 0; i < count; ++i )
+    {
+        const UDPDatagram& datagram = datagrams[i];
+        if( SendTo( datagram.m_address, datagram.m_buffer, datagram.m_byteCount ) == 0 )
+            break;
+        ++totalSent;
+    }
+    return totalSent;
+}
+
+size_t UDPSocket::ReceiveFromBatch( UDPDatagram* datagrams, size_t count )
+{
+    size_t totalReceived = 0;
+    for( size_t i = 0; i < count; ++i )
+    {
+        UDPDatagram& datagram = datagrams[i];
+        datagram.m_byteCount = ReceiveFrom(
+            datagram.m_address, datagram.m_buffer, datagram.m_bufferSize );
+        if( datagram.m_byteCount == 0 )
+            break;
+        ++totalReceived;
+    }
+    return totalReceived;
+}
+
+#endif
@@ -3,6 +3,16 @@
 
 struct NetAddress;
 
+// One datagram in a batched send or receive
+// for receive m_byteCount is filled in with the bytes read
+struct UDPDatagram
+{
+    NetAddress m_address;
+    void* m_buffer = nullptr;
+    size_t m_bufferSize = 0;
+    size_t m_byteCount = 0;
+};
+
 class UDPSocket : public Socket
 {
 public:
@@ -19,4 +29,10 @@ public:
         NetAddress& out_addr,
         void *buffer,
         const size_t max_read_size );
+
+    // Batched versions, one sendmmsg/recvmmsg where the platform has it,
+    // otherwise one SendTo/ReceiveFrom per datagram
+    // returns how many datagrams were sent / received
+    size_t SendToBatch( const UDPDatagram* datagrams, size_t count );
+    size_t ReceiveFromBatch( UDPDatagram* datagrams, size_t count );
 };
@@ -1,4 +1,5 @@
 #include <stdarg.h>
+#include <stdio.h>
 #include <algorithm>
 #include <cctype>
 #include <sstream>
@@ -14,7 +15,12 @@
 #include "Engine/Math/Vec2.hpp"
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Math/Vec4.hpp"
-#include "Engine/Math/Mat4.hpp"
+
+#if !defined( _WIN32 )
+// vsnprintf always truncates and terminates
+#define _TRUNCATE 0
+#define vsnprintf_s( buffer, size, count, format, args ) vsnprintf( buffer, size, format, args )
+#endif
 
 
 namespace StringUtils
@@ -871,16 +877,6 @@ const string ToString( const Vec4& var )
     return Stringf( "Vec4(%.2f, %.2f, %.2f, %.2f)", var.x, var.y, var.z, var.w );
 }
 
-const string ToString( const Mat4& var )
-{
-    return Stringf( "%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f\n%.1f %.1f %.1f %.1f",
-                    var.Ix, var.Jx, var.Kx, var.Tx,
-                    var.Iy, var.Jy, var.Ky, var.Ty,
-                    var.Iz, var.Jz, var.Kz, var.Tz,
-                    var.Iw, var.Jw, var.Kw, var.Tw
-    );
-}
-
 const string ToString( uint var )
 {
     return ToString( (int) var );
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+
+// Fixed size lock free queue for exactly one producer thread and one consumer
+// thread. Capacity must be a power of two, one slot is kept empty so full and
+// empty can be told apart
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+    static_assert( ( Capacity & ( Capacity - 1 ) ) == 0,
+                   "SPSCQueue capacity must be a power of two" );
+public:
+    // producer only, returns false if full
+    bool Push( T const &v )
+    {
+        size_t tail = m_tail.load( std::memory_order_relaxed );
+        size_t nextTail = ( tail + 1 ) & ( Capacity - 1 );
+        if( nextTail == m_head.load( std::memory_order_acquire ) )
+            return false;
+
+        m_data[tail] = v;
+        m_tail.store( nextTail, std::memory_order_release );
+        return true;
+    }
+
+    // consumer only, returns if it succeeds
+    bool Pop( T *out_v )
+    {
+        size_t head = m_head.load( std::memory_order_relaxed );
+        if( head == m_tail.load( std::memory_order_acquire ) )
+            return false;
+
+        *out_v = m_data[head];
+        m_head.store( ( head + 1 ) & ( Capacity - 1 ), std::memory_order_release );
+        return true;
+    }
+
+    // only exact when neither end is running
+    size_t GetCount() const
+    {
+        size_t head = m_head.load( std::memory_order_acquire );
+        size_t tail = m_tail.load( std::memory_order_acquire );
+        return ( tail - head ) & ( Capacity - 1 );
+    }
+
+public:
+    T m_data[Capacity];
+    // on separate cache lines so the two ends do not fight over one
+    alignas( 64 ) std::atomic<size_t> m_head { 0 }; // written by the consumer
+    alignas( 64 ) std::atomic<size_t> m_tail { 0 }; // written by the producer
+};
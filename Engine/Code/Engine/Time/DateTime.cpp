@@ -1,9 +1,16 @@
 
+#if defined( _WIN32 )
 #include "Engine/Core/WindowsCommon.hpp"
+#else
+#include <sys/time.h>
+#include <time.h>
+#endif
 #include "Engine/Time/DateTime.hpp"
 #include "Engine/String/StringUtils.hpp"
 
-#define _SECOND ((__int64) 10000000)
+#include <stdint.h>
+
+#define _SECOND ((int64_t) 10000000)
 #define _MINUTE (60 * _SECOND)
 #define _HOUR   (60 * _MINUTE)
 #define _DAY    (24 * _HOUR)
@@ -11,6 +18,8 @@
 namespace
 {
 
+#if defined( _WIN32 )
+
 DateTime SysTimeToDateTime( const SYSTEMTIME& st )
 {
     DateTime dt;
@@ -40,7 +49,7 @@ SYSTEMTIME DateTimeToSysTime( const DateTime& dt )
     return st;
 }
 
-__int64 DateTimeToInt( const DateTime& dt )
+int64_t DateTimeToInt( const DateTime& dt )
 {
     SYSTEMTIME st = DateTimeToSysTime( dt );
 
@@ -55,7 +64,7 @@ __int64 DateTimeToInt( const DateTime& dt )
     return large.QuadPart;
 }
 
-DateTime IntToDateTime( __int64 i )
+DateTime IntToDateTime( int64_t i )
 {
     ULARGE_INTEGER large;
     large.QuadPart = i;
@@ -70,9 +79,50 @@ DateTime IntToDateTime( __int64 i )
     return SysTimeToDateTime( st );
 }
 
+#else
 
+// 100ns ticks like a FILETIME, but from 1970
+DateTime TmToDateTime( const tm& t, int milliseconds )
+{
+    DateTime dt;
+    dt.year = t.tm_year + 1900;
+    dt.month = t.tm_mon + 1;
+    dt.dayOfWeek = t.tm_wday;
+    dt.day = t.tm_mday;
+    dt.hour = t.tm_hour;
+    dt.minute = t.tm_min;
+    dt.second = t.tm_sec;
+    dt.milliseconds = milliseconds;
+    return dt;
+}
+
+int64_t DateTimeToInt( const DateTime& dt )
+{
+    tm t = {};
+    t.tm_year = dt.year - 1900;
+    t.tm_mon = dt.month - 1;
+    t.tm_mday = dt.day;
+    t.tm_hour = dt.hour;
+    t.tm_min = dt.minute;
+    t.tm_sec = dt.second;
+    int64_t seconds = (int64_t) timegm( &t );
+    return seconds * _SECOND + (int64_t) dt.milliseconds * ( _SECOND / 1000 );
+}
+
+DateTime IntToDateTime( int64_t i )
+{
+    time_t seconds = (time_t) ( i / _SECOND );
+    tm t;
+    gmtime_r( &seconds, &t );
+    return TmToDateTime( t, (int) ( ( i % _SECOND ) / ( _SECOND / 1000 ) ) );
 }
 
+#endif
+
+}
+
+#if defined( _WIN32 )
+
 DateTime DateTime::GetLocalTime()
 {
     SYSTEMTIME lt;
@@ -82,11 +132,25 @@ DateTime DateTime::GetLocalTime()
     return SysTimeToDateTime( lt );
 }
 
+#else
+
+DateTime DateTime::GetLocalTime()
+{
+    timeval now;
+    gettimeofday( &now, nullptr );
+    time_t seconds = now.tv_sec;
+    tm lt;
+    localtime_r( &seconds, &lt );
+    return TmToDateTime( lt, (int) ( now.tv_usec / 1000 ) );
+}
+
+#endif
+
 void DateTime::AddSeconds( double seconds )
 {
-    __int64 i = DateTimeToInt( *this );
+    int64_t i = DateTimeToInt( *this );
 
-    i += (__int64) ( seconds * (double) _SECOND );
+    i += (int64_t) ( seconds * (double) _SECOND );
 
     *this = IntToDateTime( i );
     return;
@@ -94,17 +158,17 @@ void DateTime::AddSeconds( double seconds )
 
 bool DateTime::IsInRange( const DateTime& start, const DateTime& end ) const
 {
-    __int64 i = DateTimeToInt( *this );
-    __int64 startI = DateTimeToInt( start );
-    __int64 endI = DateTimeToInt( end );
+    int64_t i = DateTimeToInt( *this );
+    int64_t startI = DateTimeToInt( start );
+    int64_t endI = DateTimeToInt( end );
 
     return i >= startI && i <= endI;
 }
 
 double DateTime::SecondsSince( const DateTime& sinceThisTime ) const
 {
-    __int64 i = DateTimeToInt( *this );
-    __int64 sinceI = DateTimeToInt( sinceThisTime );
+    int64_t i = DateTimeToInt( *this );
+    int64_t sinceI = DateTimeToInt( sinceThisTime );
     return (double) ( (double) ( i - sinceI ) / (double) _SECOND );
 }
 
@@ -129,15 +193,15 @@ string DateTime::ToStringFileFriendly()
 
 bool DateTime::operator>( const DateTime& rhs ) const
 {
-    __int64 i = DateTimeToInt( *this );
-    __int64 rhsI = DateTimeToInt( rhs );
+    int64_t i = DateTimeToInt( *this );
+    int64_t rhsI = DateTimeToInt( rhs );
     return i > rhsI;
 }
 
 bool DateTime::operator>=( const DateTime& rhs ) const
 {
-    __int64 i = DateTimeToInt( *this );
-    __int64 rhsI = DateTimeToInt( rhs );
+    int64_t i = DateTimeToInt( *this );
+    int64_t rhsI = DateTimeToInt( rhs );
     return i >= rhsI;
 }
 
@@ -158,7 +222,7 @@ bool DateTime::operator!=( const DateTime& rhs ) const
 
 bool DateTime::operator==( const DateTime& rhs ) const
 {
-    __int64 i = DateTimeToInt( *this );
-    __int64 rhsI = DateTimeToInt( rhs );
+    int64_t i = DateTimeToInt( *this );
+    int64_t rhsI = DateTimeToInt( rhs );
     return i == rhsI;
 }
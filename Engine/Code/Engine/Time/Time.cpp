@@ -5,11 +5,16 @@
 
 #include "Engine/Time/Time.hpp"
 
+#if defined( _WIN32 )
 #include "Engine/Core/WindowsCommon.hpp"
+#else
+#include <time.h>
+#endif
 
 #include <ctime>
 
 
+#if defined( _WIN32 )
 
 double InitializeTime( LARGE_INTEGER& out_initialTime )
 {
@@ -33,6 +38,28 @@ double TimeUtils::GetCurrentTimeSecondsD()
     return currentSeconds;
 }
 
+#else
+
+double InitializeTime( timespec& out_initialTime )
+{
+    clock_gettime( CLOCK_MONOTONIC, &out_initialTime );
+    return 1e-9;
+}
+
+double TimeUtils::GetCurrentTimeSecondsD()
+{
+    static timespec initialTime;
+    static double secondsPerNano = InitializeTime( initialTime );
+    timespec currentTime;
+    clock_gettime( CLOCK_MONOTONIC, &currentTime );
+    double elapsedSeconds = (double) ( currentTime.tv_sec - initialTime.tv_sec );
+    double elapsedNanos = (double) ( currentTime.tv_nsec - initialTime.tv_nsec );
+
+    return elapsedSeconds + elapsedNanos * secondsPerNano;
+}
+
+#endif
+
 float TimeUtils::GetCurrentTimeSecondsF()
 {
     return (float)GetCurrentTimeSecondsD();
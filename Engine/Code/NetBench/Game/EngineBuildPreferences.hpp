@@ -0,0 +1,9 @@
+//-----------------------------------------------------------------------------------------------
+// EngineBuildPreferences.hpp
+//
+// Build preferences for the headless net bench, see the game's copy.
+//
+
+#define ENGINE_DISABLE_AUDIO	// no audio on bench boxes
+//#define DISABLE_LOGGING
+//#define PROFILING_ENABLED
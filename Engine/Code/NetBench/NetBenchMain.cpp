@@ -0,0 +1,123 @@
+// Headless net bench, runs a NetSession through HeadlessNetDriver without
+// App, Renderer or Window
+//
+//   net_bench host [port] [seconds]
+//   net_bench join <ip:port> [seconds]
+//   net_bench timers [connections] [seconds a pass] [hz]
+//
+// host and join print the driver stats every second, timers hosts and runs
+// HeadlessNetDriver::RunIdleConnectionBenchmark
+
+#include "Engine/Net/HeadlessNetDriver.hpp"
+#include "Engine/Net/NetCommonC.hpp"
+#include "Engine/Log/Logger.hpp"
+#include "Engine/Log/LogEntry.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace
+{
+
+constexpr int DEFAULT_BENCH_PORT = 10084;
+constexpr float DEFAULT_BENCH_SECONDS = 10.f;
+constexpr float STATS_INTERVAL = 1.f;
+constexpr int DEFAULT_IDLE_CONNECTIONS = 1024;
+constexpr float DEFAULT_TIMER_BENCH_SECONDS = 5.f;
+
+void PrintLogEntry( LogEntry* entry, void* )
+{
+    printf( "%-7s %-10s %s\n", LogLevelToString( entry->m_level ).c_str(),
+            entry->m_tag.c_str(), entry->m_text.c_str() );
+}
+
+void FlushStdout( void* )
+{
+    fflush( stdout );
+}
+
+void PrintUsage()
+{
+    printf( "usage:\n"
+            "  net_bench host [port] [seconds]\n"
+            "  net_bench join <ip:port> [seconds]\n"
+            "  net_bench timers [connections] [seconds a pass] [hz]\n" );
+}
+
+// false if the session dropped
+bool RunAndReport( HeadlessNetDriver& driver, NetSession& session, float seconds )
+{
+    for( float elapsed = 0.f; elapsed < seconds; elapsed += STATS_INTERVAL )
+    {
+        driver.ResetStats();
+        driver.RunFor( STATS_INTERVAL );
+        printf( "%s\n", driver.GetStatsString().c_str() );
+        if( session.m_state == eSessionState::DISCONNECTED
+            || session.m_state == eSessionState::SHOULD_DISCONNECT )
+        {
+            printf( "session disconnected\n" );
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        PrintUsage();
+        return 1;
+    }
+    string mode = argv[1];
+    if( mode != "host" && mode != "timers" && !( mode == "join" && argc >= 3 ) )
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Logger* logger = Logger::GetDefault();
+    logger->AddLogHook( PrintLogEntry, nullptr );
+    logger->AddFlushHook( FlushStdout, nullptr );
+    logger->StartUp();
+
+    NetSession* session = NetSession::GetDefault();
+    HeadlessNetDriver driver( session );
+    driver.StartUp();
+
+    bool succeeded = false;
+    if( mode == "host" )
+    {
+        int port = argc >= 3 ? atoi( argv[2] ) : DEFAULT_BENCH_PORT;
+        float seconds = argc >= 4 ? (float) atof( argv[3] ) : DEFAULT_BENCH_SECONDS;
+        session->Host( "bench_host", port );
+        if( session->m_state == eSessionState::READY )
+            succeeded = RunAndReport( driver, *session, seconds );
+    }
+    else if( mode == "timers" )
+    {
+        int connectionCount = argc >= 3 ? atoi( argv[2] ) : DEFAULT_IDLE_CONNECTIONS;
+        float seconds = argc >= 4 ? (float) atof( argv[3] ) : DEFAULT_TIMER_BENCH_SECONDS;
+        float frameRate = argc >= 5 ? (float) atof( argv[4] ) : 1000.f / NET_THREAD_SLEEP_MS;
+        session->Host( "bench_host", DEFAULT_BENCH_PORT, 8U );
+        if( session->m_state == eSessionState::READY && connectionCount > 0 && frameRate > 0.f )
+        {
+            printf( "%s\n", driver.RunIdleConnectionBenchmark(
+                (size_t) connectionCount, seconds, frameRate ).c_str() );
+            succeeded = true;
+        }
+    }
+    else
+    {
+        float seconds = argc >= 4 ? (float) atof( argv[3] ) : DEFAULT_BENCH_SECONDS;
+        session->Join( "bench_client", NetAddress( string( argv[2] ) ) );
+        if( session->m_state != eSessionState::DISCONNECTED )
+            succeeded = RunAndReport( driver, *session, seconds );
+    }
+
+    driver.ShutDown();
+    logger->ShutDown();
+    return succeeded ? 0 : 1;
+}
@@ -1,4 +1,27 @@
 #include "Game/ClientInputs.hpp"
 
+Vec3 ClientInputs::GetMoveDirection() const
+{
+    return up * Vec3::UP
+        + left * Vec3::LEFT
+        + down * Vec3::DOWN
+        + right * Vec3::RIGHT;
+}
 
+uint ClientInputs::GetButtonBits() const
+{
+    return (uint) up
+        | (uint) left << 1
+        | (uint) down << 2
+        | (uint) right << 3
+        | (uint) fire << 4;
+}
 
+void ClientInputs::SetButtonBits( uint bits )
+{
+    up = ( bits & 1 ) != 0;
+    left = ( bits & 1 << 1 ) != 0;
+    down = ( bits & 1 << 2 ) != 0;
+    right = ( bits & 1 << 3 ) != 0;
+    fire = ( bits & 1 << 4 ) != 0;
+}
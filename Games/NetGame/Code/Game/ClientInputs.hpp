@@ -1,14 +1,26 @@
 #pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Math/Vec3.hpp"
 
-
+// One frame of input from a client, the host simulates them in sequence
+// order for as long as each was held, see Player::SimulateMovement
 class ClientInputs
 {
 public:
+    // not normalized, zero when no direction is held
+    Vec3 GetMoveDirection() const;
+    float GetDurationSeconds() const { return (float) m_durationMS / 1000.f; }
+
+    // one bit per button, INPUT_BUTTON_COUNT bits
+    uint GetButtonBits() const;
+    void SetButtonBits( uint bits );
+
     bool up = false;
     bool down = false;
     bool left = false;
     bool right = false;
     bool fire = false;
 
-
+    uint16 m_sequence = 0;
+    uint8 m_durationMS = 0; // whole ms so the host and the client agree
 };
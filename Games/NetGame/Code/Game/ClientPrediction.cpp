@@ -0,0 +1,79 @@
+#include "Engine/Math/MathUtils.hpp"
+
+#include "Game/ClientPrediction.hpp"
+#include "Game/Player.hpp"
+
+void ClientPrediction::Reset()
+{
+    m_oldestSequence = 0;
+    m_nextSequence = 0;
+    m_carrySeconds = 0.f;
+    m_netID = INVALID_NET_ID;
+    m_predictedPosition = Vec3::ZEROS;
+    m_direction = Vec3::UP;
+    m_errorOffset = Vec3::ZEROS;
+}
+
+void ClientPrediction::AddInput( ClientInputs& inout_inputs, float deltaSeconds )
+{
+    float seconds = Min( deltaSeconds, INPUT_MAX_DURATION_MS / 1000.f ) + m_carrySeconds;
+    uint durationMS = Min( (uint) ( seconds * 1000.f ), (uint) INPUT_MAX_DURATION_MS );
+    m_carrySeconds = Max( seconds - (float) durationMS / 1000.f, 0.f );
+
+    inout_inputs.m_sequence = m_nextSequence;
+    inout_inputs.m_durationMS = (uint8) durationMS;
+
+    // host went quiet for a long time, the oldest input is lost
+    if( (uint16) ( m_nextSequence - m_oldestSequence ) == PREDICTION_HISTORY_SIZE )
+        ++m_oldestSequence;
+    m_history[m_nextSequence % PREDICTION_HISTORY_SIZE] = inout_inputs;
+    ++m_nextSequence;
+
+    if( IsPredicting() )
+        Predict( inout_inputs );
+}
+
+void ClientPrediction::Reconcile( uint16 netID,
+                                  uint16 lastProcessedInput,
+                                  const Vec3& hostPosition )
+{
+    // snapshot from before an input we already dropped, the host sends
+    // one before our first input until it has simulated one
+    if( CyclicLesser( lastProcessedInput, (uint16) ( m_oldestSequence - 1 ) )
+        || CyclicGreaterEqual( lastProcessedInput, m_nextSequence ) )
+        return;
+    m_oldestSequence = lastProcessedInput + 1;
+
+    Vec3 oldRenderPosition = GetRenderPosition();
+    m_predictedPosition = hostPosition;
+    for( uint16 sequence = m_oldestSequence; sequence != m_nextSequence; ++sequence )
+        Predict( m_history[sequence % PREDICTION_HISTORY_SIZE] );
+
+    // hide the correction unless it is too large to look like movement,
+    // the first snapshot with our cube has nothing to blend from
+    m_errorOffset = oldRenderPosition - m_predictedPosition;
+    if( netID != m_netID
+        || m_errorOffset.GetLengthSquared()
+        > PREDICTION_SNAP_DISTANCE * PREDICTION_SNAP_DISTANCE )
+        m_errorOffset = Vec3::ZEROS;
+    m_netID = netID;
+}
+
+uint ClientPrediction::GetUnackedInputs( ClientInputs* out_inputs, uint maxCount ) const
+{
+    uint count = Min( (uint) (uint16) ( m_nextSequence - m_oldestSequence ), maxCount );
+    uint16 sequence = (uint16) ( m_nextSequence - count );
+    for( uint inputIdx = 0; inputIdx < count; ++inputIdx, ++sequence )
+        out_inputs[inputIdx] = m_history[sequence % PREDICTION_HISTORY_SIZE];
+    return count;
+}
+
+void ClientPrediction::Update( float deltaSeconds )
+{
+    m_errorOffset = m_errorOffset * Max( 1.f - PREDICTION_ERROR_DECAY * deltaSeconds, 0.f );
+}
+
+void ClientPrediction::Predict( const ClientInputs& inputs )
+{
+    Player::SimulateMovement( inputs, m_predictedPosition, m_direction );
+}
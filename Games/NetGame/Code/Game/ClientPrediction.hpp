@@ -0,0 +1,50 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/GameplayDefines.hpp"
+#include "Game/ClientInputs.hpp"
+
+// Client side, moves the local player's cube as soon as a key is pressed
+// instead of a round trip later. Inputs the host has not processed yet are
+// kept and replayed on top of every position the host sends back
+class ClientPrediction
+{
+public:
+    void Reset();
+
+    // numbers the input and sets how long it was held, then predicts it
+    // frame time under a whole ms carries over to the next input
+    void AddInput( ClientInputs& inout_inputs, float deltaSeconds );
+
+    // from a snapshot, hostPosition is where the host had the cube after
+    // simulating lastProcessedInput
+    void Reconcile( uint16 netID, uint16 lastProcessedInput, const Vec3& hostPosition );
+
+    // blends out small corrections
+    void Update( float deltaSeconds );
+
+    // newest inputs the host has not acked, oldest first, returns the count
+    uint GetUnackedInputs( ClientInputs* out_inputs, uint maxCount ) const;
+
+    bool IsPredicting() const { return m_netID != INVALID_NET_ID; }
+    uint16 GetNetID() const { return m_netID; }
+    Vec3 GetRenderPosition() const { return m_predictedPosition + m_errorOffset; }
+    const Vec3& GetDirection() const { return m_direction; }
+
+private:
+    void Predict( const ClientInputs& inputs );
+
+public:
+
+    // Inputs not processed by the host, oldest to next
+    ClientInputs m_history[PREDICTION_HISTORY_SIZE];
+    uint16 m_oldestSequence = 0;
+    uint16 m_nextSequence = 0;
+    float m_carrySeconds = 0.f;
+
+    // Cube, unknown until the first snapshot
+    uint16 m_netID = INVALID_NET_ID;
+    Vec3 m_predictedPosition = Vec3::ZEROS;
+    Vec3 m_direction = Vec3::UP;
+    Vec3 m_errorOffset = Vec3::ZEROS; // rendered on top of the prediction
+};
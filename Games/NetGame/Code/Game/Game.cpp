@@ -481,7 +481,7 @@ void Game::UpdateNetworkTest()
             break;
         }
 
-        NetSession::GetDefault()->SendToConnection( (uint8) s_idx, msg );
+        NetSession::GetDefault()->SendToConnection( (ConnectionIdx) s_idx, msg );
         s_currentCount += 1;
     }
 }
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include "Game/GameCommon.hpp"
 #include "Game/Game.hpp"
 #include "Game/App.hpp"
+#include "Game/GameState_Playing.hpp"
+#include "Game/NetCube.hpp"
 #include "Engine/Net/UDPTest.hpp"
 
 
@@ -305,5 +307,131 @@ void GameCommands::RegisterAllCommands()
         SystemUtils::CloneProcess( "tile_window=3 auto_join" );
     } );
 
+    commandSys->AddCommand( "net_interp", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        GameState_Playing* playing = GameState_Playing::GetDefault();
+        if( playing == nullptr )
+        {
+            LOG_WARNING( "net_interp needs the playing state" );
+            return;
+        }
+        InterpolationSettings& settings = playing->GetInterpolationSettings();
+
+        string option;
+        if( !parser.GetNext( option ) )
+        {
+            Print( settings.GetStatsString() );
+            return;
+        }
+        if( option == "reset" )
+        {
+            settings.ResetStats();
+            return;
+        }
+
+        float seconds;
+        if( !parser.GetNext( seconds ) || seconds < 0.f
+            || ( option != "delay" && option != "extrapolate" ) )
+        {
+            LOG_WARNING( "net_interp takes no args, reset, delay <seconds> or extrapolate <seconds>" );
+            return;
+        }
+        if( option == "delay" )
+            settings.m_delay = seconds;
+        else
+            settings.m_extrapolationLimit = seconds;
+        settings.ResetStats();
+        Print( settings.GetStatsString() );
+    } );
+
+    commandSys->AddCommand( "snapshot_budget", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        GameState_Playing* playing = GameState_Playing::GetDefault();
+        if( playing == nullptr )
+        {
+            LOG_WARNING( "snapshot_budget needs the playing state" );
+            return;
+        }
+
+        string option;
+        if( !parser.GetNext( option ) )
+        {
+            Print( playing->GetPriorityStatsString() );
+            return;
+        }
+        if( option == "reset" )
+        {
+            playing->ResetPriorityStats();
+            return;
+        }
+
+        uint byteCount;
+        if( option != "set" || !parser.GetNext( byteCount ) )
+        {
+            LOG_WARNING( "snapshot_budget takes no args, reset or set <bytes>, 0 for no budget" );
+            return;
+        }
+        playing->SetSnapshotByteBudget( byteCount );
+        playing->ResetPriorityStats();
+        Print( playing->GetPriorityStatsString() );
+    } );
+
+    commandSys->AddCommand( "net_interest", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        GameState_Playing* playing = GameState_Playing::GetDefault();
+        if( playing == nullptr )
+        {
+            LOG_WARNING( "net_interest needs the playing state" );
+            return;
+        }
+
+        if( parser.NumOfParams() > 0 )
+        {
+            float radius;
+            if( !parser.GetNext( radius ) || radius < 0.f )
+            {
+                LOG_WARNING( "net_interest takes no args or a radius, 0 for every cube" );
+                return;
+            }
+            playing->SetInterestRadius( radius );
+        }
+        Print( playing->GetInterestStatsString() );
+    } );
+
+    commandSys->AddCommand( "spawn_cubes", []( string& str )
+    {
+        CommandParameterParser parser( str );
+        GameState_Playing* playing = GameState_Playing::GetDefault();
+        uint count;
+        if( !parser.GetNext( count ) )
+        {
+            LOG_WARNING( "spawn_cubes takes 1 arg, count" );
+            return;
+        }
+        if( playing == nullptr || !playing->IsHost() )
+        {
+            LOG_WARNING( "spawn_cubes needs the playing state on the host" );
+            return;
+        }
+        uint spawnedCount = playing->SpawnCubes( count );
+        Print( Stringf( "spawned %u cubes, %u total",
+                        spawnedCount, (uint) NetCube::GetAllCubes().size() ) );
+    } );
+
+    commandSys->AddCommand( "join_stats", []( string& str )
+    {
+        UNUSED( str );
+        GameState_Playing* playing = GameState_Playing::GetDefault();
+        if( playing == nullptr )
+        {
+            LOG_WARNING( "join_stats needs the playing state" );
+            return;
+        }
+        Print( playing->GetJoinStatsString() );
+    } );
+
 }
 
@@ -1,24 +1,94 @@
 #include "Engine/Net/EngineNetMessages.hpp"
 #include "Engine/Core/EngineCommonC.hpp"
 #include "Engine/Net/NetMessage.hpp"
+#include "Engine/DataUtils/BitPacker.hpp"
 #include "Game/NetCube.hpp"
+#include "Game/Snapshot.hpp"
 
 #include "Game/GameNetMessages.hpp"
 #include "Game/GameState_Playing.hpp"
 
+namespace
+{
+
+void WriteSnapshotChunk( NetMessage* msg,
+                         uint16 snapshotID,
+                         uint16 baselineID,
+                         uint hostTimeMS,
+                         uint16 playerNetID,
+                         uint16 lastProcessedInput,
+                         bool hasDeferred,
+                         uint8 chunkIdx,
+                         uint8 chunkCount,
+                         const SnapshotDeltaEntry* entries,
+                         uint16 entryCount )
+{
+    BitPacker bits( *msg );
+    bits.WriteBits( snapshotID, 16 );
+    bits.WriteBits( baselineID, 16 );
+    bits.WriteBits( hostTimeMS, 32 );
+    bits.WriteBits( playerNetID, 16 );
+    bits.WriteBits( lastProcessedInput, 16 );
+    bits.WriteBool( hasDeferred );
+    bits.WriteUint( chunkIdx, MAX_SNAPSHOT_CHUNKS - 1 );
+    bits.WriteUint( chunkCount - 1U, MAX_SNAPSHOT_CHUNKS - 1 );
+    bits.WriteUint( entryCount, MAX_NET_ID_COUNT );
+    for( uint16 entryIdx = 0; entryIdx < entryCount; ++entryIdx )
+        entries[entryIdx].Write( bits );
+    bits.FlushWrite();
+}
+
+void ReadSnapshotChunk( NetMessage* netMessage )
+{
+    BitPacker bits( *netMessage );
+    uint32 snapshotID, baselineID, hostTimeMS, playerNetID, lastProcessedInput;
+    uint chunkIdx, chunkCountMinusOne, entryCount;
+    bool hasDeferred;
+    bits.ReadBits( &snapshotID, 16 );
+    bits.ReadBits( &baselineID, 16 );
+    bits.ReadBits( &hostTimeMS, 32 );
+    bits.ReadBits( &playerNetID, 16 );
+    bits.ReadBits( &lastProcessedInput, 16 );
+    bits.ReadBool( &hasDeferred );
+    bits.ReadUint( &chunkIdx, MAX_SNAPSHOT_CHUNKS - 1 );
+    bits.ReadUint( &chunkCountMinusOne, MAX_SNAPSHOT_CHUNKS - 1 );
+    bits.ReadUint( &entryCount, MAX_NET_ID_COUNT );
+    GameState_Playing* playing = GameState_Playing::GetDefault();
+    if( playing && !bits.HasFailed() )
+    {
+        playing->Process_Snapshot( (uint16) snapshotID, (uint16) baselineID, hostTimeMS,
+                                   (uint16) playerNetID, (uint16) lastProcessedInput,
+                                   hasDeferred, (uint8) chunkIdx, (uint8) ( chunkCountMinusOne + 1 ),
+                                   (uint16) entryCount, bits );
+    }
+    // dropped chunks are not read, that is fine
+    netMessage->SetReadHead( netMessage->GetWrittenByteCount() );
+}
+
+}
+
 //--------------------------------------------------------------------------------------
 // Game Message Test
 
 namespace GameNetMessages
 {
 
+// defined by the registrations below
+NET_MESSAGE_DECLARE( unreliable_test );
+NET_MESSAGE_DECLARE( reliable_test );
+NET_MESSAGE_DECLARE( sequence_test );
+NET_MESSAGE_DECLARE( snapshot );
+NET_MESSAGE_DECLARE( join_snapshot );
+NET_MESSAGE_DECLARE( snapshot_ack );
+NET_MESSAGE_DECLARE( send_inputs );
+NET_MESSAGE_DECLARE( enter_game );
 
 //--------------------------------------------------------------------------------------
 // UnreliableTest
 
 NetMessage* Compose_UnreliableTest( uint currentCount, uint totalCount )
 {
-    NetMessage* msg = new NetMessage( "unreliable_test" );
+    NetMessage* msg = new NetMessage( unreliable_test_handle );
     string msgString = Stringf( "(%u,%u)", currentCount, totalCount );
     msg->WriteString( msgString.c_str() );
     return msg;
@@ -40,7 +110,7 @@ NET_MESSAGE_STATIC_REGSITER( unreliable_test, eNetMessageFlag::DEFAULT,
 
 NetMessage* Compose_ReliableTest( uint currentCount, uint totalCount )
 {
-    NetMessage* msg = new NetMessage( "reliable_test" );
+    NetMessage* msg = new NetMessage( reliable_test_handle );
     string msgString = Stringf( "(%u,%u)", currentCount, totalCount );
     msg->WriteString( msgString.c_str() );
     return msg;
@@ -60,7 +130,7 @@ NET_MESSAGE_STATIC_REGSITER( reliable_test, eNetMessageFlag::RELIABLE,
 // SequenceTest
 NetMessage* Compose_SequenceTest( uint currentCount, uint totalCount )
 {
-    NetMessage* msg = new NetMessage( "sequence_test" );
+    NetMessage* msg = new NetMessage( sequence_test_handle );
     string msgString = Stringf( "(%u,%u)", currentCount, totalCount );
     msg->WriteString( msgString.c_str() );
     return msg;
@@ -78,81 +148,81 @@ NET_MESSAGE_STATIC_REGSITER(
 }
 
 //--------------------------------------------------------------------------------------
-// CreateCube
-NetMessage* Compose_CreateCube( NetCube* cube )
-{
-    NetMessage* msg = new NetMessage( "create_cube" );
-    Transform& t = cube->GetTransform();
-    msg->Write( t.GetLocalPosition() );
-    msg->Write( t.GetLocalScale() );
-    msg->Write( cube->GetColor() );
-    msg->Write( cube->m_velocity );
-    msg->Write( cube->GetNetID() );
+// Snapshot
+
+NetMessage* Compose_Snapshot( uint16 snapshotID,
+                              uint16 baselineID,
+                              uint hostTimeMS,
+                              uint16 playerNetID,
+                              uint16 lastProcessedInput,
+                              bool hasDeferred,
+                              uint8 chunkIdx,
+                              uint8 chunkCount,
+                              const SnapshotDeltaEntry* entries,
+                              uint16 entryCount )
+{
+    NetMessage* msg = new NetMessage( snapshot_handle );
+    WriteSnapshotChunk( msg, snapshotID, baselineID, hostTimeMS, playerNetID,
+                        lastProcessedInput, hasDeferred, chunkIdx, chunkCount,
+                        entries, entryCount );
     return msg;
 }
 
 NET_MESSAGE_STATIC_REGSITER_AUTO(
-    create_cube,
-    eNetMessageFlag::RELIABLE_IN_ORDER )
+    snapshot,
+    eNetMessageFlag::DEFAULT )
 {
-    Vec3 pos, scale, velocity;
-    Rgba color;
-    uint16 netID;
-    netMessage->Read( &pos );
-    netMessage->Read( &scale );
-    netMessage->Read( &color );
-    netMessage->Read( &velocity );
-    netMessage->Read( &netID );
-    GameState_Playing::GetDefault()->Process_CreateCube(
-        pos, velocity, scale, color, netID );
+    ReadSnapshotChunk( netMessage );
     return true;
 }
 
 //--------------------------------------------------------------------------------------
-// DestroyCube
+// JoinSnapshot
 
-NetMessage* Compose_DestroyCube( uint16 netID )
+NetMessage* Compose_JoinSnapshot( uint16 snapshotID,
+                                  uint hostTimeMS,
+                                  uint16 playerNetID,
+                                  uint16 lastProcessedInput,
+                                  uint8 chunkIdx,
+                                  uint8 chunkCount,
+                                  const SnapshotDeltaEntry* entries,
+                                  uint16 entryCount )
 {
-    NetMessage* msg = new NetMessage( "destroy_cube" );
-    msg->Write( netID );
+    NetMessage* msg = new NetMessage( join_snapshot_handle );
+    WriteSnapshotChunk( msg, snapshotID, INVALID_SNAPSHOT_ID, hostTimeMS, playerNetID,
+                        lastProcessedInput, false, chunkIdx, chunkCount, entries, entryCount );
     return msg;
 }
 
+// chunks can complete in any order, no need for in order
 NET_MESSAGE_STATIC_REGSITER_AUTO(
-    destroy_cube,
-    eNetMessageFlag::RELIABLE_IN_ORDER )
+    join_snapshot,
+    eNetMessageFlag::RELIABLE )
 {
-    uint16 netID;
-    netMessage->Read( &netID );
-    GameState_Playing::GetDefault()->Process_DestroyCube( netID );
+    ReadSnapshotChunk( netMessage );
     return true;
 }
 
 //--------------------------------------------------------------------------------------
-// UpdateCube
+// SnapshotAck
 
-NetMessage* Compose_UpdateCube( NetCube* cube )
+NetMessage* Compose_SnapshotAck( uint16 snapshotID )
 {
-    NetMessage* msg = new NetMessage( "update_cube" );
-    Transform& t = cube->GetTransform();
-    msg->Write( t.GetLocalPosition() );
-    msg->Write( cube->GetColor() );
-    msg->Write( cube->GetNetID() );
+    NetMessage* msg = new NetMessage( snapshot_ack_handle );
+    msg->Write( snapshotID );
     return msg;
 }
 
 NET_MESSAGE_STATIC_REGSITER_AUTO(
-    update_cube,
+    snapshot_ack,
     eNetMessageFlag::DEFAULT )
 {
-    Vec3 pos;
-    Rgba color;
-    uint16 netID;
-    netMessage->Read( &pos );
-    netMessage->Read( &color );
-    netMessage->Read( &netID );
-    GameState_Playing::GetDefault()->Process_UpdateCube(
-        pos, color, netID );
+    uint16 snapshotID;
+    netMessage->Read( &snapshotID );
+    ConnectionIdx playerID = netMessage->m_senderIdx;
+    GameState_Playing* playing = GameState_Playing::GetDefault();
+    if( playing )
+        playing->Process_SnapshotAck( playerID, snapshotID );
     return true;
 }
 
@@ -160,14 +230,32 @@ NET_MESSAGE_STATIC_REGSITER_AUTO(
 // SendInputs
 
 
-NetMessage* Compose_SendInputs( const ClientInputs& inputs )
+NetMessage* Compose_SendInputs( const ClientInputs* inputs, uint count )
 {
-    NetMessage* msg = new NetMessage( "send_inputs" );
-    msg->Write( inputs.up );
-    msg->Write( inputs.left );
-    msg->Write( inputs.down );
-    msg->Write( inputs.right );
-    msg->Write( inputs.fire );
+    NetMessage* msg = new NetMessage( send_inputs_handle );
+    // newest sequence and count, then newest first, each input only
+    // writes the buttons and duration that differ from the one after it
+    BitPacker bits( *msg );
+    const ClientInputs& newest = inputs[count - 1];
+    bits.WriteBits( newest.m_sequence, 16 );
+    bits.WriteUint( count - 1, INPUT_REDUNDANCY - 1 );
+    bits.WriteBits( newest.GetButtonBits(), INPUT_BUTTON_COUNT );
+    bits.WriteUint( newest.m_durationMS, INPUT_MAX_DURATION_MS );
+    for( int inputIdx = (int) count - 2; inputIdx >= 0; --inputIdx )
+    {
+        const ClientInputs& input = inputs[inputIdx];
+        const ClientInputs& next = inputs[inputIdx + 1];
+        uint buttons = input.GetButtonBits();
+        bool buttonsChanged = buttons != next.GetButtonBits();
+        bits.WriteBool( buttonsChanged );
+        if( buttonsChanged )
+            bits.WriteBits( buttons, INPUT_BUTTON_COUNT );
+        bool durationChanged = input.m_durationMS != next.m_durationMS;
+        bits.WriteBool( durationChanged );
+        if( durationChanged )
+            bits.WriteUint( input.m_durationMS, INPUT_MAX_DURATION_MS );
+    }
+    bits.FlushWrite();
     return msg;
 }
 
@@ -175,14 +263,43 @@ NET_MESSAGE_STATIC_REGSITER_AUTO(
     send_inputs,
     eNetMessageFlag::DEFAULT )
 {
-    ClientInputs inputs;
-    netMessage->Read( &inputs.up );
-    netMessage->Read( &inputs.left );
-    netMessage->Read( &inputs.down );
-    netMessage->Read( &inputs.right );
-    netMessage->Read( &inputs.fire );
-    uint8 playerID = netMessage->m_senderIdx;
-    GameState_Playing::GetDefault()->Process_SendInputs( playerID, inputs );
+    BitPacker bits( *netMessage );
+    uint32 sequence;
+    uint countMinusOne;
+    uint32 buttons;
+    uint durationMS;
+    bits.ReadBits( &sequence, 16 );
+    bits.ReadUint( &countMinusOne, INPUT_REDUNDANCY - 1 );
+    bits.ReadBits( &buttons, INPUT_BUTTON_COUNT );
+    bits.ReadUint( &durationMS, INPUT_MAX_DURATION_MS );
+
+    // newest first
+    ClientInputs inputs[INPUT_REDUNDANCY];
+    uint count = countMinusOne + 1;
+    for( uint inputIdx = 0; inputIdx < count; ++inputIdx )
+    {
+        if( inputIdx != 0 )
+        {
+            bool changed = false;
+            bits.ReadBool( &changed );
+            if( changed )
+                bits.ReadBits( &buttons, INPUT_BUTTON_COUNT );
+            bits.ReadBool( &changed );
+            if( changed )
+                bits.ReadUint( &durationMS, INPUT_MAX_DURATION_MS );
+        }
+        inputs[inputIdx].SetButtonBits( buttons );
+        inputs[inputIdx].m_durationMS = (uint8) durationMS;
+        inputs[inputIdx].m_sequence = (uint16) ( sequence - inputIdx );
+    }
+    bits.FinishRead();
+    if( bits.HasFailed() )
+        return false;
+
+    ConnectionIdx playerID = netMessage->m_senderIdx;
+    GameState_Playing* playing = GameState_Playing::GetDefault();
+    for( int inputIdx = (int) count - 1; inputIdx >= 0; --inputIdx )
+        playing->Process_SendInputs( playerID, inputs[inputIdx] );
     return true;
 }
 
@@ -190,7 +307,7 @@ NET_MESSAGE_STATIC_REGSITER_AUTO(
 // EnterGame
 NetMessage* Compose_EnterGame()
 {
-    NetMessage* msg = new NetMessage( "enter_game" );
+    NetMessage* msg = new NetMessage( enter_game_handle );
     return msg;
 }
 
@@ -198,7 +315,7 @@ NET_MESSAGE_STATIC_REGSITER_AUTO(
     enter_game,
     eNetMessageFlag::RELIABLE_IN_ORDER )
 {
-    uint8 playerID = netMessage->m_senderIdx;
+    ConnectionIdx playerID = netMessage->m_senderIdx;
 
     GameState_Playing::GetDefault()->Process_EnterGame( playerID );
     return true;
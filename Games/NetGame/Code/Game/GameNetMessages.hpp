@@ -6,6 +6,7 @@
 class NetMessage;
 class NetCube;
 class ClientInputs;
+struct SnapshotDeltaEntry;
 
 namespace GameNetMessages
 {
@@ -22,10 +23,32 @@ NetMessage* Compose_UnreliableTest( uint currentCount, uint totalCount );
 NetMessage* Compose_ReliableTest( uint currentCount, uint totalCount );
 NetMessage* Compose_SequenceTest( uint currentCount, uint totalCount );
 
-NetMessage* Compose_CreateCube( NetCube* cube );
-NetMessage* Compose_DestroyCube( uint16 netID );
-NetMessage* Compose_UpdateCube( NetCube* cube );
-NetMessage* Compose_SendInputs( const ClientInputs& inputs );
+// one chunk of the delta from baselineID to snapshotID
+// hostTimeMS is the host's net clock at capture, for interpolation
+// playerNetID and lastProcessedInput are for the receiver's prediction
+// hasDeferred if the byte budget left some changed cubes out
+NetMessage* Compose_Snapshot( uint16 snapshotID,
+                              uint16 baselineID,
+                              uint hostTimeMS,
+                              uint16 playerNetID,
+                              uint16 lastProcessedInput,
+                              bool hasDeferred,
+                              uint8 chunkIdx,
+                              uint8 chunkCount,
+                              const SnapshotDeltaEntry* entries,
+                              uint16 entryCount );
+// one chunk of a full snapshot, reliable, for a player that just entered
+NetMessage* Compose_JoinSnapshot( uint16 snapshotID,
+                                  uint hostTimeMS,
+                                  uint16 playerNetID,
+                                  uint16 lastProcessedInput,
+                                  uint8 chunkIdx,
+                                  uint8 chunkCount,
+                                  const SnapshotDeltaEntry* entries,
+                                  uint16 entryCount );
+NetMessage* Compose_SnapshotAck( uint16 snapshotID );
+// inputs are consecutive sequences, oldest first, at most INPUT_REDUNDANCY
+NetMessage* Compose_SendInputs( const ClientInputs* inputs, uint count );
 
 NetMessage* Compose_EnterGame();
 
@@ -44,6 +44,8 @@
 #include "Engine/ShapeGrammar/ShapeRulesetLoader.hpp"
 #include "Engine/Thread/ThreadSafeQueue.hpp"
 #include "Engine/Log/Logger.hpp"
+#include "Engine/Time/Timer.hpp"
+#include "Engine/Time/Clock.hpp"
 
 #include "Game/NetCube.hpp"
 #include "Engine/Net/NetSession.hpp"
@@ -77,6 +79,7 @@ GameState_Playing::GameState_Playing()
 GameState_Playing::~GameState_Playing()
 {
     //delete g_mainCamera;
+    delete m_snapshotTimer;
     s_default = nullptr;
 }
 
@@ -104,13 +107,16 @@ void GameState_Playing::HostUpdate()
     RemoveDisconnectedPlayers();
     CheckForVictoryReset();
     UpdatePlayerInputs();
-    SendCubeUpdatesForAllClients();
     UpdateBullets();
+    SendJoinChunks();
+    SendSnapshotsToClients();
 }
 
 void GameState_Playing::ClientUpdate()
 {
     SendInputsToHost();
+    UpdatePredictedCube();
+    UpdateInterpolatedCubes();
 }
 
 void GameState_Playing::Render() const
@@ -123,6 +129,15 @@ void GameState_Playing::OnEnter()
     GameState::OnEnter();
 
     m_session = NetSession::GetDefault();
+    m_snapshotReceiver.Reset();
+    m_prediction.Reset();
+    m_interpolation.ResetStats();
+    m_hasJoined = false;
+    if( m_snapshotTimer == nullptr )
+    {
+        m_snapshotTimer =
+            new Timer( Clock::GetRealTimeClock(), 1.f / SNAPSHOT_RATE );
+    }
 
     g_input->LockCursor( true );
     g_input->ClipCursor( true );
@@ -159,64 +174,306 @@ void GameState_Playing::ProcessInput()
 }
 
 
-void GameState_Playing::Process_EnterGame( uint8 playerID )
+void GameState_Playing::Process_EnterGame( ConnectionIdx playerID )
+{
+    CreatePlayerCube( playerID );
+    // the host draws the real cubes
+    if( playerID != m_session->GetMyConnectionIdx() )
+        StartJoin( m_players[playerID] );
+}
+
+void GameState_Playing::CreatePlayerCube( ConnectionIdx playerID )
+{
+    Rgba color = Random::Default()->ColorWheel();
+    uint16 netID = NetCube::GetNextFreeNetID();
+    NetCube* cube = new NetCube(
+        Vec3::ZEROS, Vec3::ZEROS, Vec3::ONES, color, netID );
+    cube->m_factionID = playerID;
+    Player* player = new Player();
+    player->m_id = playerID;
+    player->m_cube = cube;
+    m_players[playerID] = player;
+}
+
+void GameState_Playing::StartJoin( Player* player )
 {
-    // tell new player to create all cubes
-    map<uint16, NetCube*> allCubes = NetCube::GetAllCubes();
-    for( auto& pair : allCubes )
+    // the join snapshot is not in the player's history, it is kept apart
+    player->ClearJoin();
+    m_currentSnapshot.Capture( PopNextSnapshotID() );
+    m_interestGrid.Build( m_currentSnapshot );
+    player->m_joinSnapshot = GetRelevantSnapshot( player, nullptr );
+    player->m_joinSnapshot.BuildDelta( nullptr, player->m_joinEntries );
+    if( !SplitDeltaIntoChunks( player->m_joinEntries, player->m_joinChunkEnds ) )
     {
-        SendCreateCube( playerID, pair.second );
+        // regular snapshots fall back to full ones, which will not fit either
+        LOG_WARNING_TAG( "Net", "Join snapshot too large for player %u", player->m_id );
+        player->ClearJoin();
+        return;
     }
-    CreatePlayerCube( playerID );
+    player->m_joinHostTimeMS = GetHostTimeMS();
+    player->m_joinStartTime = Clock::GetRealTimeClock()->GetTimeSinceStartup();
 }
 
-void GameState_Playing::SendCreateCube( uint8 playerID, NetCube* cube )
+void GameState_Playing::SendJoinChunks()
 {
-    if( playerID == 0 )
+    for( auto& pair : m_players )
+    {
+        Player* player = pair.second;
+        if( !player->IsJoining() )
+            continue;
+
+        uint8 chunkCount = (uint8) player->m_joinChunkEnds.size();
+        for( uint sentCount = 0;
+             sentCount < JOIN_CHUNKS_PER_FRAME && !player->HasSentJoin();
+             ++sentCount )
+        {
+            size_t chunkIdx = player->m_joinChunksSent;
+            size_t chunkStart = chunkIdx == 0 ? 0 : player->m_joinChunkEnds[chunkIdx - 1];
+            size_t entryCount = player->m_joinChunkEnds[chunkIdx] - chunkStart;
+            const SnapshotDeltaEntry* entries = entryCount == 0 ?
+                nullptr : &player->m_joinEntries[chunkStart];
+            m_session->SendToConnection( player->m_id, GameNetMessages::Compose_JoinSnapshot(
+                player->m_joinSnapshot.m_id, player->m_joinHostTimeMS,
+                player->m_cube->GetNetID(), player->m_lastProcessedInput,
+                (uint8) chunkIdx, chunkCount, entries, (uint16) entryCount ) );
+            ++player->m_joinChunksSent;
+        }
+    }
+}
+
+void GameState_Playing::RecordJoin( Player* player )
+{
+    JoinRecord record;
+    record.m_playerID = player->m_id;
+    record.m_cubeCount = player->m_joinSnapshot.m_cubes.size();
+    record.m_chunkCount = player->m_joinChunkEnds.size();
+    size_t bitCount = 0;
+    for( const SnapshotDeltaEntry& entry : player->m_joinEntries )
+        bitCount += entry.GetWriteBitCount();
+    record.m_byteCount = ( bitCount + 7 ) / 8;
+    record.m_seconds = (float) ( Clock::GetRealTimeClock()->GetTimeSinceStartup()
+                                 - player->m_joinStartTime );
+
+    if( m_joinRecords.size() == JOIN_RECORD_COUNT )
+        m_joinRecords.erase( m_joinRecords.begin() );
+    m_joinRecords.push_back( record );
+    LOG_INFO_TAG( "Net", "Player %u joined, %u cubes in %u chunks (%u bytes), %.1fms",
+                  record.m_playerID, (uint) record.m_cubeCount, (uint) record.m_chunkCount,
+                  (uint) record.m_byteCount, record.m_seconds * 1000.f );
+}
+
+string GameState_Playing::GetJoinStatsString() const
+{
+    if( m_joinRecords.empty() )
+        return "no joins yet";
+
+    string str = "player  cubes  chunks  bytes  ms  ms per 100 cubes";
+    for( const JoinRecord& record : m_joinRecords )
+    {
+        float msPerHundred = record.m_cubeCount == 0 ? 0.f :
+            record.m_seconds * 1000.f * 100.f / (float) record.m_cubeCount;
+        str += Stringf( "\n%u  %u  %u  %u  %.1f  %.2f",
+                        record.m_playerID, (uint) record.m_cubeCount,
+                        (uint) record.m_chunkCount, (uint) record.m_byteCount,
+                        record.m_seconds * 1000.f, msPerHundred );
+    }
+    return str;
+}
+
+uint GameState_Playing::SpawnCubes( uint count )
+{
+    uint spawnedCount = 0;
+    for( ; spawnedCount < count; ++spawnedCount )
+    {
+        uint16 netID = NetCube::GetNextFreeNetID();
+        if( netID == INVALID_NET_ID )
+            break;
+        Vec3 position( Random::Default()->FloatInRange( -50.f, 50.f ),
+                       Random::Default()->FloatInRange( -50.f, 50.f ), 0.f );
+        new NetCube( position, Vec3::ZEROS, Vec3::ONES,
+                     Random::Default()->ColorWheel(), netID );
+    }
+    return spawnedCount;
+}
+
+void GameState_Playing::SendSnapshotsToClients()
+{
+    if( m_snapshotTimer->PopAllLaps() == 0 )
         return;
-    m_session->SendToConnection(
-        playerID, GameNetMessages::Compose_CreateCube( cube ) );
+
+    uint16 snapshotID = PopNextSnapshotID();
+    m_currentSnapshot.Capture( snapshotID );
+    m_interestGrid.Build( m_currentSnapshot );
+    uint hostTimeMS = GetHostTimeMS();
+
+    for( auto& pair : m_players )
+    {
+        ConnectionIdx playerID = pair.first;
+        Player* player = pair.second;
+        if( playerID == m_session->GetMyConnectionIdx() )
+            continue;
+
+        // deltas against the join snapshot wait for all of it to go out, the
+        // player drops them until it has the whole thing anyway
+        if( player->IsJoining() && !player->HasSentJoin() )
+            continue;
+
+        const WorldSnapshot* baseline = GetSnapshotBaseline( player );
+        const WorldSnapshot& relevant = GetRelevantSnapshot( player, baseline );
+        player->m_relevantCubeCount = relevant.m_cubes.size();
+        SendSnapshotDelta( player, relevant, baseline, hostTimeMS );
+    }
 }
 
-void GameState_Playing::SendDestroyCube( uint16 netID )
+void GameState_Playing::SendSnapshotDelta( Player* player,
+                                           const WorldSnapshot& snapshot,
+                                           const WorldSnapshot* baseline,
+                                           uint hostTimeMS )
 {
-    m_session->SendToAllButMe( GameNetMessages::Compose_DestroyCube( netID ) );
+    ConnectionIdx playerID = player->m_id;
+    snapshot.BuildDelta( baseline, m_deltaEntries );
+    uint16 baselineID = baseline ? baseline->m_id : INVALID_SNAPSHOT_ID;
+
+    // without a baseline the client kills every cube left out, so a full
+    // snapshot goes out whole
+    NetCube* playerCube = player->m_cube;
+    size_t changedCount = m_deltaEntries.size();
+    player->m_priority.Prioritize(
+        m_deltaEntries, playerCube->GetNetID(),
+        playerCube->GetTransform().GetLocalPosition(),
+        1.f / SNAPSHOT_RATE, baseline ? m_snapshotByteBudget : 0 );
+    bool hasDeferred = m_deltaEntries.size() < changedCount;
+
+    // the baseline plus what made it in, what the player will rebuild
+    WorldSnapshot& sent = player->m_sentSnapshots.GetSlot( snapshot.m_id );
+    if( baseline )
+        sent.m_cubes = baseline->m_cubes;
+    else
+        sent.m_cubes.clear();
+    sent.m_id = snapshot.m_id;
+    for( const SnapshotDeltaEntry& entry : m_deltaEntries )
+    {
+        if( entry.m_cube == nullptr )
+            sent.Remove( entry.m_netID );
+        else
+            sent.FindOrAdd( entry.m_netID ) = *entry.m_cube;
+    }
+
+    // an empty delta still goes out so the client can ack it
+    if( !SplitDeltaIntoChunks( m_deltaEntries, m_chunkEnds ) )
+    {
+        LOG_WARNING_TAG( "Net", "Snapshot %u too large for player %u",
+                         snapshot.m_id, playerID );
+        return;
+    }
+    size_t chunkCount = m_chunkEnds.size();
+
+    size_t chunkStart = 0;
+    for( size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx )
+    {
+        size_t entryCount = m_chunkEnds[chunkIdx] - chunkStart;
+        const SnapshotDeltaEntry* entries = entryCount == 0 ?
+            nullptr : &m_deltaEntries[chunkStart];
+        m_session->SendToConnection( playerID, GameNetMessages::Compose_Snapshot(
+            snapshot.m_id, baselineID, hostTimeMS, player->m_cube->GetNetID(),
+            player->m_lastProcessedInput, hasDeferred, (uint8) chunkIdx,
+            (uint8) chunkCount, entries, (uint16) entryCount ) );
+        chunkStart = m_chunkEnds[chunkIdx];
+    }
 }
 
-void GameState_Playing::SendCreateCubeToAll( NetCube* cube )
+const WorldSnapshot* GameState_Playing::GetSnapshotBaseline( Player* player )
 {
-    m_session->SendToAllButMe(
-        GameNetMessages::Compose_CreateCube( cube ) );
+    // it may be out of the history by the time the player acks it
+    if( player->m_joinSnapshot.m_id != INVALID_SNAPSHOT_ID )
+        return &player->m_joinSnapshot;
+    // falls back to a full snapshot if the ack is too old
+    return player->m_sentSnapshots.Get( player->m_ackedSnapshotID );
 }
 
-void GameState_Playing::CreatePlayerCube( uint8 playerID )
+string GameState_Playing::GetPriorityStatsString()
 {
-    Rgba color = Random::Default()->ColorWheel();
-    uint16 netID = NetCube::GetNextFreeNetID();
-    NetCube* cube = new NetCube(
-        Vec3::ZEROS, Vec3::ZEROS, Vec3::ONES, color, netID );
-    cube->m_factionID = playerID;
-    Player* player = new Player();
-    player->m_id = playerID;
-    player->m_cube = cube;
-    m_players[playerID] = player;
+    string str = Stringf( "budget %u bytes per player per snapshot",
+                          (uint) m_snapshotByteBudget );
+    for( auto& pair : m_players )
+    {
+        if( pair.first == m_session->GetMyConnectionIdx() )
+            continue;
+        str += Stringf( "\nplayer %u  ", pair.first )
+            + pair.second->m_priority.GetStatsString();
+    }
+    return str;
+}
+
+void GameState_Playing::ResetPriorityStats()
+{
+    for( auto& pair : m_players )
+        pair.second->m_priority.ResetStats();
+}
+
+const WorldSnapshot& GameState_Playing::GetRelevantSnapshot( Player* player,
+                                                             const WorldSnapshot* previous )
+{
+    if( m_interestRadius <= 0.f )
+        return m_currentSnapshot;
 
-    SendCreateCubeToAll( cube );
+    // cubes leaving the set go out as removals, entering ones as new cubes
+    m_interestGrid.Gather( player->m_cube->GetTransform().GetLocalPosition(),
+                           m_interestRadius, m_interestRadius + INTEREST_HYSTERESIS,
+                           previous, m_interestSnapshot );
+    return m_interestSnapshot;
 }
 
-void GameState_Playing::SendCubeUpdatesForAllClients()
+string GameState_Playing::GetInterestStatsString()
 {
+    string str = m_interestRadius <= 0.f ? string( "radius off" ) :
+        Stringf( "radius %.1f  leave %.1f", m_interestRadius,
+                 m_interestRadius + INTEREST_HYSTERESIS );
+    str += Stringf( "  world %u cubes", (uint) m_currentSnapshot.m_cubes.size() );
     for( auto& pair : m_players )
     {
-        NetCube* cube = pair.second->m_cube;
-        if( cube )
-            m_session->SendToAllButMe(
-                GameNetMessages::Compose_UpdateCube( cube ) );
+        if( pair.first == m_session->GetMyConnectionIdx() )
+            continue;
+        str += Stringf( "\nplayer %u  relevant %u", pair.first,
+                        (uint) pair.second->m_relevantCubeCount );
     }
+    return str;
+}
+
+uint16 GameState_Playing::PopNextSnapshotID()
+{
+    uint16 snapshotID = m_nextSnapshotID;
+    ++m_nextSnapshotID;
+    if( m_nextSnapshotID == INVALID_SNAPSHOT_ID )
+        m_nextSnapshotID = 0;
+    return snapshotID;
 }
 
+uint GameState_Playing::GetHostTimeMS()
+{
+    return (uint) ( m_session->GetNetClock()->GetTimeSinceStartupF() * 1000.f );
+}
+
+void GameState_Playing::Process_SnapshotAck( ConnectionIdx playerID, uint16 snapshotID )
+{
+    Player* player = GetPlayer( playerID );
+    if( player == nullptr )
+        return;
+
+    bool wasJoining = player->IsJoining();
+    if( player->m_ackedSnapshotID == INVALID_SNAPSHOT_ID
+        || CyclicGreater( snapshotID, player->m_ackedSnapshotID ) )
+        player->m_ackedSnapshotID = snapshotID;
 
-void GameState_Playing::CreateBulletForPlayer( uint8 playerID )
+    // the join snapshot or anything after it means the player has every cube
+    if( wasJoining && !player->IsJoining() )
+        RecordJoin( player );
+    if( player->m_joinSnapshot.m_id != INVALID_SNAPSHOT_ID
+        && player->m_ackedSnapshotID != player->m_joinSnapshot.m_id )
+        player->ClearJoin();
+}
+
+void GameState_Playing::CreateBulletForPlayer( ConnectionIdx playerID )
 {
     Player* player = GetPlayer( playerID );
     NetCube* playerCube = GetPlayerCube( playerID );
@@ -233,18 +490,16 @@ void GameState_Playing::CreateBulletForPlayer( uint8 playerID )
     bullet->m_velocity = playerCube->m_direction;
     bullet->m_factionID = playerCube->m_factionID;
     m_bullets.push_back( bullet );
-
-    SendCreateCubeToAll( bullet );
 }
 
 void GameState_Playing::RemoveDisconnectedPlayers()
 {
     for( auto it = m_players.cbegin(); it != m_players.cend(); )
     {
-        uint8 playerID  = it->first;
+        ConnectionIdx playerID  = it->first;
         if( m_session->GetConnection( playerID ) == nullptr )
         {
-            SendDestroyCube( playerID );
+            // player cube dies with the player and drops out of the snapshot
             delete it->second;
             it = m_players.erase( it );
         }
@@ -296,7 +551,7 @@ void GameState_Playing::CheckForVictoryReset()
     }
 }
 
-NetCube* GameState_Playing::GetPlayerCube( uint8 playerID )
+NetCube* GameState_Playing::GetPlayerCube( ConnectionIdx playerID )
 {
     Player* player = GetPlayer( playerID );
     if( player )
@@ -304,7 +559,7 @@ NetCube* GameState_Playing::GetPlayerCube( uint8 playerID )
     return nullptr;
 }
 
-Player* GameState_Playing::GetPlayer( uint8 playerID )
+Player* GameState_Playing::GetPlayer( ConnectionIdx playerID )
 {
     if( ContainerUtils::ContainsKey( m_players, playerID ) )
         return m_players[playerID];
@@ -312,39 +567,40 @@ Player* GameState_Playing::GetPlayer( uint8 playerID )
 }
 
 void GameState_Playing::Process_SendInputs(
-    uint8 playerID, const ClientInputs& inputs )
+    ConnectionIdx playerID, const ClientInputs& inputs )
 {
     Player* player = GetPlayer( playerID );
-    if( player )
-        *player->m_inputs = inputs;
+    if( player == nullptr )
+        return;
+    player->QueueInput( inputs );
 }
 
 void GameState_Playing::UpdatePlayerInputs()
 {
     for( auto& pair : m_players )
     {
-        uint8 playerID = pair.first;
+        ConnectionIdx playerID = pair.first;
         Player* player = pair.second;
-        // movement
         NetCube* playerCube = player->m_cube;
-        ClientInputs& input = *player->m_inputs;
         Transform& t = playerCube->GetTransform();
-        Vec3 translate =
-            input.up * Vec3::UP
-            + input.left * Vec3::LEFT
-            + input.down * Vec3::DOWN
-            + input.right * Vec3::RIGHT;
-        float length = translate.NormalizeAndGetLength();
-        if( length > 0.00001 )
-            playerCube->m_direction = translate;
-        translate = translate
-            * g_gameClock->GetDeltaSecondsF()
-            * PLAYER_MOVE_SPEED;
-        t.TranslateLocal( translate );
-        playerCube->SetTargetPosition( t.GetLocalPosition() );
+        Vec3 position = t.GetLocalPosition();
+
+        // keeps the last input's fire when nothing arrived this frame,
+        // a fire pressed between two host frames still shoots
+        ClientInputs& input = *player->m_inputs;
+        bool fire = input.fire;
+        bool hasPopped = false;
+        while( player->PopInput( input ) )
+        {
+            Player::SimulateMovement( input, position, playerCube->m_direction );
+            fire = ( hasPopped && fire ) || input.fire;
+            hasPopped = true;
+        }
+        t.SetLocalPosition( position );
+        playerCube->SetTargetPosition( position );
 
         // shooting
-        if( input.fire )
+        if( fire )
         {
             CreateBulletForPlayer( playerID );
         }
@@ -360,7 +616,6 @@ void GameState_Playing::UpdateBullets()
         bullet->m_timeToLive -= g_gameClock->GetDeltaSecondsF();
         if( bullet->m_timeToLive <= 0.f )
         {
-            SendDestroyCube( bullet->m_netID );
             bullet->SetShouldDie( true );
             ContainerUtils::EraseAtIndexFast( m_bullets, i );
             continue;
@@ -381,7 +636,6 @@ void GameState_Playing::UpdateBullets()
                 Rgba blend = Lerp( playerColor, bulletColor,
                                    BULLET_COLOR_BLEND_WEIGHT );
                 player->m_cube->SetTargetColor( blend );
-                SendDestroyCube( bullet->m_netID );
                 bullet->SetShouldDie( true );
                 ContainerUtils::EraseAtIndexFast( m_bullets, i );
                 break;
@@ -394,40 +648,152 @@ void GameState_Playing::UpdateBullets()
 void GameState_Playing::SendInputsToHost()
 {
     ClientInputs inputs;
-    inputs.up = g_input->IsKeyPressed( 'W' );
-    inputs.left = g_input->IsKeyPressed( 'A' );
-    inputs.down = g_input->IsKeyPressed( 'S' );
-    inputs.right = g_input->IsKeyPressed( 'D' );
-    inputs.fire = g_input->IsKeyPressed( InputSystem::KEYBOARD_SPACE );
-    m_session->SendToHost( GameNetMessages::Compose_SendInputs( inputs ) );
+    if( g_input->WindowHasFocus() )
+    {
+        inputs.up = g_input->IsKeyPressed( 'W' );
+        inputs.left = g_input->IsKeyPressed( 'A' );
+        inputs.down = g_input->IsKeyPressed( 'S' );
+        inputs.right = g_input->IsKeyPressed( 'D' );
+        inputs.fire = g_input->IsKeyPressed( InputSystem::KEYBOARD_SPACE );
+    }
+    m_prediction.AddInput( inputs, g_gameClock->GetDeltaSecondsF() );
+
+    // repeats cover lost packets without reliable traffic
+    ClientInputs unacked[INPUT_REDUNDANCY];
+    uint count = m_prediction.GetUnackedInputs( unacked, INPUT_REDUNDANCY );
+    m_session->SendToHost( GameNetMessages::Compose_SendInputs( unacked, count ) );
 }
 
-void GameState_Playing::Process_CreateCube( const Vec3& position, const Vec3& velocity, const Vec3& scale, const Rgba& color, uint16 netID )
+void GameState_Playing::UpdatePredictedCube()
 {
-    NetCube* cube = new NetCube( position, Vec3::ZEROS, scale, color, netID );
-    cube->m_velocity = velocity;
+    // the host moves its own cube for real
+    if( IsHost() || !m_prediction.IsPredicting() )
+        return;
+
+    NetCube* cube = NetCube::GetNetCube( m_prediction.GetNetID() );
+    if( cube == nullptr )
+        return;
+
+    // created by a snapshot before we knew it was ours
+    if( cube->m_isInterpolated )
+    {
+        cube->m_isInterpolated = false;
+        cube->m_interpolation.Clear();
+    }
+
+    m_prediction.Update( g_gameClock->GetDeltaSecondsF() );
+    Vec3 position = m_prediction.GetRenderPosition();
+    cube->GetTransform().SetLocalPosition( position );
+    cube->SetTargetPosition( position );
+    cube->m_direction = m_prediction.GetDirection();
+}
+
+void GameState_Playing::UpdateInterpolatedCubes()
+{
+    if( IsHost() )
+        return;
+
+    float renderTime =
+        m_session->GetNetClock()->GetTimeSinceStartupF() - m_interpolation.m_delay;
+    for( auto& pair : NetCube::GetAllCubes() )
+    {
+        NetCube* cube = pair.second;
+        if( !cube->m_isInterpolated || cube->ShouldDie() )
+            continue;
+
+        InterpolationSample sample;
+        eInterpolationResult result = cube->m_interpolation.Sample(
+            renderTime, m_interpolation.m_extrapolationLimit, sample );
+        if( result == eInterpolationResult::EMPTY )
+            continue;
+
+        m_interpolation.Record(
+            result, cube->m_interpolation.GetNewest().m_time - renderTime );
+        cube->SetTargetPosition( sample.m_position );
+        cube->SetTargetScale( sample.m_scale );
+        cube->SetTargetColor( sample.m_color );
+    }
 }
 
 void GameState_Playing::SendEnterGame()
 {
+    m_enterGameTime = Clock::GetRealTimeClock()->GetTimeSinceStartup();
     m_session->SendToHost( GameNetMessages::Compose_EnterGame() );
 }
 
-void GameState_Playing::Process_DestroyCube( uint16 netID )
+void GameState_Playing::Process_Snapshot( uint16 snapshotID,
+                                          uint16 baselineID,
+                                          uint hostTimeMS,
+                                          uint16 playerNetID,
+                                          uint16 lastProcessedInput,
+                                          bool hasDeferred,
+                                          uint8 chunkIdx,
+                                          uint8 chunkCount,
+                                          uint16 entryCount,
+                                          BitPacker& bits )
 {
-    NetCube::MarkForDestroy( netID );
+    if( !m_snapshotReceiver.ReadChunk( snapshotID, baselineID, hostTimeMS, hasDeferred,
+                                       chunkIdx, chunkCount, entryCount, bits ) )
+        return;
+
+    m_session->SendToHost( GameNetMessages::Compose_SnapshotAck( snapshotID ) );
+    const WorldSnapshot& snapshot = *m_snapshotReceiver.GetLatest();
+    ApplySnapshot( snapshot );
+
+    if( !m_hasJoined )
+    {
+        m_hasJoined = true;
+        double seconds = Clock::GetRealTimeClock()->GetTimeSinceStartup() - m_enterGameTime;
+        LOG_INFO_TAG( "Net", "Joined with %u cubes in %.1fms",
+                      (uint) snapshot.m_cubes.size(), seconds * 1000.0 );
+    }
+
+    const CubeSnapshot* playerCube = snapshot.Find( playerNetID );
+    if( playerCube && !IsHost() )
+        m_prediction.Reconcile( playerNetID, lastProcessedInput, playerCube->m_position );
 }
 
-void GameState_Playing::Process_UpdateCube(
-    const Vec3& position,
-    const Rgba& color,
-    uint16 netID )
+void GameState_Playing::ApplySnapshot( const WorldSnapshot& snapshot )
 {
-    NetCube* cube = NetCube::GetNetCube( netID );
-    if( !cube )
-        return;
-    cube->SetTargetPosition( position );
-    cube->SetTargetColor( color );
+    for( const CubeSnapshot& state : snapshot.m_cubes )
+    {
+        NetCube* cube = NetCube::GetNetCube( state.m_netID );
+        if( cube == nullptr )
+        {
+            cube = new NetCube( state.m_position, Vec3::ZEROS, state.m_scale,
+                                state.m_color, state.m_netID );
+            cube->m_velocity = state.m_velocity;
+            cube->m_isInterpolated = state.m_netID != m_prediction.GetNetID();
+        }
+        else if( cube->ShouldDie() )
+        {
+            // a dying cube with a reused netID is recreated by a later snapshot
+            continue;
+        }
+        else if( !cube->m_isInterpolated )
+        {
+            // our own cube follows the prediction, see UpdatePredictedCube
+            cube->SetTargetScale( state.m_scale );
+            cube->SetTargetColor( state.m_color );
+            cube->m_velocity = state.m_velocity;
+            continue;
+        }
+
+        // snapshot positions already include bullet movement, a cube the
+        // budget held back keeps its old time and Push skips it
+        InterpolationSample sample;
+        sample.m_time = (float) state.m_hostTimeMS / 1000.f;
+        sample.m_position = state.m_position;
+        sample.m_scale = state.m_scale;
+        sample.m_color = state.m_color;
+        cube->m_interpolation.Push( sample );
+    }
+
+    for( auto& pair : NetCube::GetAllCubes() )
+    {
+        if( snapshot.Find( pair.first ) == nullptr )
+            pair.second->SetShouldDie( true );
+    }
 }
 
 bool GameState_Playing::IsHost()
@@ -453,8 +819,6 @@ void GameState_Playing::ProcessMovementInput()
 
     float ds = g_gameClock->GetDeltaSecondsF();
 
-    SendInputsToHost();
-
     float deltaCamYaw = 0;
     float deltaCamPitch = 0;
 
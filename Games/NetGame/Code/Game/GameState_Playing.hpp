@@ -5,7 +5,12 @@
 #include "Engine/Core/Rgba.hpp"
 #include "Game/GameState.hpp"
 #include "Game/GameplayDefines.hpp"
+#include "Engine/Net/NetCommonH.hpp"
 #include "Game/ClientInputs.hpp"
+#include "Game/Snapshot.hpp"
+#include "Game/ClientPrediction.hpp"
+#include "Game/InterpolationBuffer.hpp"
+#include "Game/InterestGrid.hpp"
 
 class Menu;
 class ShaderProgram;
@@ -24,6 +29,19 @@ class Swarmer;
 class NetCube;
 class NetSession;
 class Player;
+class Timer;
+class BitPacker;
+
+// One player's join as the host saw it, from enter_game to the ack of the
+// join snapshot
+struct JoinRecord
+{
+    ConnectionIdx m_playerID = 0;
+    size_t m_cubeCount = 0;
+    size_t m_chunkCount = 0;
+    size_t m_byteCount = 0; // entries only
+    float m_seconds = 0.f;
+};
 
 class GameState_Playing : public GameState
 {
@@ -40,35 +58,81 @@ public:
     void ProcessInput() override;
 
     // Host
-    void Process_EnterGame( uint8 playerID );
-    void SendCreateCube( uint8 playerID, NetCube* cube ); // skips if receiver is host
-    void SendDestroyCube( uint16 netID );  // skips if receiver is host
-    void SendCreateCubeToAll( NetCube* cube ); // skips if receiver is host
-    void CreatePlayerCube( uint8 playerID );
-    void SendCubeUpdatesForAllClients();
-    void CreateBulletForPlayer( uint8 playerID );
+    void Process_EnterGame( ConnectionIdx playerID );
+    void CreatePlayerCube( ConnectionIdx playerID );
+    // captures the join snapshot, SendJoinChunks streams it
+    void StartJoin( Player* player );
+    // up to JOIN_CHUNKS_PER_FRAME chunks per joining player
+    void SendJoinChunks();
+    void RecordJoin( Player* player );
+    string GetJoinStatsString() const;
+    // static cubes at random spots, for measuring joins, returns how many
+    uint SpawnCubes( uint count );
+    // captures a snapshot at SNAPSHOT_RATE and sends every client the delta
+    // of the cubes near it against the last snapshot it acked, skips the host
+    void SendSnapshotsToClients();
+    void SendSnapshotDelta( Player* player,
+                            const WorldSnapshot& snapshot,
+                            const WorldSnapshot* baseline,
+                            uint hostTimeMS );
+    // the join snapshot until the player acks past it, then the last ack
+    const WorldSnapshot* GetSnapshotBaseline( Player* player );
+    // the cubes of m_currentSnapshot near the player, previous is what it
+    // has now. Valid until the next call
+    const WorldSnapshot& GetRelevantSnapshot( Player* player, const WorldSnapshot* previous );
+    uint16 PopNextSnapshotID();
+    uint GetHostTimeMS();
+    void Process_SnapshotAck( ConnectionIdx playerID, uint16 snapshotID );
+    void CreateBulletForPlayer( ConnectionIdx playerID );
     void RemoveDisconnectedPlayers();
     void CheckForVictoryReset();
-    NetCube* GetPlayerCube( uint8 playerID );
-    Player* GetPlayer( uint8 playerID );
+    NetCube* GetPlayerCube( ConnectionIdx playerID );
+    Player* GetPlayer( ConnectionIdx playerID );
 
     // Host gameplay
-    void Process_SendInputs( uint8 playerID, const ClientInputs& inputs );
+    // queues the input, repeats of inputs already queued are dropped
+    void Process_SendInputs( ConnectionIdx playerID, const ClientInputs& inputs );
+    // simulates every queued input in sequence order, then shooting
     void UpdatePlayerInputs();
     void UpdateBullets();
 
     // Client
+    // samples this frame's input, predicts it and sends it along with
+    // the inputs the host has not acked yet
     void SendInputsToHost();
-    void Process_CreateCube( const Vec3& position,
-                             const Vec3& velocity,
-                             const Vec3& scale,
-                             const Rgba& color,
-                             uint16 netID );
+    // puts our cube where the prediction has it
+    void UpdatePredictedCube();
+    // places remote cubes at the net clock minus the interpolation delay
+    void UpdateInterpolatedCubes();
     void SendEnterGame();
-    void Process_DestroyCube(uint16 netID);
-    void Process_UpdateCube( const Vec3& position,
-                             const Rgba& color,
-                             uint16 netID );
+    // reads the entries of one snapshot chunk, acks and applies the
+    // snapshot once all its chunks are in
+    void Process_Snapshot( uint16 snapshotID,
+                           uint16 baselineID,
+                           uint hostTimeMS,
+                           uint16 playerNetID,
+                           uint16 lastProcessedInput,
+                           bool hasDeferred,
+                           uint8 chunkIdx,
+                           uint8 chunkCount,
+                           uint16 entryCount,
+                           BitPacker& bits );
+    // creates, updates and destroys cubes to match the snapshot
+    // states are buffered at their m_hostTimeMS, see UpdateInterpolatedCubes
+    void ApplySnapshot( const WorldSnapshot& snapshot );
+
+    InterpolationSettings& GetInterpolationSettings() { return m_interpolation; };
+
+    // bytes of entries per player per delta, 0 for no budget, snapshots
+    // without a baseline always go out whole
+    void SetSnapshotByteBudget( size_t byteCount ) { m_snapshotByteBudget = byteCount; }
+    size_t GetSnapshotByteBudget() const { return m_snapshotByteBudget; }
+    string GetPriorityStatsString();
+    void ResetPriorityStats();
+
+    // 0 sends every cube to every player
+    void SetInterestRadius( float radius ) { m_interestRadius = radius; }
+    string GetInterestStatsString();
 
     bool IsHost();
 
@@ -77,13 +141,40 @@ private:
     NetSession* m_session;
 
     // Host
-    map<uint8, Player*> m_players;
+    map<ConnectionIdx, Player*> m_players;
 
 //     map<uint8,NetCube*> m_playerCubes;
 //     map<uint8, ClientInputs> m_inputs;
 
     vector<NetCube*> m_bullets;
 
+    // Host snapshots, each player keeps what it was sent
+    WorldSnapshot m_currentSnapshot;
+    size_t m_snapshotByteBudget = SNAPSHOT_BYTE_BUDGET;
+    // Host interest
+    InterestGrid m_interestGrid; // over m_currentSnapshot
+    WorldSnapshot m_interestSnapshot;
+    float m_interestRadius = INTEREST_RADIUS;
+    uint16 m_nextSnapshotID = 0;
+    Timer* m_snapshotTimer = nullptr;
+    vector<SnapshotDeltaEntry> m_deltaEntries;
+    vector<size_t> m_chunkEnds;
+
+    // Host joins, oldest first
+    vector<JoinRecord> m_joinRecords;
+
+    // Client snapshots
+    SnapshotReceiver m_snapshotReceiver;
+    // real time enter_game went out, the first snapshot ends the join
+    double m_enterGameTime = 0.0;
+    bool m_hasJoined = false;
+
+    // Client prediction, off on the host
+    ClientPrediction m_prediction;
+
+    // Client interpolation of remote cubes, off on the host
+    InterpolationSettings m_interpolation;
+
     void MakeCamera();
     void ProcessMovementInput();
 
@@ -10,6 +10,56 @@
 #define BULLET_COLOR_BLEND_WEIGHT (0.2f) // higher value means bullet gets more weight
 #define VICTORY_COLOR_DEVIATION (30.f)
 
+// client prediction
+#define INPUT_MAX_DURATION_MS (100) // longer frames are cut short
+#define PREDICTION_HISTORY_SIZE (128) // unacked inputs kept, must cover the round trip
+#define PREDICTION_SNAP_DISTANCE (2.f) // corrections past this snap instead of blending
+#define PREDICTION_ERROR_DECAY (10.f) // per second, how fast small corrections blend out
+
+// input transmission
+#define INPUT_BUTTON_COUNT (5)
+#define INPUT_REDUNDANCY (8) // unacked inputs repeated in each send_inputs, covers 7 lost in a row
+#define INPUT_QUEUE_SIZE (64) // host side, inputs received but not simulated
+
+// net ids
+#define MAX_NET_ID_COUNT 1000
+#define INVALID_NET_ID ((uint16)(~0))
+
+// snapshots
+#define SNAPSHOT_RATE (20.f) // Hz
+#define SNAPSHOT_HISTORY_SIZE (64) // must cover the ack round trip at SNAPSHOT_RATE
+#define MAX_SNAPSHOT_CHUNKS (64)
+#define SNAPSHOT_CHUNK_PAYLOAD (1000) // bytes of delta entries per snapshot message
+#define INVALID_SNAPSHOT_ID ((uint16)(~0))
+
+// snapshot priority, each player gets the changes that matter most to it first
+#define SNAPSHOT_BYTE_BUDGET (1200) // entry bytes per player per snapshot, removals and the own cube go over
+#define PRIORITY_DISTANCE_FALLOFF (10.f) // priority halves this far from the player's cube
+#define PRIORITY_VELOCITY_WEIGHT (1.f) // extra priority per unit of velocity, bullets are 1
+
+// interest, players only get the cubes around their own
+#define INTEREST_RADIUS (40.f) // cubes this close enter a player's snapshots
+#define INTEREST_HYSTERESIS (5.f) // and leave once this much further out
+#define INTEREST_CELL_SIZE (16.f) // must divide the position range
+
+// join, a new player's first snapshot goes out as reliable chunks
+#define JOIN_CHUNKS_PER_FRAME (4) // host frames, keeps the reliable window open
+#define JOIN_RECORD_COUNT (16) // joins kept for join_stats
+
+// snapshot interpolation, remote cubes are drawn this far behind the net clock
+#define INTERPOLATION_BUFFER_SIZE (32) // states per cube
+#define INTERPOLATION_DELAY (0.1f) // seconds, two snapshots at SNAPSHOT_RATE
+#define EXTRAPOLATION_LIMIT (0.1f) // seconds past the newest state before the cube stops
+
+// snapshot quantization, values outside the range are clamped
+#define SNAPSHOT_POSITION_RANGE (512.f) // +-
+#define SNAPSHOT_POSITION_PRECISION (0.02f) // 16 bits per axis
+#define SNAPSHOT_SCALE_MAX (8.f)
+#define SNAPSHOT_SCALE_PRECISION (0.01f) // 10 bits per axis
+#define SNAPSHOT_SPEED_MAX (8.f)
+#define SNAPSHOT_SPEED_PRECISION (0.01f)
+#define SNAPSHOT_DIRECTION_BITS (10) // per octahedral component
+
 #define ADDITIONAL_COMMAND_LINE_ARGS ("")
 
 // runtime vars
@@ -0,0 +1,100 @@
+#include "Engine/Math/MathUtils.hpp"
+
+#include "Game/InterestGrid.hpp"
+#include "Game/Snapshot.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+
+constexpr int GRID_SIZE =
+    (int) ( 2.f * SNAPSHOT_POSITION_RANGE / INTEREST_CELL_SIZE );
+
+bool CubeSnapshotNetIDLess( const CubeSnapshot& a, const CubeSnapshot& b )
+{
+    return a.m_netID < b.m_netID;
+}
+
+}
+
+InterestGrid::InterestGrid()
+{
+    m_cellStarts.resize( GRID_SIZE * GRID_SIZE + 1 );
+}
+
+void InterestGrid::Build( const WorldSnapshot& world )
+{
+    m_world = &world;
+
+    // counting sort by cell, two passes over the cubes and one over the cells
+    for( uint& start : m_cellStarts )
+        start = 0;
+    m_cubeIdxs.resize( world.m_cubes.size() );
+
+    for( const CubeSnapshot& cube : world.m_cubes )
+    {
+        int cellIdx = GetCellCoord( cube.m_position.y ) * GRID_SIZE
+            + GetCellCoord( cube.m_position.x );
+        ++m_cellStarts[cellIdx + 1];
+    }
+    for( size_t cellIdx = 1; cellIdx < m_cellStarts.size(); ++cellIdx )
+        m_cellStarts[cellIdx] += m_cellStarts[cellIdx - 1];
+
+    // fills each cell from its start, shifting the starts one cell up,
+    // then shifts them back
+    for( uint cubeIdx = 0; cubeIdx < (uint) world.m_cubes.size(); ++cubeIdx )
+    {
+        const Vec3& position = world.m_cubes[cubeIdx].m_position;
+        int cellIdx = GetCellCoord( position.y ) * GRID_SIZE + GetCellCoord( position.x );
+        m_cubeIdxs[m_cellStarts[cellIdx]] = cubeIdx;
+        ++m_cellStarts[cellIdx];
+    }
+    for( size_t cellIdx = m_cellStarts.size() - 1; cellIdx > 0; --cellIdx )
+        m_cellStarts[cellIdx] = m_cellStarts[cellIdx - 1];
+    m_cellStarts[0] = 0;
+}
+
+void InterestGrid::Gather( const Vec3& center,
+                           float enterRadius,
+                           float leaveRadius,
+                           const WorldSnapshot* previous,
+                           WorldSnapshot& out_snapshot ) const
+{
+    out_snapshot.Clear( m_world->m_id );
+
+    float enterRadiusSquared = enterRadius * enterRadius;
+    float leaveRadiusSquared = leaveRadius * leaveRadius;
+    int minX = GetCellCoord( center.x - leaveRadius );
+    int maxX = GetCellCoord( center.x + leaveRadius );
+    int minY = GetCellCoord( center.y - leaveRadius );
+    int maxY = GetCellCoord( center.y + leaveRadius );
+    for( int y = minY; y <= maxY; ++y )
+    {
+        for( int x = minX; x <= maxX; ++x )
+        {
+            int cellIdx = y * GRID_SIZE + x;
+            for( uint idx = m_cellStarts[cellIdx]; idx < m_cellStarts[cellIdx + 1]; ++idx )
+            {
+                const CubeSnapshot& cube = m_world->m_cubes[m_cubeIdxs[idx]];
+                Vec3 offset = cube.m_position - center;
+                float distanceSquared = offset.x * offset.x + offset.y * offset.y;
+                if( distanceSquared > leaveRadiusSquared )
+                    continue;
+                if( distanceSquared > enterRadiusSquared
+                    && ( previous == nullptr || previous->Find( cube.m_netID ) == nullptr ) )
+                    continue;
+                out_snapshot.m_cubes.push_back( cube );
+            }
+        }
+    }
+    std::sort( out_snapshot.m_cubes.begin(), out_snapshot.m_cubes.end(),
+               CubeSnapshotNetIDLess );
+}
+
+int InterestGrid::GetCellCoord( float position ) const
+{
+    int coord = (int) floorf( ( position + SNAPSHOT_POSITION_RANGE ) / INTEREST_CELL_SIZE );
+    return ClampInt( coord, 0, GRID_SIZE - 1 );
+}
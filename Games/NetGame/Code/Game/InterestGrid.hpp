@@ -0,0 +1,39 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/GameplayDefines.hpp"
+
+class WorldSnapshot;
+
+// Uniform grid of INTEREST_CELL_SIZE cells over the XY plane, bucketing the
+// cubes of one WorldSnapshot so each player only looks at the cells near it
+// Rebuilt every snapshot, positions past SNAPSHOT_POSITION_RANGE go in the
+// edge cells
+class InterestGrid
+{
+public:
+    InterestGrid();
+
+    // world has to outlive the grid's use
+    void Build( const WorldSnapshot& world );
+
+    // the cubes within enterRadius of center, and the ones in previous that
+    // are still within leaveRadius so cubes on the edge do not flicker
+    // out_snapshot is sorted by netID and gets the world's id
+    void Gather( const Vec3& center,
+                 float enterRadius,
+                 float leaveRadius,
+                 const WorldSnapshot* previous,
+                 WorldSnapshot& out_snapshot ) const;
+
+private:
+    int GetCellCoord( float position ) const;
+
+public:
+
+    const WorldSnapshot* m_world = nullptr;
+    // cubes sorted by cell, a cell's cubes are m_cubeIdxs[m_cellStarts[cell]]
+    // up to the next cell's start
+    vector<uint> m_cellStarts;
+    vector<uint> m_cubeIdxs;
+};
@@ -0,0 +1,132 @@
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+
+#include "Game/InterpolationBuffer.hpp"
+
+//--------------------------------------------------------------------------------------
+// InterpolationSettings
+
+void InterpolationSettings::ResetStats()
+{
+    m_interpolatedCount = 0;
+    m_earlyCount = 0;
+    m_extrapolatedCount = 0;
+    m_starvedCount = 0;
+    m_minSlack = 0.f;
+    m_hasSlack = false;
+}
+
+void InterpolationSettings::Record( eInterpolationResult result, float slack )
+{
+    switch( result )
+    {
+    case eInterpolationResult::INTERPOLATED:
+        ++m_interpolatedCount;
+        break;
+    case eInterpolationResult::EARLY:
+        ++m_earlyCount;
+        break;
+    case eInterpolationResult::EXTRAPOLATED:
+        ++m_extrapolatedCount;
+        break;
+    case eInterpolationResult::STARVED:
+        ++m_starvedCount;
+        break;
+    default:
+        return;
+    }
+
+    if( !m_hasSlack || slack < m_minSlack )
+        m_minSlack = slack;
+    m_hasSlack = true;
+}
+
+string InterpolationSettings::GetStatsString() const
+{
+    size_t total = m_interpolatedCount + m_earlyCount
+        + m_extrapolatedCount + m_starvedCount;
+    float starvedPercent = total == 0 ? 0.f :
+        100.f * (float) ( m_extrapolatedCount + m_starvedCount ) / (float) total;
+    return Stringf(
+        "delay %.3fs  extrapolate %.3fs  samples %u  interpolated %u  early %u  "
+        "extrapolated %u  starved %u (%.1f%% past newest)  min slack %.3fs",
+        m_delay, m_extrapolationLimit, (uint) total,
+        (uint) m_interpolatedCount, (uint) m_earlyCount,
+        (uint) m_extrapolatedCount, (uint) m_starvedCount,
+        starvedPercent, m_minSlack );
+}
+
+//--------------------------------------------------------------------------------------
+// InterpolationBuffer
+
+void InterpolationBuffer::Push( const InterpolationSample& sample )
+{
+    if( m_count != 0 && sample.m_time <= GetNewest().m_time )
+        return;
+
+    m_samples[m_nextIdx] = sample;
+    m_nextIdx = ( m_nextIdx + 1 ) % INTERPOLATION_BUFFER_SIZE;
+    m_count = Min( m_count + 1, (size_t) INTERPOLATION_BUFFER_SIZE );
+}
+
+eInterpolationResult InterpolationBuffer::Sample( float renderTime,
+                                                  float extrapolationLimit,
+                                                  InterpolationSample& out_sample ) const
+{
+    if( m_count == 0 )
+        return eInterpolationResult::EMPTY;
+
+    const InterpolationSample& oldest = GetSample( 0 );
+    if( renderTime <= oldest.m_time )
+    {
+        out_sample = oldest;
+        return eInterpolationResult::EARLY;
+    }
+
+    const InterpolationSample& newest = GetNewest();
+    if( renderTime > newest.m_time )
+    {
+        out_sample = newest;
+        if( m_count == 1 )
+            return eInterpolationResult::STARVED;
+
+        // keep moving the way it was going for a little while
+        const InterpolationSample& previous = GetSample( m_count - 2 );
+        float extrapolateTime = Min( renderTime - newest.m_time, extrapolationLimit );
+        Vec3 velocity = ( newest.m_position - previous.m_position )
+            / ( newest.m_time - previous.m_time );
+        out_sample.m_position = newest.m_position + velocity * extrapolateTime;
+        out_sample.m_time = newest.m_time + extrapolateTime;
+        return renderTime - newest.m_time > extrapolationLimit ?
+            eInterpolationResult::STARVED : eInterpolationResult::EXTRAPOLATED;
+    }
+
+    // newest first, the render time is usually close to the front
+    for( size_t idx = m_count - 1; idx > 0; --idx )
+    {
+        const InterpolationSample& from = GetSample( idx - 1 );
+        if( from.m_time > renderTime )
+            continue;
+
+        const InterpolationSample& to = GetSample( idx );
+        float t = ( renderTime - from.m_time ) / ( to.m_time - from.m_time );
+        out_sample.m_time = renderTime;
+        out_sample.m_position = Lerp( from.m_position, to.m_position, t );
+        out_sample.m_scale = Lerp( from.m_scale, to.m_scale, t );
+        out_sample.m_color = Lerp( from.m_color, to.m_color, t );
+        break;
+    }
+    return eInterpolationResult::INTERPOLATED;
+}
+
+const InterpolationSample& InterpolationBuffer::GetNewest() const
+{
+    return GetSample( m_count - 1 );
+}
+
+const InterpolationSample& InterpolationBuffer::GetSample( size_t idx ) const
+{
+    size_t oldestIdx = ( m_nextIdx + INTERPOLATION_BUFFER_SIZE - m_count )
+        % INTERPOLATION_BUFFER_SIZE;
+    return m_samples[( oldestIdx + idx ) % INTERPOLATION_BUFFER_SIZE];
+}
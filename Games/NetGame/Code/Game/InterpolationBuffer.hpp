@@ -0,0 +1,68 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Game/GameplayDefines.hpp"
+
+// One snapshot's worth of a cube, at the host time the snapshot was taken
+struct InterpolationSample
+{
+    float m_time = 0.f;
+    Vec3 m_position;
+    Vec3 m_scale;
+    Rgba m_color;
+};
+
+enum class eInterpolationResult
+{
+    EMPTY,        // nothing to sample
+    INTERPOLATED, // between two states
+    EARLY,        // before the oldest state, held there
+    EXTRAPOLATED, // past the newest state, moving on at the last velocity
+    STARVED,      // past the newest state by more than the limit, held there
+};
+
+// How remote cubes are sampled and how often the buffers ran dry
+struct InterpolationSettings
+{
+    void ResetStats();
+    void Record( eInterpolationResult result, float slack );
+    string GetStatsString() const;
+
+    float m_delay = INTERPOLATION_DELAY;
+    float m_extrapolationLimit = EXTRAPOLATION_LIMIT;
+
+    // Stats, per cube per frame
+    size_t m_interpolatedCount = 0;
+    size_t m_earlyCount = 0;
+    size_t m_extrapolatedCount = 0;
+    size_t m_starvedCount = 0;
+    // newest state time minus render time, how close the buffers got to empty
+    float m_minSlack = 0.f;
+    bool m_hasSlack = false;
+};
+
+// Timestamped states of one NetCube, oldest overwritten first
+class InterpolationBuffer
+{
+public:
+    // states older than the newest are dropped, snapshots can arrive late
+    void Push( const InterpolationSample& sample );
+    eInterpolationResult Sample( float renderTime,
+                                 float extrapolationLimit,
+                                 InterpolationSample& out_sample ) const;
+    void Clear() { m_count = 0; }
+
+    bool IsEmpty() const { return m_count == 0; }
+    const InterpolationSample& GetNewest() const;
+
+private:
+    // 0 is the oldest
+    const InterpolationSample& GetSample( size_t idx ) const;
+
+public:
+
+    InterpolationSample m_samples[INTERPOLATION_BUFFER_SIZE];
+    size_t m_nextIdx = 0;
+    size_t m_count = 0;
+};
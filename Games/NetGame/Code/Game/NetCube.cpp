@@ -44,6 +44,15 @@ NetCube::~NetCube()
 
 void NetCube::Update()
 {
+    if( m_isInterpolated )
+    {
+        m_transform.SetLocalPosition( m_targetPosition );
+        m_transform.SetLocalEuler( m_targetEuler );
+        m_transform.SetLocalScale( m_targetScale );
+        m_renderable->GetMaterial( 0 )->SetTint( m_targetColor );
+        return;
+    }
+
     m_targetPosition += m_velocity * BULLET_SPEED * g_gameClock->GetDeltaSecondsF();
     Vec3 oldPos = m_transform.GetLocalPosition();
     Vec3 displacement = m_targetPosition - oldPos;
@@ -107,7 +116,8 @@ uint16 NetCube::GetNextFreeNetID()
 {
     for( uint16 i = 0; i < MAX_NET_ID_COUNT; ++i )
     {
-        s_nextID += 1;
+        // ids stay below MAX_NET_ID_COUNT so snapshots can bit pack them
+        s_nextID = ( s_nextID + 1 ) % MAX_NET_ID_COUNT;
         if( !ContainerUtils::ContainsKey( s_allCubes, s_nextID ) )
             return s_nextID;
     }
@@ -3,11 +3,10 @@
 #include "Engine/Math/Vec3.hpp"
 #include "Engine/Core/Rgba.hpp"
 #include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Net/NetCommonH.hpp"
 #include "Game/GameplayDefines.hpp"
 #include "Game/GameCommon.hpp"
-
-#define MAX_NET_ID_COUNT 1000
-#define INVALID_NET_ID ((uint16)(~0))
+#include "Game/InterpolationBuffer.hpp"
 
 class NetCube : public GameObject
 {
@@ -45,7 +44,7 @@ public:
     static uint16 s_nextID;
 
     uint16 m_netID;
-    uint8 m_factionID;
+    ConnectionIdx m_factionID; // owning player
 
     Vec3 m_targetPosition;
     Vec3 m_targetEuler;
@@ -56,4 +55,9 @@ public:
     Vec3 m_velocity = Vec3::ZEROS;
 
     float m_timeToLive = BULLET_LIFETIME;
+
+    // Client, remote cubes are placed from snapshots by
+    // GameState_Playing::UpdateInterpolatedCubes instead of chasing the target
+    InterpolationBuffer m_interpolation;
+    bool m_isInterpolated = false;
 };
@@ -1,5 +1,6 @@
 #include "Engine/Time/Clock.hpp"
 #include "Engine/Time/Timer.hpp"
+#include "Engine/Math/MathUtils.hpp"
 
 #include "Game/Player.hpp"
 #include "Game/ClientInputs.hpp"
@@ -19,7 +20,63 @@ Player::~Player()
         m_cube->SetShouldDie( true );
 }
 
+bool Player::IsJoining() const
+{
+    return m_joinSnapshot.m_id != INVALID_SNAPSHOT_ID
+        && m_ackedSnapshotID == INVALID_SNAPSHOT_ID;
+}
+
+void Player::ClearJoin()
+{
+    m_joinSnapshot.Clear( INVALID_SNAPSHOT_ID );
+    m_joinEntries.clear();
+    m_joinChunkEnds.clear();
+    m_joinChunksSent = 0;
+}
+
 bool Player::PopShootTimer()
 {
     return m_shootTimer->PopAllLaps() != 0;
 }
+
+void Player::SimulateMovement( const ClientInputs& input,
+                               Vec3& inout_position,
+                               Vec3& inout_direction )
+{
+    Vec3 translate = input.GetMoveDirection();
+    float length = translate.NormalizeAndGetLength();
+    if( length > 0.00001 )
+        inout_direction = translate;
+    inout_position += translate * input.GetDurationSeconds() * PLAYER_MOVE_SPEED;
+}
+
+void Player::QueueInput( const ClientInputs& input )
+{
+    if( !CyclicGreater( input.m_sequence, m_lastQueuedInput )
+        || !CyclicGreater( input.m_sequence, m_lastProcessedInput ) )
+        return;
+
+    // the host fell too far behind, the oldest inputs are dropped
+    if( (uint16) ( input.m_sequence - m_lastProcessedInput ) > INPUT_QUEUE_SIZE )
+        m_lastProcessedInput = (uint16) ( input.m_sequence - INPUT_QUEUE_SIZE );
+
+    m_inputQueue[input.m_sequence % INPUT_QUEUE_SIZE] = input;
+    m_lastQueuedInput = input.m_sequence;
+}
+
+bool Player::PopInput( ClientInputs& out_input )
+{
+    while( CyclicGreater( m_lastQueuedInput, m_lastProcessedInput ) )
+    {
+        // skips inputs lost in more packets than INPUT_REDUNDANCY covers,
+        // the client corrects for them
+        ++m_lastProcessedInput;
+        const ClientInputs& queued = m_inputQueue[m_lastProcessedInput % INPUT_QUEUE_SIZE];
+        if( queued.m_sequence == m_lastProcessedInput )
+        {
+            out_input = queued;
+            return true;
+        }
+    }
+    return false;
+}
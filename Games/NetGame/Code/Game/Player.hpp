@@ -1,9 +1,13 @@
 #pragma once
 #include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Net/NetCommonH.hpp"
 #include "Game/GameplayDefines.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/ClientInputs.hpp"
+#include "Game/Snapshot.hpp"
+#include "Game/PriorityAccumulator.hpp"
 
 class NetCube;
-class ClientInputs;
 class Timer;
 
 class Player
@@ -13,8 +17,51 @@ public:
 	~Player();
     bool PopShootTimer();
 
+    // moves for as long as the input was held, the host and client
+    // prediction both go through here so they agree
+    static void SimulateMovement( const ClientInputs& input,
+                                  Vec3& inout_position,
+                                  Vec3& inout_direction );
+
+    // keeps inputs newer than any queued, older ones are redundant repeats
+    void QueueInput( const ClientInputs& input );
+    // next input after m_lastProcessedInput, inputs that never arrived are skipped
+    bool PopInput( ClientInputs& out_input );
+
+    // streaming the join snapshot or waiting for it to be acked
+    bool IsJoining() const;
+    bool HasSentJoin() const { return m_joinChunksSent == m_joinChunkEnds.size(); }
+    void ClearJoin();
+
     NetCube* m_cube = nullptr;
     ClientInputs* m_inputs = nullptr;
     Timer* m_shootTimer = nullptr;
-    uint8 m_id;
+    ConnectionIdx m_id; // connection index of the owner
+
+    // newest snapshot this player told us it has, the baseline for deltas
+    uint16 m_ackedSnapshotID = INVALID_SNAPSHOT_ID;
+
+    // what this player was sent, changes past the byte budget are left out so
+    // this lags the world
+    SnapshotHistory m_sentSnapshots;
+    PriorityAccumulator m_priority;
+    size_t m_relevantCubeCount = 0; // in the last snapshot's interest set
+
+    // Join, every cube when the player entered, sent reliably a few chunks a
+    // frame. Kept as the baseline until the player acks something newer
+    WorldSnapshot m_joinSnapshot;
+    vector<SnapshotDeltaEntry> m_joinEntries;
+    vector<size_t> m_joinChunkEnds;
+    size_t m_joinChunksSent = 0;
+    uint m_joinHostTimeMS = 0;
+    double m_joinStartTime = 0.0; // real time
+
+    // newest input simulated, sent back so the client can reconcile
+    // starts one before the client's first sequence
+    uint16 m_lastProcessedInput = (uint16) ~0;
+
+    // received inputs after m_lastProcessedInput up to m_lastQueuedInput,
+    // indexed by sequence
+    ClientInputs m_inputQueue[INPUT_QUEUE_SIZE];
+    uint16 m_lastQueuedInput = (uint16) ~0;
 };
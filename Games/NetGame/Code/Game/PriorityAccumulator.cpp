@@ -0,0 +1,120 @@
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/String/StringUtils.hpp"
+
+#include "Game/PriorityAccumulator.hpp"
+#include "Game/Snapshot.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+bool NetIDLess( const SnapshotDeltaEntry& a, const SnapshotDeltaEntry& b )
+{
+    return a.m_netID < b.m_netID;
+}
+
+}
+
+PriorityAccumulator::PriorityAccumulator()
+{
+    Reset();
+}
+
+void PriorityAccumulator::Reset()
+{
+    for( float& accumulated : m_accumulated )
+        accumulated = 0.f;
+    ResetStats();
+}
+
+float PriorityAccumulator::GetPriority( const CubeSnapshot& cube, const Vec3& viewerPosition )
+{
+    float distance = ( cube.m_position - viewerPosition ).GetLength();
+    float priority = 1.f / ( 1.f + distance / PRIORITY_DISTANCE_FALLOFF );
+    return priority * ( 1.f + cube.m_velocity.GetLength() * PRIORITY_VELOCITY_WEIGHT );
+}
+
+void PriorityAccumulator::Prioritize( vector<SnapshotDeltaEntry>& inout_entries,
+                                      uint16 viewerNetID,
+                                      const Vec3& viewerPosition,
+                                      float deltaSeconds,
+                                      size_t byteBudget )
+{
+    ++m_snapshotCount;
+
+    // removals and the viewer's cube first, the rest by accumulated priority
+    size_t bitBudget = byteBudget == 0 ? ~(size_t) 0 : byteBudget * 8;
+    size_t mustSendCount = 0;
+    size_t bitCount = 0;
+    for( size_t entryIdx = 0; entryIdx < inout_entries.size(); ++entryIdx )
+    {
+        SnapshotDeltaEntry& entry = inout_entries[entryIdx];
+        // the client reconciles against its own cube in every snapshot
+        bool mustSend = entry.m_cube == nullptr || entry.m_netID == viewerNetID;
+        if( mustSend )
+        {
+            bitCount += entry.GetWriteBitCount();
+            std::swap( entry, inout_entries[mustSendCount] );
+            ++mustSendCount;
+            continue;
+        }
+
+        float& accumulated = m_accumulated[entry.m_netID];
+        accumulated += GetPriority( *entry.m_cube, viewerPosition ) * deltaSeconds;
+        m_maxAccumulated = Max( m_maxAccumulated, accumulated );
+    }
+
+    std::sort( inout_entries.begin() + mustSendCount, inout_entries.end(),
+               [this]( const SnapshotDeltaEntry& a, const SnapshotDeltaEntry& b )
+    {
+        return m_accumulated[a.m_netID] > m_accumulated[b.m_netID];
+    } );
+
+    // skips entries that do not fit, a smaller one further down may
+    size_t keptCount = mustSendCount;
+    for( size_t entryIdx = mustSendCount; entryIdx < inout_entries.size(); ++entryIdx )
+    {
+        SnapshotDeltaEntry& entry = inout_entries[entryIdx];
+        size_t entryBitCount = entry.GetWriteBitCount();
+        if( bitCount + entryBitCount > bitBudget )
+            continue;
+        bitCount += entryBitCount;
+        m_accumulated[entry.m_netID] = 0.f;
+        inout_entries[keptCount] = entry;
+        ++keptCount;
+    }
+    for( size_t entryIdx = 0; entryIdx < mustSendCount; ++entryIdx )
+        m_accumulated[inout_entries[entryIdx].m_netID] = 0.f;
+
+    m_deferredEntryCount += inout_entries.size() - keptCount;
+    m_sentEntryCount += keptCount;
+    m_sentBitCount += bitCount;
+    m_maxSentBitCount = Max( m_maxSentBitCount, bitCount );
+
+    inout_entries.resize( keptCount );
+    std::sort( inout_entries.begin(), inout_entries.end(), NetIDLess );
+}
+
+void PriorityAccumulator::ResetStats()
+{
+    m_snapshotCount = 0;
+    m_sentEntryCount = 0;
+    m_deferredEntryCount = 0;
+    m_sentBitCount = 0;
+    m_maxSentBitCount = 0;
+    m_maxAccumulated = 0.f;
+}
+
+string PriorityAccumulator::GetStatsString() const
+{
+    size_t snapshotCount = Max( m_snapshotCount, (size_t) 1 );
+    return Stringf(
+        "snapshots %u  bytes avg %u max %u  entries sent %u deferred %u  "
+        "max accumulated %.2f",
+        (uint) m_snapshotCount,
+        (uint) ( m_sentBitCount / 8 / snapshotCount ),
+        (uint) ( ( m_maxSentBitCount + 7 ) / 8 ),
+        (uint) m_sentEntryCount, (uint) m_deferredEntryCount,
+        m_maxAccumulated );
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Game/GameplayDefines.hpp"
+
+struct CubeSnapshot;
+struct SnapshotDeltaEntry;
+
+// Per player, how long each cube's changes have waited to be sent, scaled by
+// how much the cube matters to the player. Each snapshot gets the entries
+// that waited longest first, up to a byte budget, the rest keep accumulating
+class PriorityAccumulator
+{
+public:
+    PriorityAccumulator();
+    void Reset();
+
+    // closer and faster cubes matter more
+    static float GetPriority( const CubeSnapshot& cube, const Vec3& viewerPosition );
+
+    // keeps the highest priority entries whose bits fit byteBudget, sorted by
+    // netID. Removals and the viewer's own cube always stay, 0 for no budget
+    void Prioritize( vector<SnapshotDeltaEntry>& inout_entries,
+                     uint16 viewerNetID,
+                     const Vec3& viewerPosition,
+                     float deltaSeconds,
+                     size_t byteBudget );
+
+    void ResetStats();
+    string GetStatsString() const;
+
+public:
+
+    float m_accumulated[MAX_NET_ID_COUNT];
+
+    // Stats, per Prioritize
+    size_t m_snapshotCount = 0;
+    size_t m_sentEntryCount = 0;
+    size_t m_deferredEntryCount = 0;
+    size_t m_sentBitCount = 0;
+    size_t m_maxSentBitCount = 0;
+    float m_maxAccumulated = 0.f; // how long the most starved entry waited, times its priority
+};
@@ -0,0 +1,406 @@
+#include "Engine/DataUtils/BitPacker.hpp"
+#include "Engine/Core/EngineCommonC.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include "Game/Snapshot.hpp"
+#include "Game/NetCube.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+bool CubeSnapshotLess( const CubeSnapshot& cube, uint16 netID )
+{
+    return cube.m_netID < netID;
+}
+
+}
+
+//--------------------------------------------------------------------------------------
+// CubeSnapshot
+
+uint8 CubeSnapshot::GetChangedFields( const CubeSnapshot& baseline ) const
+{
+    uint8 fields = 0;
+    if( m_position != baseline.m_position )
+        fields |= SNAPSHOT_FIELD_POSITION;
+    if( m_scale != baseline.m_scale )
+        fields |= SNAPSHOT_FIELD_SCALE;
+    if( !( m_color == baseline.m_color ) )
+        fields |= SNAPSHOT_FIELD_COLOR;
+    if( m_velocity != baseline.m_velocity )
+        fields |= SNAPSHOT_FIELD_VELOCITY;
+    return fields;
+}
+
+void CubeSnapshot::Write( BitPacker& bits, uint8 fields ) const
+{
+    if( fields & SNAPSHOT_FIELD_POSITION )
+    {
+        bits.WriteVec3( m_position, -SNAPSHOT_POSITION_RANGE,
+                        SNAPSHOT_POSITION_RANGE, SNAPSHOT_POSITION_PRECISION );
+    }
+    if( fields & SNAPSHOT_FIELD_SCALE )
+        bits.WriteVec3( m_scale, 0.f, SNAPSHOT_SCALE_MAX, SNAPSHOT_SCALE_PRECISION );
+    if( fields & SNAPSHOT_FIELD_COLOR )
+        bits.WriteRgba( m_color );
+    if( fields & SNAPSHOT_FIELD_VELOCITY )
+    {
+        // most cubes are still, those cost a single bit
+        float speed = m_velocity.GetLength();
+        bool isMoving = speed > SNAPSHOT_SPEED_PRECISION;
+        bits.WriteBool( isMoving );
+        if( isMoving )
+        {
+            bits.WriteFloat( speed, 0.f, SNAPSHOT_SPEED_MAX, SNAPSHOT_SPEED_PRECISION );
+            bits.WriteUnitVec3( m_velocity / speed, SNAPSHOT_DIRECTION_BITS );
+        }
+    }
+}
+
+bool CubeSnapshot::Read( BitPacker& bits, uint8 fields )
+{
+    if( fields & SNAPSHOT_FIELD_POSITION )
+    {
+        bits.ReadVec3( &m_position, -SNAPSHOT_POSITION_RANGE,
+                       SNAPSHOT_POSITION_RANGE, SNAPSHOT_POSITION_PRECISION );
+    }
+    if( fields & SNAPSHOT_FIELD_SCALE )
+        bits.ReadVec3( &m_scale, 0.f, SNAPSHOT_SCALE_MAX, SNAPSHOT_SCALE_PRECISION );
+    if( fields & SNAPSHOT_FIELD_COLOR )
+        bits.ReadRgba( &m_color );
+    if( fields & SNAPSHOT_FIELD_VELOCITY )
+    {
+        bool isMoving = false;
+        bits.ReadBool( &isMoving );
+        m_velocity = Vec3::ZEROS;
+        if( isMoving )
+        {
+            float speed = 0.f;
+            Vec3 direction;
+            bits.ReadFloat( &speed, 0.f, SNAPSHOT_SPEED_MAX, SNAPSHOT_SPEED_PRECISION );
+            bits.ReadUnitVec3( &direction, SNAPSHOT_DIRECTION_BITS );
+            m_velocity = direction * speed;
+        }
+    }
+    return !bits.HasFailed();
+}
+
+uint CubeSnapshot::GetWriteBitCount( uint8 fields )
+{
+    uint bitCount = 0;
+    if( fields & SNAPSHOT_FIELD_POSITION )
+    {
+        bitCount += 3 * BitPacker::GetFloatBitCount( -SNAPSHOT_POSITION_RANGE,
+            SNAPSHOT_POSITION_RANGE, SNAPSHOT_POSITION_PRECISION );
+    }
+    if( fields & SNAPSHOT_FIELD_SCALE )
+    {
+        bitCount += 3 * BitPacker::GetFloatBitCount(
+            0.f, SNAPSHOT_SCALE_MAX, SNAPSHOT_SCALE_PRECISION );
+    }
+    if( fields & SNAPSHOT_FIELD_COLOR )
+        bitCount += 4 * 8;
+    if( fields & SNAPSHOT_FIELD_VELOCITY )
+    {
+        bitCount += 1
+            + BitPacker::GetFloatBitCount( 0.f, SNAPSHOT_SPEED_MAX, SNAPSHOT_SPEED_PRECISION )
+            + 2 * SNAPSHOT_DIRECTION_BITS;
+    }
+    return bitCount;
+}
+
+//--------------------------------------------------------------------------------------
+// SnapshotDeltaEntry
+
+void SnapshotDeltaEntry::Write( BitPacker& bits ) const
+{
+    bits.WriteUint( m_netID, MAX_NET_ID_COUNT - 1 );
+    bool isRemoved = ( m_fields & SNAPSHOT_FIELD_REMOVED ) != 0;
+    bits.WriteBool( isRemoved );
+    if( isRemoved )
+        return;
+    bits.WriteBits( m_fields, SNAPSHOT_FIELD_BIT_COUNT );
+    m_cube->Write( bits, m_fields );
+}
+
+uint SnapshotDeltaEntry::GetWriteBitCount() const
+{
+    uint bitCount = BitPacker::GetBitsRequired( MAX_NET_ID_COUNT - 1 ) + 1;
+    if( m_fields & SNAPSHOT_FIELD_REMOVED )
+        return bitCount;
+    return bitCount + SNAPSHOT_FIELD_BIT_COUNT + CubeSnapshot::GetWriteBitCount( m_fields );
+}
+
+bool SplitDeltaIntoChunks( const vector<SnapshotDeltaEntry>& entries,
+                           vector<size_t>& out_chunkEnds )
+{
+    out_chunkEnds.clear();
+    size_t chunkBitCount = 0;
+    for( size_t entryIdx = 0; entryIdx < entries.size(); ++entryIdx )
+    {
+        size_t entryBitCount = entries[entryIdx].GetWriteBitCount();
+        if( chunkBitCount + entryBitCount > SNAPSHOT_CHUNK_PAYLOAD * 8 )
+        {
+            if( out_chunkEnds.size() == MAX_SNAPSHOT_CHUNKS - 1 )
+                return false;
+            out_chunkEnds.push_back( entryIdx );
+            chunkBitCount = 0;
+        }
+        chunkBitCount += entryBitCount;
+    }
+    out_chunkEnds.push_back( entries.size() );
+    return true;
+}
+
+//--------------------------------------------------------------------------------------
+// WorldSnapshot
+
+void WorldSnapshot::Capture( uint16 snapshotID )
+{
+    Clear( snapshotID );
+
+    // s_allCubes is a map so this comes out sorted
+    for( auto& pair : NetCube::GetAllCubes() )
+    {
+        NetCube* cube = pair.second;
+        if( cube->ShouldDie() )
+            continue;
+
+        m_cubes.emplace_back();
+        CubeSnapshot& state = m_cubes.back();
+        Transform& t = cube->GetTransform();
+        state.m_netID = cube->GetNetID();
+        state.m_position = t.GetLocalPosition();
+        state.m_scale = t.GetLocalScale();
+        state.m_color = cube->GetColor();
+        state.m_velocity = cube->m_velocity;
+    }
+}
+
+void WorldSnapshot::Clear( uint16 snapshotID )
+{
+    m_id = snapshotID;
+    // keeps capacity so steady state does not allocate
+    m_cubes.clear();
+}
+
+const CubeSnapshot* WorldSnapshot::Find( uint16 netID ) const
+{
+    auto iter = std::lower_bound(
+        m_cubes.begin(), m_cubes.end(), netID, CubeSnapshotLess );
+    if( iter != m_cubes.end() && iter->m_netID == netID )
+        return &( *iter );
+    return nullptr;
+}
+
+CubeSnapshot& WorldSnapshot::FindOrAdd( uint16 netID )
+{
+    auto iter = std::lower_bound(
+        m_cubes.begin(), m_cubes.end(), netID, CubeSnapshotLess );
+    if( iter != m_cubes.end() && iter->m_netID == netID )
+        return *iter;
+
+    iter = m_cubes.insert( iter, CubeSnapshot() );
+    iter->m_netID = netID;
+    return *iter;
+}
+
+void WorldSnapshot::Remove( uint16 netID )
+{
+    auto iter = std::lower_bound(
+        m_cubes.begin(), m_cubes.end(), netID, CubeSnapshotLess );
+    if( iter != m_cubes.end() && iter->m_netID == netID )
+        m_cubes.erase( iter );
+}
+
+void WorldSnapshot::BuildDelta( const WorldSnapshot* baseline,
+                                vector<SnapshotDeltaEntry>& out_entries ) const
+{
+    out_entries.clear();
+
+    if( baseline == nullptr )
+    {
+        for( const CubeSnapshot& cube : m_cubes )
+        {
+            SnapshotDeltaEntry entry;
+            entry.m_cube = &cube;
+            entry.m_netID = cube.m_netID;
+            entry.m_fields = SNAPSHOT_FIELD_ALL;
+            out_entries.push_back( entry );
+        }
+        return;
+    }
+
+    // both are sorted by netID, walk them together
+    size_t currentIdx = 0;
+    size_t baselineIdx = 0;
+    while( currentIdx < m_cubes.size() || baselineIdx < baseline->m_cubes.size() )
+    {
+        const CubeSnapshot* current = currentIdx < m_cubes.size() ?
+            &m_cubes[currentIdx] : nullptr;
+        const CubeSnapshot* base = baselineIdx < baseline->m_cubes.size() ?
+            &baseline->m_cubes[baselineIdx] : nullptr;
+
+        SnapshotDeltaEntry entry;
+        if( base == nullptr
+            || ( current != nullptr && current->m_netID < base->m_netID ) )
+        {
+            // new since baseline
+            entry.m_cube = current;
+            entry.m_netID = current->m_netID;
+            entry.m_fields = SNAPSHOT_FIELD_ALL;
+            ++currentIdx;
+        }
+        else if( current == nullptr || base->m_netID < current->m_netID )
+        {
+            // gone since baseline
+            entry.m_netID = base->m_netID;
+            entry.m_fields = SNAPSHOT_FIELD_REMOVED;
+            ++baselineIdx;
+        }
+        else
+        {
+            entry.m_cube = current;
+            entry.m_netID = current->m_netID;
+            entry.m_fields = current->GetChangedFields( *base );
+            ++currentIdx;
+            ++baselineIdx;
+        }
+
+        if( entry.m_fields != 0 )
+            out_entries.push_back( entry );
+    }
+}
+
+//--------------------------------------------------------------------------------------
+// SnapshotHistory
+
+WorldSnapshot& SnapshotHistory::GetSlot( uint16 snapshotID )
+{
+    return m_snapshots[snapshotID % SNAPSHOT_HISTORY_SIZE];
+}
+
+const WorldSnapshot* SnapshotHistory::Get( uint16 snapshotID ) const
+{
+    if( snapshotID == INVALID_SNAPSHOT_ID )
+        return nullptr;
+    const WorldSnapshot& snapshot = m_snapshots[snapshotID % SNAPSHOT_HISTORY_SIZE];
+    if( snapshot.m_id != snapshotID )
+        return nullptr;
+    return &snapshot;
+}
+
+//--------------------------------------------------------------------------------------
+// SnapshotReceiver
+
+bool SnapshotReceiver::ReadChunk( uint16 snapshotID,
+                                  uint16 baselineID,
+                                  uint hostTimeMS,
+                                  bool hasDeferred,
+                                  uint8 chunkIdx,
+                                  uint8 chunkCount,
+                                  uint16 entryCount,
+                                  BitPacker& bits )
+{
+    if( chunkCount == 0 || chunkCount > MAX_SNAPSHOT_CHUNKS || chunkIdx >= chunkCount )
+        return false;
+
+    // already have this or something newer
+    if( m_latestID != INVALID_SNAPSHOT_ID
+        && CyclicLesserEqual( snapshotID, m_latestID ) )
+        return false;
+
+    if( m_assembling.m_id != snapshotID )
+    {
+        // older than the one being built
+        if( m_assembling.m_id != INVALID_SNAPSHOT_ID
+            && m_assemblingChunkMask != 0
+            && CyclicLesser( snapshotID, m_assembling.m_id ) )
+            return false;
+
+        const WorldSnapshot* baseline = m_history.Get( baselineID );
+        if( baselineID != INVALID_SNAPSHOT_ID && baseline == nullptr )
+        {
+            // host will keep sending against our last ack until we catch up
+            return false;
+        }
+
+        if( baseline )
+        {
+            m_assembling.m_cubes = baseline->m_cubes;
+            m_assembling.m_id = snapshotID;
+        }
+        else
+        {
+            m_assembling.Clear( snapshotID );
+        }
+        m_assemblingChunkMask = 0;
+        m_assemblingChunkCount = chunkCount;
+    }
+
+    uint64 chunkBit = (uint64) 1 << chunkIdx;
+    if( m_assemblingChunkMask & chunkBit )
+        return false;
+
+    for( uint16 entryIdx = 0; entryIdx < entryCount; ++entryIdx )
+    {
+        uint netID;
+        bool isRemoved;
+        bits.ReadUint( &netID, MAX_NET_ID_COUNT - 1 );
+        bits.ReadBool( &isRemoved );
+        if( bits.HasFailed() )
+            return false;
+
+        if( isRemoved )
+        {
+            m_assembling.Remove( (uint16) netID );
+            continue;
+        }
+
+        uint32 fields;
+        if( !bits.ReadBits( &fields, SNAPSHOT_FIELD_BIT_COUNT ) )
+            return false;
+        CubeSnapshot& cube = m_assembling.FindOrAdd( (uint16) netID );
+        if( !cube.Read( bits, (uint8) fields ) )
+            return false;
+        cube.m_hostTimeMS = hostTimeMS;
+    }
+
+    m_assemblingChunkMask |= chunkBit;
+    uint64 completeMask = m_assemblingChunkCount == 64 ?
+        ~(uint64) 0 : ( (uint64) 1 << m_assemblingChunkCount ) - 1;
+    if( m_assemblingChunkMask != completeMask )
+        return false;
+
+    // nothing was held back, the cubes left out are unchanged as of now
+    if( !hasDeferred )
+    {
+        for( CubeSnapshot& cube : m_assembling.m_cubes )
+            cube.m_hostTimeMS = hostTimeMS;
+    }
+
+    WorldSnapshot& slot = m_history.GetSlot( snapshotID );
+    slot.m_id = snapshotID;
+    slot.m_cubes = m_assembling.m_cubes;
+    m_latestID = snapshotID;
+    m_assemblingChunkMask = 0;
+    m_assembling.m_id = INVALID_SNAPSHOT_ID;
+    return true;
+}
+
+const WorldSnapshot* SnapshotReceiver::GetLatest() const
+{
+    return m_history.Get( m_latestID );
+}
+
+void SnapshotReceiver::Reset()
+{
+    for( WorldSnapshot& snapshot : m_history.m_snapshots )
+        snapshot.Clear( INVALID_SNAPSHOT_ID );
+    m_assembling.Clear( INVALID_SNAPSHOT_ID );
+    m_assemblingChunkMask = 0;
+    m_assemblingChunkCount = 0;
+    m_latestID = INVALID_SNAPSHOT_ID;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Core/Rgba.hpp"
+#include "Engine/Core/EngineCommonH.hpp"
+#include "Game/GameplayDefines.hpp"
+
+class BitPacker;
+
+// which fields of a CubeSnapshot are in a delta entry
+enum eSnapshotField : uint8
+{
+    SNAPSHOT_FIELD_POSITION = BIT_FLAG( 0 ),
+    SNAPSHOT_FIELD_SCALE = BIT_FLAG( 1 ),
+    SNAPSHOT_FIELD_COLOR = BIT_FLAG( 2 ),
+    SNAPSHOT_FIELD_VELOCITY = BIT_FLAG( 3 ),
+    SNAPSHOT_FIELD_ALL = 0b1111,
+
+    // cube was in the baseline but is gone now, no fields follow
+    SNAPSHOT_FIELD_REMOVED = BIT_FLAG( 7 ),
+};
+
+// bits needed for SNAPSHOT_FIELD_ALL, removed goes as its own bit
+constexpr uint SNAPSHOT_FIELD_BIT_COUNT = 4;
+
+// Replicated state of one NetCube
+struct CubeSnapshot
+{
+    // fields that differ from baseline
+    uint8 GetChangedFields( const CubeSnapshot& baseline ) const;
+
+    // quantized, see the SNAPSHOT_ defines in GameplayDefines
+    void Write( BitPacker& bits, uint8 fields ) const;
+    bool Read( BitPacker& bits, uint8 fields );
+    // worst case, velocity may come out smaller
+    static uint GetWriteBitCount( uint8 fields );
+
+    uint16 m_netID = 0;
+    Vec3 m_position;
+    Vec3 m_scale;
+    Rgba m_color;
+    Vec3 m_velocity;
+    // receiver only, host time of the snapshot this state came in, not written
+    uint m_hostTimeMS = 0;
+};
+
+// One entry of a delta between two WorldSnapshots
+struct SnapshotDeltaEntry
+{
+    const CubeSnapshot* m_cube = nullptr; // null when removed
+    uint16 m_netID = 0;
+    uint8 m_fields = 0;
+
+    // [netID][removed bit][fields][fields...]
+    void Write( BitPacker& bits ) const;
+    uint GetWriteBitCount() const;
+};
+
+// Splits entries into runs that fit SNAPSHOT_CHUNK_PAYLOAD, out_chunkEnds gets
+// one past the last entry of each, an empty delta is one empty chunk
+// false if it takes more than MAX_SNAPSHOT_CHUNKS
+bool SplitDeltaIntoChunks( const vector<SnapshotDeltaEntry>& entries,
+                           vector<size_t>& out_chunkEnds );
+
+// Every replicated NetCube at one host tick, sorted by netID
+class WorldSnapshot
+{
+public:
+    void Capture( uint16 snapshotID );
+    void Clear( uint16 snapshotID );
+
+    const CubeSnapshot* Find( uint16 netID ) const;
+    // finds or inserts keeping the sort
+    CubeSnapshot& FindOrAdd( uint16 netID );
+    void Remove( uint16 netID );
+
+    // entries that turn baseline into this, a null baseline gives every
+    // cube with all fields
+    void BuildDelta( const WorldSnapshot* baseline,
+                     vector<SnapshotDeltaEntry>& out_entries ) const;
+
+public:
+
+    uint16 m_id = INVALID_SNAPSHOT_ID;
+    vector<CubeSnapshot> m_cubes;
+};
+
+// The last SNAPSHOT_HISTORY_SIZE snapshots, looked up by id
+class SnapshotHistory
+{
+public:
+    // returns the slot for id, whatever was there is overwritten
+    WorldSnapshot& GetSlot( uint16 snapshotID );
+    // null if never stored or already overwritten
+    const WorldSnapshot* Get( uint16 snapshotID ) const;
+
+public:
+
+    WorldSnapshot m_snapshots[SNAPSHOT_HISTORY_SIZE];
+};
+
+// Client side, rebuilds snapshots out of delta chunks
+// A snapshot is complete once all its chunks have arrived, chunks of an
+// older snapshot than the one being built are dropped
+class SnapshotReceiver
+{
+public:
+    // reads the entries of one chunk, the chunk header has already been read
+    // returns true if this chunk completed the snapshot, see GetLatest
+    // hasDeferred is set when the host's budget left changed cubes out, the
+    // ones not in the delta keep their m_hostTimeMS then
+    bool ReadChunk( uint16 snapshotID,
+                    uint16 baselineID,
+                    uint hostTimeMS,
+                    bool hasDeferred,
+                    uint8 chunkIdx,
+                    uint8 chunkCount,
+                    uint16 entryCount,
+                    BitPacker& bits );
+
+    const WorldSnapshot* GetLatest() const;
+    void Reset();
+
+public:
+
+    SnapshotHistory m_history;
+    WorldSnapshot m_assembling;
+    uint64 m_assemblingChunkMask = 0;
+    uint8 m_assemblingChunkCount = 0;
+    uint16 m_latestID = INVALID_SNAPSHOT_ID;
+};
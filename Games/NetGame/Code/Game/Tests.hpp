@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <functional>
+#include <string.h>
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Core/ErrorUtils.hpp"
 #include "Engine/Math/Trajectory.hpp"
@@ -12,14 +13,22 @@
 #include "Engine/Math/Solver.hpp"
 #include "Engine/DataUtils/EndianUtils.hpp"
 #include "Engine/DataUtils/BytePacker.hpp"
+#include "Engine/DataUtils/BitPacker.hpp"
 #include "Engine/Net/NetAddress.hpp"
 #include "Engine/Net/Net.hpp"
 #include "Engine/Net/TCPSocket.hpp"
 #include "Engine/Math/Random.hpp"
 #include "Engine/Core/SystemUtils.hpp"
 #include "Engine/Net/UDPSocket.hpp"
+#include "Engine/Net/NetPacket.hpp"
+#include "Engine/Net/PacketCompressor.hpp"
+#include "Engine/Net/TimerWheel.hpp"
+#include "Engine/Net/FragmentAssembler.hpp"
+#include "Engine/Net/NetMessage.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/NetCube.hpp"
+#include "Game/Snapshot.hpp"
 
 
 namespace Tests
@@ -157,6 +166,532 @@ void IOTests()
 
 
 
+void BitPackerTests()
+{
+    Random random( 1234 );
+
+    // every width 1 to 32 back to back, so values straddle byte boundaries
+    BytePacker bytes;
+    BitPacker writer( bytes );
+    uint32 values[33];
+    for( uint bitCount = 1; bitCount <= 32; ++bitCount )
+    {
+        uint32 value = ( (uint32) random.IntInRange( 0, 0xFFFF ) << 16 )
+            | (uint32) random.IntInRange( 0, 0xFFFF );
+        if( bitCount < 32 )
+            value &= ( 1U << bitCount ) - 1U;
+        values[bitCount] = value;
+        writer.WriteBits( value, bitCount );
+    }
+    writer.FlushWrite();
+    PrintfTest( writer.GetWrittenBitCount() == 528 && bytes.GetWrittenByteCount() == 66,
+                "BitPacker wrote %u bits in %u bytes, expected 528 in 66",
+                (uint) writer.GetWrittenBitCount(), (uint) bytes.GetWrittenByteCount() );
+
+    BitPacker reader( bytes );
+    bool bitsMatch = true;
+    for( uint bitCount = 1; bitCount <= 32; ++bitCount )
+    {
+        uint32 value;
+        reader.ReadBits( &value, bitCount );
+        if( value != values[bitCount] )
+        {
+            PrintfTest( false, "BitPacker %u bit read %u, wrote %u",
+                        bitCount, value, values[bitCount] );
+            bitsMatch = false;
+        }
+    }
+    PrintfTest( bitsMatch && !reader.HasFailed(), "BitPacker bits 1 to 32 read write test" );
+
+    // uints take exactly the bits their range needs and clamp to it
+    BytePacker uintBytes;
+    BitPacker uintWriter( uintBytes );
+    const uint maxValues[] = { 1, 5, 999, 1000, 65535 };
+    for( uint maxValue : maxValues )
+    {
+        uintWriter.WriteUint( 0, maxValue );
+        uintWriter.WriteUint( maxValue / 2, maxValue );
+        uintWriter.WriteUint( maxValue + 7, maxValue );
+    }
+    uintWriter.FlushWrite();
+    size_t expectedUintBits = 3 * ( 1 + 3 + 10 + 10 + 16 );
+    BitPacker uintReader( uintBytes );
+    bool uintsMatch = uintWriter.GetWrittenBitCount() == expectedUintBits;
+    for( uint maxValue : maxValues )
+    {
+        uint zero, half, clamped;
+        uintReader.ReadUint( &zero, maxValue );
+        uintReader.ReadUint( &half, maxValue );
+        uintReader.ReadUint( &clamped, maxValue );
+        uintsMatch = uintsMatch && zero == 0 && half == maxValue / 2 && clamped == maxValue;
+    }
+    PrintfTest( uintsMatch && !uintReader.HasFailed(),
+                "BitPacker uint range test, %u bits expected %u",
+                (uint) uintWriter.GetWrittenBitCount(), (uint) expectedUintBits );
+
+    // quantized floats come back within half the precision, out of range clamps
+    constexpr float minFloat = -512.f;
+    constexpr float maxFloat = 512.f;
+    constexpr float precision = 0.02f;
+    BytePacker floatBytes;
+    BitPacker floatWriter( floatBytes );
+    float floats[100];
+    for( float& value : floats )
+    {
+        value = random.FloatInRange( minFloat, maxFloat );
+        floatWriter.WriteFloat( value, minFloat, maxFloat, precision );
+    }
+    floatWriter.WriteFloat( maxFloat + 100.f, minFloat, maxFloat, precision );
+    floatWriter.WriteFloat( minFloat - 100.f, minFloat, maxFloat, precision );
+    floatWriter.FlushWrite();
+
+    BitPacker floatReader( floatBytes );
+    float maxFloatError = 0.f;
+    for( float value : floats )
+    {
+        float readValue;
+        floatReader.ReadFloat( &readValue, minFloat, maxFloat, precision );
+        maxFloatError = Max( maxFloatError, fabsf( readValue - value ) );
+    }
+    float high, low;
+    floatReader.ReadFloat( &high, minFloat, maxFloat, precision );
+    floatReader.ReadFloat( &low, minFloat, maxFloat, precision );
+    PrintfTest( maxFloatError <= precision * 0.5f && high == maxFloat && low == minFloat
+                && !floatReader.HasFailed(),
+                "BitPacker float quantization test, max error %f precision %f",
+                maxFloatError, precision );
+
+    // octahedral unit vectors, 10 bits a component is well under a degree
+    constexpr uint directionBits = 10;
+    BytePacker vecBytes;
+    BitPacker vecWriter( vecBytes );
+    Vec3 directions[200];
+    for( Vec3& direction : directions )
+    {
+        do
+        {
+            direction = random.Vec3InRange( Vec3::NEG_ONES, Vec3::ONES );
+        } while( direction.GetLengthSquared() < 0.01f );
+        direction = direction.GetNormalized();
+        vecWriter.WriteUnitVec3( direction, directionBits );
+    }
+    vecWriter.FlushWrite();
+
+    BitPacker vecReader( vecBytes );
+    float minDot = 1.f;
+    for( const Vec3& direction : directions )
+    {
+        Vec3 readDirection;
+        vecReader.ReadUnitVec3( &readDirection, directionBits );
+        minDot = Min( minDot, Dot( direction, readDirection ) );
+    }
+    float maxErrorDegrees = acosf( Clampf( minDot, -1.f, 1.f ) ) * 180.f / 3.14159265f;
+    PrintfTest( maxErrorDegrees < 0.5f && !vecReader.HasFailed(),
+                "BitPacker unit vec3 test, max error %f degrees", maxErrorDegrees );
+
+    // reading past the end fails and stays failed
+    BytePacker shortBytes;
+    BitPacker shortWriter( shortBytes );
+    shortWriter.WriteBits( 0x5A5, 12 );
+    shortWriter.FlushWrite();
+    BitPacker shortReader( shortBytes );
+    uint32 first, pastEnd, afterFail;
+    bool readFirst = shortReader.ReadBits( &first, 12 );
+    bool readPastEnd = shortReader.ReadBits( &pastEnd, 8 );
+    bool readAfterFail = shortReader.ReadBits( &afterFail, 1 );
+    PrintfTest( readFirst && first == 0x5A5 && !readPastEnd && !readAfterFail
+                && shortReader.HasFailed(),
+                "BitPacker read past the end fails test" );
+}
+
+// sends body through sender's WritePacket and receiver's ReadPacket like
+// PacketChannel does, false if what comes out is not body
+bool CompressRoundTrip( PacketCompressor& sender,
+                        PacketCompressor& receiver,
+                        const Byte* body,
+                        size_t bodySize,
+                        size_t& out_sentSize,
+                        bool& out_isCompressed )
+{
+    NetPacket packet;
+    packet.m_header.m_message_count = 1;
+    packet.SetWriteHead( sizeof( PacketHeader ) );
+    packet.WriteBytes( bodySize, body );
+    packet.PackHeader();
+
+    Byte wire[PACKET_MTU];
+    out_sentSize = sender.WritePacket( packet, wire );
+
+    NetPacket received;
+    received.WriteBytes( out_sentSize, wire );
+    if( !received.UnpackHeader() )
+        return false;
+    out_isCompressed = ( received.m_header.m_flags & PACKET_FLAG_COMPRESSED ) != 0;
+    if( !receiver.ReadPacket( received ) )
+        return false;
+
+    return received.GetWrittenByteCount() == sizeof( PacketHeader ) + bodySize
+        && memcmp( received.GetBuffer() + sizeof( PacketHeader ), body, bodySize ) == 0;
+}
+
+void PacketCompressorTests()
+{
+    Random random( 4321 );
+    PacketCompressor sender;
+    PacketCompressor receiver;
+    sender.m_isEnabled = true;
+
+    constexpr size_t bodySize = 1000;
+    Byte body[bodySize];
+    size_t sentSize;
+    bool isCompressed;
+
+    // random bytes do not compress, they go out raw
+    for( Byte& byte : body )
+        byte = (Byte) random.IntInRange( 0, 255 );
+    bool isSame = CompressRoundTrip( sender, receiver, body, bodySize, sentSize, isCompressed );
+    PrintfTest( isSame && !isCompressed && sentSize == sizeof( PacketHeader ) + bodySize,
+                "PacketCompressor incompressible body goes out raw, %u bytes sent",
+                (uint) sentSize );
+
+    // runs and repeats, with a few bytes changed so it is not one long match
+    const char* pattern = "cube 12 pos 3.25 4.50 0.00 scale 1 1 1 color ff8800ff ";
+    size_t patternLength = strlen( pattern );
+    for( size_t byteIdx = 0; byteIdx < bodySize; ++byteIdx )
+        body[byteIdx] = (Byte) pattern[byteIdx % patternLength];
+    for( int changeIdx = 0; changeIdx < 20; ++changeIdx )
+        body[random.PositiveIntLessThan( (int) bodySize )] = random.Char();
+    isSame = CompressRoundTrip( sender, receiver, body, bodySize, sentSize, isCompressed );
+    PrintfTest( isSame && isCompressed && sentSize < sizeof( PacketHeader ) + bodySize / 2,
+                "PacketCompressor repetitive body round trip, %u bytes sent for %u",
+                (uint) sentSize, (uint) ( sizeof( PacketHeader ) + bodySize ) );
+
+    // small bodies alike in structure only gain from a dictionary trained on them
+    vector<vector<Byte>> samples;
+    for( int sampleIdx = 0; sampleIdx < 200; ++sampleIdx )
+    {
+        string text = Stringf( "snapshot %d baseline %d host time %d player %d input %d",
+                               random.IntInRange( 0, 65535 ), random.IntInRange( 0, 65535 ),
+                               random.IntInRange( 0, 1000000 ), random.IntInRange( 0, 64 ),
+                               random.IntInRange( 0, 65535 ) );
+        samples.emplace_back( text.begin(), text.end() );
+    }
+    vector<Byte> dictionary;
+    PacketCompressor::TrainDictionary( samples, COMPRESSION_DICTIONARY_MAX_SIZE, dictionary );
+
+    string text = Stringf( "snapshot %d baseline %d host time %d player %d input %d",
+                           40001, 39998, 123456, 7, 512 );
+    const Byte* smallBody = (const Byte*) text.data();
+    size_t sentWithoutDictionary;
+    CompressRoundTrip( sender, receiver, smallBody, text.size(),
+                       sentWithoutDictionary, isCompressed );
+
+    sender.SetDictionary( dictionary.data(), dictionary.size() );
+    receiver.SetDictionary( dictionary.data(), dictionary.size() );
+    isSame = CompressRoundTrip( sender, receiver, smallBody, text.size(), sentSize, isCompressed );
+    PrintfTest( isSame && isCompressed && sentSize < sentWithoutDictionary,
+                "PacketCompressor dictionary round trip, %u bytes sent, %u without it",
+                (uint) sentSize, (uint) sentWithoutDictionary );
+
+    // a receiver with another dictionary drops it
+    PacketCompressor otherReceiver;
+    bool isRead = CompressRoundTrip( sender, otherReceiver, smallBody, text.size(),
+                                     sentSize, isCompressed );
+    PrintfTest( !isRead, "PacketCompressor dictionary mismatch is dropped" );
+}
+
+void TimerWheelTests()
+{
+    Random random( 777 );
+    TimerWheel wheel;
+    wheel.Reset( 0.0 );
+    vector<TimerWheelEntry*> due;
+
+    // random times over a few seconds, advanced by uneven steps
+    constexpr uint entryCount = 500;
+    TimerWheelEntry entries[entryCount];
+    double dueTimes[entryCount];
+    for( uint entryIdx = 0; entryIdx < entryCount; ++entryIdx )
+    {
+        entries[entryIdx].m_type = entryIdx;
+        dueTimes[entryIdx] = (double) random.FloatInRange( 0.f, 5.f );
+        wheel.Schedule( entries[entryIdx], dueTimes[entryIdx] );
+    }
+    uint firedCount = 0;
+    uint earlyCount = 0;
+    for( double time = 0.0; time < 5.1; time += (double) random.FloatInRange( 0.0001f, 0.02f ) )
+    {
+        due.clear();
+        wheel.Advance( time, due );
+        for( TimerWheelEntry* entry : due )
+        {
+            ++firedCount;
+            if( time < dueTimes[entry->m_type] )
+                ++earlyCount;
+        }
+    }
+    PrintfTest( firedCount == entryCount && earlyCount == 0 && wheel.GetScheduledCount() == 0,
+                "TimerWheel never early test, %u of %u fired, %u early",
+                firedCount, entryCount, earlyCount );
+
+    // rescheduled from inside its own due batch, goes off again at the new time
+    wheel.Reset( 0.0 );
+    TimerWheelEntry repeating;
+    wheel.Schedule( repeating, 0.0105 );
+    double firstFireTime = -1.0;
+    double secondFireTime = -1.0;
+    for( int tick = 1; tick <= 40; ++tick )
+    {
+        double time = tick * TIMER_WHEEL_TICK;
+        due.clear();
+        wheel.Advance( time, due );
+        for( TimerWheelEntry* entry : due )
+        {
+            if( firstFireTime < 0.0 )
+            {
+                firstFireTime = time;
+                wheel.Schedule( *entry, time + 0.0125 );
+            }
+            else
+            {
+                secondFireTime = time;
+            }
+        }
+    }
+    PrintfTest( fabs( firstFireTime - 0.011 ) < 1e-9 && fabs( secondFireTime - 0.024 ) < 1e-9,
+                "TimerWheel reschedule from the due batch, fired at %f and %f, expected 0.011 and 0.024",
+                firstFireTime, secondFireTime );
+
+    // tick 100 and tick 4101 start out on levels 1 and 2 and have to cascade
+    // down to level 0 on time
+    const double cascadeTimes[] = { 0.0995, 4.1005 };
+    bool cascadesOnTime = true;
+    for( double dueTime : cascadeTimes )
+    {
+        wheel.Reset( 0.0 );
+        TimerWheelEntry cascading;
+        wheel.Schedule( cascading, dueTime );
+        double dueTick = ceil( dueTime / TIMER_WHEEL_TICK );
+        double fireTime = -1.0;
+        for( double tick = 1.0; tick <= dueTick + 1.0; tick += 1.0 )
+        {
+            due.clear();
+            wheel.Advance( tick * TIMER_WHEEL_TICK + TIMER_WHEEL_TICK * 0.5, due );
+            if( !due.empty() && fireTime < 0.0 )
+                fireTime = tick;
+        }
+        if( fireTime != dueTick )
+        {
+            PrintfTest( false, "TimerWheel cascade due at tick %.0f fired at tick %.0f",
+                        dueTick, fireTime );
+            cascadesOnTime = false;
+        }
+    }
+    PrintfTest( cascadesOnTime, "TimerWheel cascade to level 0 test" );
+
+    // past what the wheel covers, held at the end of its range
+    wheel.Reset( 0.0 );
+    TimerWheelEntry distant;
+    wheel.Schedule( distant, 100000.0 );
+    double rangeSeconds = (double) ( ( (uint64) 1 << ( TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVEL_COUNT ) ) - 1 )
+        * TIMER_WHEEL_TICK;
+    due.clear();
+    wheel.Advance( rangeSeconds - 0.5, due );
+    bool isEarly = !due.empty();
+    wheel.Advance( rangeSeconds + 0.5, due );
+    PrintfTest( !isEarly && due.size() == 1 && due[0] == &distant,
+                "TimerWheel entry past the range fires at its end, %.3f seconds", rangeSeconds );
+}
+
+void FragmentAssemblerTests()
+{
+    Random random( 2468 );
+    FragmentAssembler assembler;
+    NetMessage* message = nullptr;
+
+    // 4 fragments, the last one short, arriving out of order with a repeat
+    constexpr size_t messageSize = 3 * FRAGMENT_PAYLOAD_SIZE + 500;
+    Byte original[messageSize];
+    for( Byte& byte : original )
+        byte = random.Char();
+    const uint16 arrivalOrder[] = { 2, 0, 0, 3, 1 };
+    bool completedEarly = false;
+    bool addsSucceeded = true;
+    for( uint16 fragmentIdx : arrivalOrder )
+    {
+        if( message )
+            completedEarly = true;
+        size_t offset = fragmentIdx * FRAGMENT_PAYLOAD_SIZE;
+        size_t byteCount = Min( FRAGMENT_PAYLOAD_SIZE, messageSize - offset );
+        addsSucceeded = assembler.Add( 7, fragmentIdx, 4, original + offset, byteCount, message )
+            && addsSucceeded;
+    }
+    bool isSame = message && message->GetWrittenByteCount() == messageSize
+        && memcmp( message->GetBuffer(), original, messageSize ) == 0;
+    PrintfTest( addsSucceeded && !completedEarly && isSame && assembler.GetAssemblyCount() == 0,
+                "FragmentAssembler out of order with a duplicate reassembles test" );
+    delete message;
+    message = nullptr;
+
+    // bad fragments are refused
+    bool wrongSizeMiddle = assembler.Add( 8, 1, 3, original, 500, message );
+    bool zeroCount = assembler.Add( 9, 0, 0, original, FRAGMENT_PAYLOAD_SIZE, message );
+    uint16 oversizedCount = (uint16) FRAGMENT_MAX_COUNT;
+    bool oversized = assembler.Add( 10, oversizedCount - 1, oversizedCount,
+                                    original, FRAGMENT_PAYLOAD_SIZE, message );
+    bool tooMany = assembler.Add( 11, 0, oversizedCount + 1,
+                                  original, FRAGMENT_PAYLOAD_SIZE, message );
+    PrintfTest( !wrongSizeMiddle && !zeroCount && !oversized && !tooMany
+                && assembler.GetAssemblyCount() == 0,
+                "FragmentAssembler bad fragments are refused test" );
+
+    // a transfer past FRAGMENT_MAX_ASSEMBLIES is dropped, not failed, and
+    // there is room again once one completes
+    for( uint16 transferID = 0; transferID < FRAGMENT_MAX_ASSEMBLIES; ++transferID )
+        assembler.Add( 100 + transferID, 0, 2, original, FRAGMENT_PAYLOAD_SIZE, message );
+    uint16 extraID = 100 + (uint16) FRAGMENT_MAX_ASSEMBLIES;
+    bool extraAdded = assembler.Add( extraID, 0, 2, original, FRAGMENT_PAYLOAD_SIZE, message );
+    bool isFull = assembler.GetAssemblyCount() == FRAGMENT_MAX_ASSEMBLIES && message == nullptr;
+
+    assembler.Add( 100, 1, 2, original, 10, message );
+    bool completed = message != nullptr;
+    delete message;
+    message = nullptr;
+    assembler.Add( extraID, 0, 2, original, FRAGMENT_PAYLOAD_SIZE, message );
+    PrintfTest( extraAdded && isFull && completed
+                && assembler.GetAssemblyCount() == FRAGMENT_MAX_ASSEMBLIES,
+                "FragmentAssembler holds at most %u transfers test",
+                (uint) FRAGMENT_MAX_ASSEMBLIES );
+    assembler.Clear();
+}
+
+// true if the receiver's snapshot matches the host's within the quantization
+bool SnapshotsMatch( const WorldSnapshot& received, const WorldSnapshot& host )
+{
+    if( received.m_cubes.size() != host.m_cubes.size() )
+        return false;
+    for( size_t cubeIdx = 0; cubeIdx < host.m_cubes.size(); ++cubeIdx )
+    {
+        const CubeSnapshot& a = received.m_cubes[cubeIdx];
+        const CubeSnapshot& b = host.m_cubes[cubeIdx];
+        if( a.m_netID != b.m_netID
+            || ( a.m_position - b.m_position ).GetLength() > SNAPSHOT_POSITION_PRECISION
+            || ( a.m_scale - b.m_scale ).GetLength() > SNAPSHOT_SCALE_PRECISION
+            || !( a.m_color == b.m_color )
+            || ( a.m_velocity - b.m_velocity ).GetLength() > 0.05f )
+            return false;
+    }
+    return true;
+}
+
+// writes every chunk of the delta from baseline to snapshot the way
+// GameNetMessages does and feeds them to receiver, last chunk first
+// returns how many chunks it took, 0 if the snapshot did not complete
+size_t SendSnapshotThrough( SnapshotReceiver& receiver,
+                            const WorldSnapshot& snapshot,
+                            const WorldSnapshot* baseline,
+                            uint hostTimeMS,
+                            size_t* out_entryCount = nullptr )
+{
+    vector<SnapshotDeltaEntry> entries;
+    vector<size_t> chunkEnds;
+    snapshot.BuildDelta( baseline, entries );
+    if( out_entryCount )
+        *out_entryCount = entries.size();
+    if( !SplitDeltaIntoChunks( entries, chunkEnds ) )
+        return 0;
+
+    uint16 baselineID = baseline ? baseline->m_id : INVALID_SNAPSHOT_ID;
+    size_t chunkCount = chunkEnds.size();
+    bool isComplete = false;
+    for( size_t sentCount = 0; sentCount < chunkCount; ++sentCount )
+    {
+        size_t chunkIdx = chunkCount - 1 - sentCount;
+        size_t chunkStart = chunkIdx == 0 ? 0 : chunkEnds[chunkIdx - 1];
+        BytePacker bytes;
+        BitPacker writer( bytes );
+        for( size_t entryIdx = chunkStart; entryIdx < chunkEnds[chunkIdx]; ++entryIdx )
+            entries[entryIdx].Write( writer );
+        writer.FlushWrite();
+
+        BitPacker reader( bytes );
+        isComplete = receiver.ReadChunk(
+            snapshot.m_id, baselineID, hostTimeMS, false, (uint8) chunkIdx, (uint8) chunkCount,
+            (uint16) ( chunkEnds[chunkIdx] - chunkStart ), reader );
+        // only the last chunk in completes it
+        if( isComplete != ( sentCount + 1 == chunkCount ) )
+            return 0;
+    }
+    return isComplete ? chunkCount : 0;
+}
+
+void SnapshotTests()
+{
+    Random random( 1357 );
+    SnapshotReceiver receiver;
+
+    // enough cubes that a full snapshot takes a few chunks
+    vector<NetCube*> cubes;
+    for( int cubeIdx = 0; cubeIdx < 150; ++cubeIdx )
+    {
+        Vec3 position = random.Vec3InRange( Vec3( -50.f, -50.f, 0.f ), Vec3( 50.f, 50.f, 0.f ) );
+        NetCube* cube = new NetCube( position, Vec3::ZEROS, Vec3::ONES,
+                                     random.ColorWheel(), NetCube::GetNextFreeNetID() );
+        if( cubeIdx % 10 == 0 )
+            cube->m_velocity = Vec3( 0.6f, 0.8f, 0.f );
+        cubes.push_back( cube );
+    }
+
+    WorldSnapshot first;
+    first.Capture( 1 );
+    size_t chunkCount = SendSnapshotThrough( receiver, first, nullptr, 1000 );
+    const WorldSnapshot* received = receiver.GetLatest();
+    PrintfTest( chunkCount > 1 && received && received->m_id == 1 && SnapshotsMatch( *received, first ),
+                "Snapshot full snapshot in %u chunks round trip test", (uint) chunkCount );
+
+    // 5 moved, 1 recolored, 3 removed and 2 added
+    for( int cubeIdx = 0; cubeIdx < 5; ++cubeIdx )
+    {
+        Transform& t = cubes[cubeIdx * 7]->GetTransform();
+        t.SetLocalPosition( t.GetLocalPosition() + Vec3( 1.5f, -0.25f, 0.f ) );
+    }
+    cubes[3]->SetColor( Rgba( 10, 20, 30, 255 ) );
+    for( int removedCount = 0; removedCount < 3; ++removedCount )
+    {
+        delete cubes.back();
+        cubes.pop_back();
+    }
+    for( int addedCount = 0; addedCount < 2; ++addedCount )
+    {
+        cubes.push_back( new NetCube( Vec3( 1.f, 2.f, 0.f ), Vec3::ZEROS, Vec3( 2.f, 2.f, 2.f ),
+                                      Rgba::WHITE, NetCube::GetNextFreeNetID() ) );
+    }
+
+    WorldSnapshot second;
+    second.Capture( 2 );
+    size_t entryCount = 0;
+    chunkCount = SendSnapshotThrough( receiver, second, &first, 1050, &entryCount );
+    received = receiver.GetLatest();
+    PrintfTest( chunkCount == 1 && entryCount == 11 && received && received->m_id == 2
+                && SnapshotsMatch( *received, second ),
+                "Snapshot delta with added, removed and changed cubes, %u entries expected 11",
+                (uint) entryCount );
+
+    // a baseline the receiver never had is refused, the latest stays
+    WorldSnapshot missingBaseline;
+    missingBaseline.Capture( 50 );
+    cubes[0]->GetTransform().SetLocalPosition( Vec3( 9.f, 9.f, 0.f ) );
+    WorldSnapshot third;
+    third.Capture( 3 );
+    chunkCount = SendSnapshotThrough( receiver, third, &missingBaseline, 1100 );
+    received = receiver.GetLatest();
+    PrintfTest( chunkCount == 0 && received && received->m_id == 2,
+                "Snapshot chunk with a missing baseline is refused test" );
+
+    for( NetCube* cube : cubes )
+        delete cube;
+}
+
 void NetworkCourseTests()
 {
     // Endian
@@ -260,6 +795,12 @@ void NetworkCourseTests()
     free( someStr );
     free( outStr );
 
+    BitPackerTests();
+    PacketCompressorTests();
+    TimerWheelTests();
+    FragmentAssemblerTests();
+    SnapshotTests();
+
     // Process Spawning
 
     PrintfTest( true,